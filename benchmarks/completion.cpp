@@ -0,0 +1,92 @@
+// Builds a command tree with the given number of subcommands (default 3000), split into groups of 50, and reports the
+// time taken to build it and the average latency of completing flags, choice values and subcommand names, which should
+// stay well under a millisecond, both from the Cli and from its exported completion data.
+//
+// Usage: ArgonCompletionBenchmark [subcommands]
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+
+#include "argon/argon.hpp"
+
+namespace {
+    constexpr size_t groupSize = 50;
+
+    auto make_leaf(const size_t group, const size_t index) -> argon::Command<> {
+        argon::Command leaf{std::format("command-{:02}-{:02}", group, index), "generated command"};
+        for (size_t flag = 0; flag < 8; ++flag) {
+            [[maybe_unused]] const auto handle = leaf.add_flag(
+                argon::Flag<int>(std::format("--option-{}", flag)).with_alias(std::format("-{}", static_cast<char>('a' + flag))));
+        }
+        [[maybe_unused]] const auto handle = leaf.add_choice(
+            argon::Choice<int>("--level", {{"debug", 0}, {"info", 1}, {"warning", 2}, {"error", 3}}));
+        return leaf;
+    }
+
+    auto make_cli(const size_t subcommands) -> argon::Cli {
+        argon::Command root{"bench", "completion benchmark"};
+        for (size_t group = 0; group * groupSize < subcommands; ++group) {
+            argon::Command parent{std::format("group-{:02}", group), "generated group"};
+            for (size_t index = 0; index < groupSize && group * groupSize + index < subcommands; ++index) {
+                [[maybe_unused]] const auto handle = parent.add_subcommand(make_leaf(group, index));
+            }
+            [[maybe_unused]] const auto handle = root.add_subcommand(std::move(parent));
+        }
+        return argon::Cli{root};
+    }
+}
+
+int main(const int argc, const char *argv[]) {
+    const size_t subcommands = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000;
+    constexpr size_t iterations = 1000;
+
+    const auto setupStart = std::chrono::steady_clock::now();
+    argon::Cli cli = make_cli(subcommands);
+    const auto setup = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart);
+
+    const std::string group = std::format("group-{:02}", (subcommands - 1) / groupSize);
+    const std::string leaf = std::format("command-{:02}-{:02}",
+        (subcommands - 1) / groupSize, (subcommands - 1) % groupSize);
+    const std::vector<std::vector<std::string_view>> lines{
+        {"bench", "gr"},
+        {"bench", group, "command-"},
+        {"bench", group, leaf, "--opt"},
+        {"bench", group, leaf, "--level", "w"},
+    };
+
+    size_t candidates = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (const auto& line : lines) {
+            candidates += cli.complete(line, line.size() - 1).size();
+        }
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    const std::string json = cli.export_completion_data(argon::CompletionDataFormat::JsonLines);
+    const std::string binary = cli.export_completion_data(argon::CompletionDataFormat::Binary);
+    const auto loadStart = std::chrono::steady_clock::now();
+    const argon::CommandInfo tree = argon::read_completion_data(binary).value();
+    const auto load = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart);
+
+    const auto staticStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (const auto& line : lines) {
+            candidates += argon::complete_command_line(tree, line, line.size() - 1).size();
+        }
+    }
+    const auto staticElapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - staticStart);
+
+    std::cout << std::format("subcommands:       {}\n", subcommands);
+    std::cout << std::format("candidates:        {}\n", candidates);
+    std::cout << std::format("setup time:        {:.3f} ms\n", setup.count());
+    std::cout << std::format("average latency:   {:.3f} us\n",
+        elapsed.count() / static_cast<double>(iterations * lines.size()));
+    std::cout << std::format("JSON lines data:   {} KiB\n", json.size() / 1024);
+    std::cout << std::format("binary data:       {} KiB (loaded in {:.3f} ms)\n", binary.size() / 1024, load.count());
+    std::cout << std::format("static latency:    {:.3f} us\n",
+        staticElapsed.count() / static_cast<double>(iterations * lines.size()));
+    return 0;
+}
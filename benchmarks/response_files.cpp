@@ -0,0 +1,73 @@
+// Parses a generated response file of the given size (in MiB, default 1024) and reports the time taken and the peak
+// resident memory of the process, which should stay close to the size of the file.
+//
+// Usage: ArgonResponseFileBenchmark [size-in-mib]
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+#include <sys/resource.h>
+
+#include "argon/argon.hpp"
+
+namespace {
+    auto write_response_file(const std::filesystem::path& path, const size_t targetBytes) -> size_t {
+        std::ofstream stream(path, std::ios::binary);
+        size_t written = 0, count = 0;
+        while (written < targetBytes) {
+            const std::string line = std::format("some/directory/file_{:012}.txt\n", count++);
+            stream.write(line.data(), static_cast<std::streamsize>(line.size()));
+            written += line.size();
+        }
+        return count;
+    }
+
+    auto peak_rss_mib() -> double {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+    }
+}
+
+int main(const int argc, const char *argv[]) {
+    const size_t sizeMib = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    const auto path = std::filesystem::temp_directory_path() / "argon-response-file-benchmark.txt";
+    const size_t count = write_response_file(path, sizeMib * 1024 * 1024);
+    const double baselineMib = peak_rss_mib();
+
+    argon::Command cmd{"bench", "response file benchmark"};
+    const auto files = cmd.add_multi_positional(argon::MultiPositional<std::string_view>("files").with_streaming());
+    argon::Cli cli{cmd};
+    cli.enable_response_files();
+
+    const std::string responseArg = std::format("@{}", path.string());
+    const char *benchArgv[] = {"bench", responseArg.c_str()};
+
+    const auto start = std::chrono::steady_clock::now();
+    if (const auto run = cli.run(2, benchArgv); !run.has_value()) {
+        for (const auto& msg : run.error().messages) std::cerr << msg.message() << '\n';
+        return 1;
+    }
+    size_t bytes = 0;
+    for (const auto& file : cli.try_get_results(cli.get_root_handle())->stream(files)) {
+        bytes += file->size();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::cout << std::format("arguments:     {}\n", count);
+    std::cout << std::format("argument bytes: {}\n", bytes);
+    std::cout << std::format("file size:     {} MiB\n", sizeMib);
+    std::cout << std::format("parse time:    {:.3f} s\n", elapsed.count());
+    std::cout << std::format("peak RSS:      {:.1f} MiB (baseline {:.1f} MiB)\n", peak_rss_mib(), baselineMib);
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -2,23 +2,60 @@
 
 #include <atomic>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <climits>
 #include <concepts>
+#include <cstdio>
+#include <cstring>
 #include <cstdint>
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <format>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <ranges>
-#include <sstream>
+#include <shared_mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
-#include <variant>
+#include <unordered_set>
 #include <vector>
 #include <queue>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define ARGON_HAS_MMAP 1
+#define ARGON_HAS_DLOPEN 1
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+#include <io.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__APPLE__)
+#include <crt_externs.h>
+#elif defined(__unix__)
+extern char **environ;
+#endif
+
 #include "argon.hpp"
 
 namespace argon::detail {
@@ -234,6 +271,7 @@ namespace argon::detail {
     template<> struct TypeDisplayName<bool>        { constexpr static std::string_view value = "boolean"; };
     template<> struct TypeDisplayName<char>        { constexpr static std::string_view value = "character"; };
     template<> struct TypeDisplayName<std::string> { constexpr static std::string_view value = "string"; };
+    template<> struct TypeDisplayName<std::string_view> { constexpr static std::string_view value = "string"; };
     template<> struct TypeDisplayName<std::filesystem::path> { constexpr static std::string_view value = "filepath"; };
 
     template <typename T>
@@ -244,7 +282,7 @@ namespace argon::detail {
         ConversionFn<T> m_conversionFn = nullptr;
         std::string m_conversionErrorMsg;
 
-        auto get_error_msg() -> std::string {
+        auto get_error_msg() const -> std::string {
             if (!m_conversionErrorMsg.empty()) {
                 return m_conversionErrorMsg;
             }
@@ -255,7 +293,7 @@ namespace argon::detail {
         }
 
     protected:
-        auto convert(std::string_view value) -> std::expected<T, std::string> {
+        auto convert(std::string_view value) const -> std::expected<T, std::string> {
             std::optional<T> result;
             // Use custom conversion function for this specific option if supplied
             if (this->m_conversionFn != nullptr) {
@@ -283,6 +321,10 @@ namespace argon::detail {
                 std::is_same_v<T, std::filesystem::path>) {
                 result = value;
             }
+            // Borrow the input, which outlives the parsed results
+            else if constexpr (std::is_same_v<T, std::string_view>) {
+                result = value;
+            }
             // Should never reach this
             else {
                 throw std::logic_error("Custom conversion function must be provided for unsupported type");
@@ -311,12 +353,21 @@ namespace argon::detail {
     template <typename Derived, typename T>
     class SingleValueStorage {
     protected:
-        std::optional<T> m_valueStorage;
+        // Mutable so that deferred conversions can be memoized when the value is first accessed
+        mutable std::optional<T> m_valueStorage;
         std::optional<T> m_defaultValue;
     public:
         auto get_value() const -> std::optional<T> { return m_valueStorage; }
         auto get_default_value() const -> std::optional<T> { return m_defaultValue; }
 
+    protected:
+        [[nodiscard]] auto single_value_span() const -> std::span<const T> {
+            if (!m_valueStorage.has_value()) return {};
+            return std::span<const T>(&m_valueStorage.value(), 1);
+        }
+
+    public:
+
         auto with_default(T defaultValue) & -> Derived& {
             m_defaultValue = defaultValue;
             return static_cast<Derived&>(*this);
@@ -331,7 +382,8 @@ namespace argon::detail {
     template <typename Derived, typename T>
     class VectorValueStorage {
     protected:
-        std::vector<T> m_valueStorage;
+        // Mutable so that deferred conversions can be memoized when the values are first accessed
+        mutable std::vector<T> m_valueStorage;
         std::optional<std::vector<T>> m_defaultValue;
     public:
         auto get_value() const -> std::vector<T> { return m_valueStorage; }
@@ -435,7 +487,7 @@ namespace argon::detail {
     protected:
         std::vector<ValueValidator<T>> m_validators;
 
-        auto apply_value_validator(const T& value) -> std::expected<void, std::string> {
+        auto apply_value_validator(const T& value) const -> std::expected<void, std::string> {
             for (const auto& validator : m_validators) {
                 if (!validator.function(value)) {
                     return std::unexpected(validator.errorMsg);
@@ -461,7 +513,11 @@ namespace argon::detail {
     protected:
         std::vector<GroupValidator<T>> m_validators;
 
-        auto apply_group_validator(const std::vector<T>& value) -> std::expected<void, std::string> {
+        [[nodiscard]] auto has_group_validators() const -> bool {
+            return !m_validators.empty();
+        }
+
+        auto apply_group_validator(const std::vector<T>& value) const -> std::expected<void, std::string> {
             for (const auto& validator : m_validators) {
                 if (!validator.function(value)) {
                     return std::unexpected(validator.errorMsg);
@@ -484,13 +540,350 @@ namespace argon::detail {
 } // namespace argon::detail
 
 
+namespace argon::detail {
+    // Inline copy of at most Capacity characters, so that errors never allocate for text taken from the command line
+    template <size_t Capacity>
+    class BoundedString {
+        std::array<char, Capacity> m_data{};
+        size_t m_size = 0;
+        bool m_truncated = false;
+
+    public:
+        BoundedString() = default;
+
+        explicit BoundedString(const std::string_view str)
+            : m_size(std::min(str.size(), Capacity)), m_truncated(str.size() > Capacity) {
+            std::ranges::copy(str.substr(0, m_size), m_data.begin());
+        }
+
+        [[nodiscard]] auto view() const -> std::string_view { return {m_data.data(), m_size}; }
+        [[nodiscard]] auto is_truncated() const -> bool { return m_truncated; }
+    };
+
+    // Levenshtein distances from one misspelled name to many candidates, computed with Myers' bit-parallel algorithm:
+    // the column of the distance matrix for each candidate character is updated with a few word operations, so each
+    // candidate costs O(length) instead of O(length * pattern length). Distances above maxDistance are not reported.
+    class EditDistanceMatcher {
+        std::string_view m_pattern;
+        size_t m_maxDistance;
+        std::array<uint64_t, 256> m_peq{};
+
+        // Plain dynamic programming, for patterns that do not fit in a word
+        [[nodiscard]] auto long_distance(const std::string_view text) const -> size_t {
+            std::vector<size_t> row(m_pattern.size() + 1);
+            std::iota(row.begin(), row.end(), size_t{0});
+            for (size_t j = 1; j <= text.size(); j++) {
+                size_t diagonal = std::exchange(row[0], j);
+                for (size_t i = 1; i <= m_pattern.size(); i++) {
+                    const size_t substitution = diagonal + (m_pattern[i - 1] != text[j - 1]);
+                    diagonal = std::exchange(row[i], std::min({row[i] + 1, row[i - 1] + 1, substitution}));
+                }
+            }
+            return row.back();
+        }
+
+    public:
+        EditDistanceMatcher(const std::string_view pattern, const size_t maxDistance)
+            : m_pattern(pattern), m_maxDistance(maxDistance) {
+            if (pattern.size() > 64) return;
+            for (size_t i = 0; i < pattern.size(); i++) {
+                m_peq[static_cast<unsigned char>(pattern[i])] |= uint64_t{1} << i;
+            }
+        }
+
+        [[nodiscard]] auto distance(const std::string_view text) const -> std::optional<size_t> {
+            const size_t m = m_pattern.size();
+            const size_t lengthDifference = m > text.size() ? m - text.size() : text.size() - m;
+            if (lengthDifference > m_maxDistance) return std::nullopt;
+            if (m == 0) return text.size();
+            if (m > 64) {
+                const size_t result = long_distance(text);
+                return result <= m_maxDistance ? std::optional(result) : std::nullopt;
+            }
+
+            const uint64_t last = uint64_t{1} << (m - 1);
+            uint64_t pv = ~uint64_t{0};
+            uint64_t mv = 0;
+            size_t score = m;
+            for (size_t j = 0; j < text.size(); j++) {
+                const uint64_t eq = m_peq[static_cast<unsigned char>(text[j])];
+                const uint64_t xv = eq | mv;
+                const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                uint64_t ph = mv | ~(xh | pv);
+                uint64_t mh = pv & xh;
+                if (ph & last) score++;
+                else if (mh & last) score--;
+                // The first row of the matrix grows by one per character, so a horizontal +1 enters at the top
+                ph = (ph << 1) | 1;
+                mh <<= 1;
+                pv = mh | ~(xv | ph);
+                mv = ph & xv;
+                // Each remaining character lowers the score by at most one
+                if (score > m_maxDistance + (text.size() - j - 1)) return std::nullopt;
+            }
+            return score <= m_maxDistance ? std::optional(score) : std::nullopt;
+        }
+    };
+
+    // Up to maxSuggestions candidates closest to name, nearest first. Names are suggested within a third of the length
+    // of name, rounded up, so that short names only match close typos.
+    template <std::ranges::input_range Range>
+    [[nodiscard]] auto find_suggestions(const std::string_view name, Range&& candidates, const size_t maxSuggestions = 3)
+        -> std::vector<std::string_view> {
+        const EditDistanceMatcher matcher{name, (name.size() + 2) / 3};
+        std::vector<std::pair<size_t, std::string_view>> matches;
+        for (const std::string_view candidate : candidates) {
+            if (const auto distance = matcher.distance(candidate)) matches.emplace_back(distance.value(), candidate);
+        }
+        std::ranges::sort(matches);
+        const auto [first, last] = std::ranges::unique(matches, {}, [](const auto& match) { return match.second; });
+        matches.erase(first, last);
+        if (matches.size() > maxSuggestions) matches.resize(maxSuggestions);
+        return matches | std::views::values | std::ranges::to<std::vector>();
+    }
+
+    // Lists names as "'a', 'b' or 'c'"
+    [[nodiscard]] inline auto quote_names(const std::vector<std::string_view>& names) -> std::string {
+        std::string message;
+        for (size_t i = 0; i < names.size(); i++) {
+            const std::string_view separator = i == 0 ? "" : i + 1 == names.size() ? " or " : ", ";
+            std::format_to(std::back_inserter(message), "{}'{}'", separator, names[i]);
+        }
+        return message;
+    }
+} // namespace argon::detail
+
+
+namespace argon {
+    enum class ErrorCode {
+        UnknownFlag,
+        AmbiguousFlag,
+        MissingValue,
+        InvalidValue,
+        InvalidChoice,
+        InvalidValues,
+        TooManyPositionals,
+        UnknownSubcommand,
+        AmbiguousSubcommand,
+        SubcommandUnavailable,
+        ConstraintViolation,
+        Source,
+    };
+
+    // A failure to parse a command line. The option name and offending value are bounded copies of the input, longer
+    // ones are truncated, and the message is only formatted when it is requested. The reason holds the text that is
+    // not taken from the command line: a validator message, the candidates of an ambiguous name, or the whole message
+    // of errors that have no name or value. Unknown names and invalid choices keep the shared list of names they are
+    // checked against instead, and the suggestions or the list of valid values are only built with the message.
+    class Error {
+    public:
+        constexpr static size_t maxNameSize = 64;
+        constexpr static size_t maxValueSize = 128;
+
+    private:
+        ErrorCode m_code;
+        std::optional<size_t> m_position;
+        detail::BoundedString<maxNameSize> m_name;
+        detail::BoundedString<maxValueSize> m_value;
+        std::string m_reason;
+        std::string m_note;
+        std::shared_ptr<const std::vector<std::string>> m_candidates;
+
+        template <size_t Capacity>
+        [[nodiscard]] static auto ellipsis(const detail::BoundedString<Capacity>& str) -> std::string_view {
+            return str.is_truncated() ? "..." : "";
+        }
+
+        // Positionals are named without a leading dash, and are not called flags in messages
+        template <typename Out>
+        auto format_option_to(Out out) const -> Out {
+            const std::string_view kind = m_name.view().starts_with('-') ? "flag " : "";
+            return std::format_to(out, "{}'{}{}'", kind, m_name.view(), ellipsis(m_name));
+        }
+
+        // Valid choices are all listed, unknown names list the candidates that are closest to them
+        template <typename Out>
+        auto format_reason_to(Out out) const -> Out {
+            if (m_candidates == nullptr) return std::ranges::copy(m_reason, out).out;
+            if (m_code == ErrorCode::InvalidChoice) {
+                for (size_t i = 0; i < m_candidates->size(); i++) {
+                    if (i != 0) out = std::ranges::copy(std::string_view(" | "), out).out;
+                    out = std::ranges::copy((*m_candidates)[i], out).out;
+                }
+                return out;
+            }
+            return std::ranges::copy(detail::quote_names(detail::find_suggestions(m_name.view(), *m_candidates)), out).out;
+        }
+
+    public:
+        explicit Error(const ErrorCode code, std::string reason = {}) : m_code(code), m_reason(std::move(reason)) {}
+
+        auto with_option(const std::string_view name) & -> Error& {
+            m_name = detail::BoundedString<maxNameSize>(name);
+            return *this;
+        }
+
+        auto with_option(const std::string_view name) && -> Error&& {
+            m_name = detail::BoundedString<maxNameSize>(name);
+            return std::move(*this);
+        }
+
+        auto with_value(const std::string_view value) & -> Error& {
+            m_value = detail::BoundedString<maxValueSize>(value);
+            return *this;
+        }
+
+        auto with_value(const std::string_view value) && -> Error&& {
+            m_value = detail::BoundedString<maxValueSize>(value);
+            return std::move(*this);
+        }
+
+        auto with_position(const std::optional<size_t> position) & -> Error& {
+            m_position = position;
+            return *this;
+        }
+
+        auto with_position(const std::optional<size_t> position) && -> Error&& {
+            m_position = position;
+            return std::move(*this);
+        }
+
+        // Where a value that was not on the command line came from, such as an environment variable
+        auto with_note(std::string note) & -> Error& {
+            m_note = std::move(note);
+            return *this;
+        }
+
+        auto with_note(std::string note) && -> Error&& {
+            m_note = std::move(note);
+            return std::move(*this);
+        }
+
+        // The names an unknown name or invalid choice was checked against, which the reason is built from
+        auto with_candidates(std::shared_ptr<const std::vector<std::string>> candidates) & -> Error& {
+            m_candidates = std::move(candidates);
+            return *this;
+        }
+
+        auto with_candidates(std::shared_ptr<const std::vector<std::string>> candidates) && -> Error&& {
+            m_candidates = std::move(candidates);
+            return std::move(*this);
+        }
+
+        [[nodiscard]] auto code() const -> ErrorCode { return m_code; }
+        // Index in argv of the offending token, if it came from the command line
+        [[nodiscard]] auto position() const -> std::optional<size_t> { return m_position; }
+        [[nodiscard]] auto option() const -> std::string_view { return m_name.view(); }
+        [[nodiscard]] auto value() const -> std::string_view { return m_value.view(); }
+        [[nodiscard]] auto is_value_truncated() const -> bool { return m_value.is_truncated(); }
+        [[nodiscard]] auto reason() const -> std::string {
+            std::string reason;
+            format_reason_to(std::back_inserter(reason));
+            return reason;
+        }
+        [[nodiscard]] auto note() const -> const std::string& { return m_note; }
+
+        template <typename Out>
+        auto format_to(Out out) const -> Out {
+            const std::string_view value = m_value.view();
+            switch (m_code) {
+                case ErrorCode::UnknownFlag:
+                    out = std::format_to(out, "Unknown flag '{}{}'", m_name.view(), ellipsis(m_name));
+                    if (m_position.has_value()) out = std::format_to(out, " at position {}", m_position.value());
+                    if (const std::string suggestions = reason(); !suggestions.empty()) {
+                        out = std::format_to(out, ". Did you mean {}?", suggestions);
+                    }
+                    break;
+                case ErrorCode::AmbiguousFlag:
+                    out = std::format_to(out, "Ambiguous flag '{}{}'", m_name.view(), ellipsis(m_name));
+                    if (m_position.has_value()) out = std::format_to(out, " at position {}", m_position.value());
+                    out = std::format_to(out, " could be {}", m_reason);
+                    break;
+                case ErrorCode::MissingValue:
+                    out = std::format_to(out, "Flag '{}{}' does not have an implicit value and no value was given",
+                        m_name.view(), ellipsis(m_name));
+                    break;
+                case ErrorCode::InvalidValue:
+                    out = std::format_to(out, "Invalid value '{}{}' for ", value, ellipsis(m_value));
+                    out = format_option_to(out);
+                    out = std::format_to(out, ": {}", m_reason);
+                    break;
+                case ErrorCode::InvalidChoice:
+                    out = std::format_to(out, "Invalid value '{}{}' for ", value, ellipsis(m_value));
+                    out = format_option_to(out);
+                    out = format_reason_to(std::ranges::copy(std::string_view(". Valid values are: "), out).out);
+                    break;
+                case ErrorCode::InvalidValues:
+                    out = std::format_to(out, "Invalid values for ");
+                    out = format_option_to(out);
+                    out = std::format_to(out, ": {}", m_reason);
+                    break;
+                case ErrorCode::TooManyPositionals:
+                    out = std::format_to(out, "Unexpected token '{}{}' found at position {}, too many positional "
+                        "arguments specified", value, ellipsis(m_value), m_position.value_or(0));
+                    break;
+                case ErrorCode::UnknownSubcommand:
+                    out = std::format_to(out, "Unknown subcommand '{}{}'", m_name.view(), ellipsis(m_name));
+                    if (const std::string suggestions = reason(); !suggestions.empty()) {
+                        out = std::format_to(out, ". Did you mean {}?", suggestions);
+                    }
+                    break;
+                case ErrorCode::AmbiguousSubcommand:
+                    out = std::format_to(out, "Ambiguous subcommand '{}{}' could be {}",
+                        m_name.view(), ellipsis(m_name), m_reason);
+                    break;
+                case ErrorCode::SubcommandUnavailable:
+                case ErrorCode::ConstraintViolation:
+                case ErrorCode::Source:
+                    out = std::ranges::copy(m_reason, out).out;
+                    break;
+            }
+            if (!m_note.empty()) out = std::format_to(out, " ({})", m_note);
+            return out;
+        }
+
+        [[nodiscard]] auto message() const -> std::string {
+            std::string message;
+            format_to(std::back_inserter(message));
+            return message;
+        }
+
+        // Lets code written against string messages keep using them
+        // ReSharper disable once CppNonExplicitConversionOperator
+        operator std::string() const { return message(); }
+
+    };
+
+    // Thrown by Results::get when a lazily converted value fails to convert or validate. When a constraint reads the
+    // value during a run, its errors are reported by the run instead.
+    class ConversionError : public std::runtime_error {
+        std::vector<Error> m_errors;
+
+        [[nodiscard]] static auto join(const std::vector<Error>& errors) -> std::string {
+            std::string joined;
+            for (const auto& error : errors) {
+                if (!joined.empty()) joined += '\n';
+                error.format_to(std::back_inserter(joined));
+            }
+            return joined;
+        }
+
+    public:
+        explicit ConversionError(std::vector<Error> errors)
+            : std::runtime_error(join(errors)), m_errors(std::move(errors)) {}
+
+        [[nodiscard]] auto errors() const -> const std::vector<Error>& { return m_errors; }
+    };
+} // namespace argon
+
+
 namespace argon::detail {
     template <typename T>
     [[nodiscard]] static auto get_default_input_hint() -> std::string {
         if constexpr (detail::is_integral_v<T> || std::is_floating_point_v<T>) return "num";
         else if constexpr (std::is_same_v<T, bool>) return "bool";
         else if constexpr (std::is_same_v<T, char>) return "char";
-        else if constexpr (std::is_same_v<T, std::string>) return "string";
+        else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) return "string";
         else if constexpr (std::is_same_v<T, std::filesystem::path>) return "path";
         else return "value";
     }
@@ -528,572 +921,868 @@ namespace argon::detail {
             return static_cast<Derived&&>(*this);
         }
     };
-} // namespace argon::detail
-
-
-namespace argon::detail {
-    class FlagBase {
-        friend class AstAnalyzer;
 
+    template <typename Derived>
+    class ParallelConversionMixin {
     protected:
-        std::string m_flag;
-        std::vector<std::string> m_aliases;
+        std::optional<size_t> m_parallelThreshold;
+        size_t m_maxThreads = 0;
 
-        [[nodiscard]] virtual auto set_value(std::optional<const std::string_view> str) -> std::expected<void, std::string> = 0;
-    public:
-        FlagBase() = default;
-        explicit FlagBase(const std::string_view flag) {
-            validate_flag(flag);
-            m_flag = flag;
+        [[nodiscard]] auto get_num_threads(const size_t numValues) const -> size_t {
+            if (!m_parallelThreshold.has_value() || numValues < m_parallelThreshold.value()) return 1;
+            const size_t maxThreads = m_maxThreads != 0 ? m_maxThreads : std::max(1u, std::thread::hardware_concurrency());
+            return std::min(maxThreads, numValues);
         }
-        virtual ~FlagBase() = default;
 
-        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
-        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
+    public:
+        auto with_parallel_conversion(const size_t threshold = 10'000, const size_t maxThreads = 0) & -> Derived& {
+            m_parallelThreshold = threshold;
+            m_maxThreads = maxThreads;
+            return static_cast<Derived&>(*this);
+        }
 
-        [[nodiscard]] virtual auto is_set() const -> bool = 0;
-        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
-        [[nodiscard]] virtual auto get_input_hint() const -> const std::string& = 0;
-        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+        auto with_parallel_conversion(const size_t threshold = 10'000, const size_t maxThreads = 0) && -> Derived&& {
+            m_parallelThreshold = threshold;
+            m_maxThreads = maxThreads;
+            return static_cast<Derived&&>(*this);
+        }
     };
 
-    class MultiFlagBase {
-        friend class AstAnalyzer;
+    // Calls convertOne with the index of every value, splitting the values into numThreads contiguous chunks that are
+    // processed concurrently. Each chunk collects its own values and errors, which are then appended in chunk order so
+    // that the output is identical to a serial pass. Conversion stops once errors holds maxErrors errors; a chunk
+    // stops after maxErrors of its own, so the first maxErrors errors are still those of a serial pass.
+    template <typename T, typename Range, typename ConvertOne>
+    auto convert_values(
+        const Range& values,
+        const size_t numThreads,
+        std::vector<T>& out,
+        std::vector<Error>& errors,
+        const size_t maxErrors,
+        const ConvertOne& convertOne
+    ) -> void {
+        const size_t numValues = std::ranges::size(values);
+        if (numThreads <= 1 || numValues == 0) {
+            for (size_t i = 0; i < numValues && errors.size() < maxErrors; i++) {
+                convertOne(i, std::string_view(values[i]), out, errors);
+            }
+            return;
+        }
+
+        struct Chunk {
+            std::vector<T> values;
+            std::vector<Error> errors;
+            std::exception_ptr exception;
+        };
+        const size_t chunkSize = (numValues + numThreads - 1) / numThreads;
+        // Rounding the chunk size up can leave fewer chunks than threads, and none may start past the last value
+        const size_t numChunks = (numValues + chunkSize - 1) / chunkSize;
+        std::vector<Chunk> chunks(numChunks);
+
+        const auto processChunk = [&](const size_t chunkIndex) {
+            Chunk& chunk = chunks[chunkIndex];
+            const size_t begin = chunkIndex * chunkSize;
+            const size_t end = std::min(begin + chunkSize, numValues);
+            try {
+                chunk.values.reserve(end - begin);
+                for (size_t i = begin; i < end && chunk.errors.size() < maxErrors; i++) {
+                    convertOne(i, std::string_view(values[i]), chunk.values, chunk.errors);
+                }
+            } catch (...) {
+                chunk.exception = std::current_exception();
+            }
+        };
 
-    protected:
-        std::string m_flag;
-        std::vector<std::string> m_aliases;
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(numChunks - 1);
+            for (size_t i = 1; i < numChunks; i++) {
+                workers.emplace_back(processChunk, i);
+            }
+            processChunk(0);
+        }
 
-        [[nodiscard]] virtual auto set_value(std::span<const std::string_view> values)
-            -> std::expected<void, std::vector<std::string>> = 0;
-    public:
-        MultiFlagBase() = default;
-        explicit MultiFlagBase(const std::string_view flag) {
-            validate_flag(flag);
-            m_flag = flag;
-        };
-        virtual ~MultiFlagBase() = default;
+        out.reserve(out.size() + numValues);
+        for (auto& chunk : chunks) {
+            if (chunk.exception) std::rethrow_exception(chunk.exception);
+            std::ranges::move(chunk.values, std::back_inserter(out));
+            const size_t numErrors = std::min(chunk.errors.size(), maxErrors - std::min(maxErrors, errors.size()));
+            std::ranges::move(chunk.errors | std::views::take(numErrors), std::back_inserter(errors));
+        }
+    }
+} // namespace argon::detail
 
-        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
-        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
 
-        [[nodiscard]] virtual auto is_set() const -> bool = 0;
-        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
-        [[nodiscard]] virtual auto get_input_hint() const -> const std::string& = 0;
-        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+namespace argon {
+    // Range of underlying values scanned when reflecting enumerators of E. Specialize for enums whose
+    // enumerators lie outside of the default range.
+    template <typename E> requires std::is_scoped_enum_v<E>
+    struct EnumRange {
+        constexpr static int min = -128;
+        constexpr static int max = 127;
     };
+} // namespace argon
 
-    class PositionalBase {
-        friend class AstAnalyzer;
 
-    protected:
-        std::string m_name;
+namespace argon::detail {
+    template <typename E, E Value>
+    constexpr auto enum_value_signature_name() -> std::string_view {
+#if defined(__clang__) || defined(__GNUC__)
+        // GCC:   "... [with E = Mode; E Value = Mode::Fast]"
+        // Clang: "... [E = Mode, Value = Mode::Fast]"
+        constexpr std::string_view signature = __PRETTY_FUNCTION__;
+        constexpr std::string_view marker = "Value = ";
+        const size_t markerPos = signature.rfind(marker);
+        if (markerPos == std::string_view::npos) return {};
+        const size_t begin = markerPos + marker.size();
+        return signature.substr(begin, signature.find_first_of(";]", begin) - begin);
+#elif defined(_MSC_VER)
+        // MSVC:  "... enum_value_signature_name<enum Mode,Mode::Fast>(void)"
+        constexpr std::string_view signature = __FUNCSIG__;
+        const size_t end = signature.rfind(">(void)");
+        if (end == std::string_view::npos) return {};
+        const size_t begin = signature.rfind(',', end) + 1;
+        return signature.substr(begin, end - begin);
+#else
+        return {};
+#endif
+    }
 
-        [[nodiscard]] virtual auto set_value(std::optional<const std::string_view> str) -> std::expected<void, std::string> = 0;
-    public:
-        explicit PositionalBase(const std::string_view name) {
-            if (name.empty()) {
-                throw std::invalid_argument("Positional name must not be empty");
-            }
-            m_name = name;
-        }
-        virtual ~PositionalBase() = default;
+    template <typename E, E Value>
+    constexpr auto enum_value_name() -> std::string_view {
+        const std::string_view name = enum_value_signature_name<E, Value>();
+        // Values that are not enumerators are printed as casts, e.g. "(Mode)5"
+        if (name.empty()) return {};
+        if (const char c = name[0]; !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')) return {};
 
-        [[nodiscard]] auto get_name() const -> const std::string& { return m_name; }
-        [[nodiscard]] virtual auto is_set() const -> bool = 0;
-        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
-    };
+        const size_t scope = name.rfind(':');
+        return scope == std::string_view::npos ? name : name.substr(scope + 1);
+    }
 
-    class MultiPositionalBase {
-        friend class AstAnalyzer;
+    template <typename E> requires std::is_scoped_enum_v<E>
+    class EnumReflection {
+        using Underlying = std::underlying_type_t<E>;
+        using Entry = std::pair<std::string_view, E>;
 
-    protected:
-        std::string m_name;
+        constexpr static int64_t min = std::max<int64_t>(EnumRange<E>::min, std::numeric_limits<Underlying>::min());
+        constexpr static int64_t max = std::min<int64_t>(EnumRange<E>::max, std::numeric_limits<Underlying>::max());
+        static_assert(min <= max, "EnumRange<E>::min must not be greater than EnumRange<E>::max");
+        constexpr static size_t rangeSize = static_cast<size_t>(max - min + 1);
+
+        template <size_t... Is>
+        constexpr static auto reflect_range(std::index_sequence<Is...>) -> std::array<std::string_view, rangeSize> {
+            return { enum_value_name<E, static_cast<E>(min + static_cast<int64_t>(Is))>()... };
+        }
+
+        // Name of every value in [min, max], empty if the value is not an enumerator
+        constexpr static std::array<std::string_view, rangeSize> names = reflect_range(std::make_index_sequence<rangeSize>{});
+        constexpr static size_t count = std::ranges::count_if(names, [](const std::string_view name) { return !name.empty(); });
+        static_assert(count > 0, "Unable to reflect any enumerators, specialize argon::EnumRange to cover their values");
 
-        [[nodiscard]] virtual auto set_value(std::span<const std::string_view> values)
-            -> std::expected<void, std::vector<std::string>> = 0;
     public:
-        explicit MultiPositionalBase(const std::string_view name) {
-            if (name.empty()) {
-                throw std::invalid_argument("Multi-positional name must not be empty");
+        // Enumerators in declaration (value) order
+        constexpr static std::array<Entry, count> entries = [] {
+            std::array<Entry, count> result{};
+            size_t j = 0;
+            for (size_t i = 0; i < rangeSize; i++) {
+                if (!names[i].empty()) {
+                    result[j++] = Entry{names[i], static_cast<E>(min + static_cast<int64_t>(i))};
+                }
             }
-            m_name = name;
+            return result;
+        }();
+
+        // Enumerators sorted by name for binary search
+        constexpr static std::array<Entry, count> entriesByName = [] {
+            std::array<Entry, count> result = entries;
+            std::ranges::sort(result, {}, &Entry::first);
+            return result;
+        }();
+
+        [[nodiscard]] constexpr static auto from_name(const std::string_view name) -> std::optional<E> {
+            const auto it = std::ranges::lower_bound(entriesByName, name, {}, &Entry::first);
+            if (it == entriesByName.end() || it->first != name) return std::nullopt;
+            return it->second;
         }
-        virtual ~MultiPositionalBase() = default;
 
-        [[nodiscard]] auto get_name() const -> const std::string& { return m_name; }
-        [[nodiscard]] virtual auto is_set() const -> bool = 0;
-        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+        [[nodiscard]] constexpr static auto to_name(const E value) -> std::string_view {
+            const auto underlying = static_cast<int64_t>(static_cast<Underlying>(value));
+            if (underlying < min || underlying > max) return {};
+            return names[static_cast<size_t>(underlying - min)];
+        }
     };
 
-    class ChoiceBase {
-        friend class AstAnalyzer;
-
-    protected:
-        std::string m_flag;
-        std::vector<std::string> m_aliases;
+    template <typename T>
+    class ChoiceMap {
+        std::vector<std::pair<std::string, T>> m_choices;
+        bool m_reflected = false;
+        // Shared with the errors of invalid values, which list every name
+        std::shared_ptr<const std::vector<std::string>> m_names;
 
-        [[nodiscard]] virtual auto set_value(std::optional<const std::string_view> str) -> std::expected<void, std::string> = 0;
     public:
-        ChoiceBase() = default;
-        explicit ChoiceBase(const std::string_view flag) {
-            validate_flag(flag);
-            m_flag = flag;
+        explicit ChoiceMap(std::vector<std::pair<std::string, T>> choices)
+            : m_choices(std::move(choices)),
+              m_names(std::make_shared<const std::vector<std::string>>(
+                  m_choices | std::views::keys | std::ranges::to<std::vector>())) {}
+
+        [[nodiscard]] static auto from_enum() -> ChoiceMap requires std::is_scoped_enum_v<T> {
+            ChoiceMap map{{}};
+            map.m_reflected = true;
+            map.m_names = std::make_shared<const std::vector<std::string>>(EnumReflection<T>::entries
+                | std::views::keys
+                | std::views::transform([](const std::string_view name) { return std::string(name); })
+                | std::ranges::to<std::vector>());
+            return map;
         }
-        virtual ~ChoiceBase() = default;
-
-        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
-        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
-
-        [[nodiscard]] virtual auto is_set() const -> bool = 0;
-        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
-        [[nodiscard]] virtual auto get_choices() const -> std::vector<std::string> = 0;
-        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
-    };
 
-    class MultiChoiceBase {
-        friend class AstAnalyzer;
+        [[nodiscard]] auto empty() const -> bool {
+            return !m_reflected && m_choices.empty();
+        }
 
-    protected:
-        std::string m_flag;
-        std::vector<std::string> m_aliases;
+        [[nodiscard]] auto find(const std::string_view name) const -> std::optional<T> {
+            if constexpr (std::is_scoped_enum_v<T>) {
+                if (m_reflected) return EnumReflection<T>::from_name(name);
+            }
+            const auto it = std::ranges::find_if(m_choices, [&name](const auto& choice) -> bool {
+                return choice.first == name;
+            });
+            if (it == m_choices.end()) return std::nullopt;
+            return it->second;
+        }
 
-        [[nodiscard]] virtual auto set_value(std::span<const std::string_view> values)
-            -> std::expected<void, std::vector<std::string>> = 0;
-    public:
-        MultiChoiceBase() = default;
-        explicit MultiChoiceBase(const std::string_view flag) {
-            validate_flag(flag);
-            m_flag = flag;
-        };
-        virtual ~MultiChoiceBase() = default;
+        [[nodiscard]] auto contains(const T& value) const -> bool requires std::equality_comparable<T> {
+            if constexpr (std::is_scoped_enum_v<T>) {
+                if (m_reflected) return !EnumReflection<T>::to_name(value).empty();
+            }
+            return std::ranges::contains(m_choices | std::views::values, value);
+        }
 
-        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
-        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
+        [[nodiscard]] auto get_names() const -> std::vector<std::string> {
+            return *m_names;
+        }
 
-        [[nodiscard]] virtual auto is_set() const -> bool = 0;
-        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
-        [[nodiscard]] virtual auto get_choices() const -> std::vector<std::string> = 0;
-        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+        [[nodiscard]] auto get_shared_names() const -> const std::shared_ptr<const std::vector<std::string>>& {
+            return m_names;
+        }
     };
 } // namespace argon::detail
 
 
 namespace argon {
-    template <typename T>
-    class Flag final
-            : public detail::FlagBase,
-              public detail::SingleValueStorage<Flag<T>, T>,
-              public detail::Converter<Flag<T>, T>,
-              public detail::ValueValidatorMixin<Flag<T>, T>,
-              public detail::InputHintMixin<Flag<T>, T>,
-              public detail::DescriptionMixin<Flag<T>> {
-        std::optional<T> m_implicitValue;
+    template <typename E> requires std::is_scoped_enum_v<E>
+    [[nodiscard]] constexpr auto enum_name(const E value) -> std::string_view {
+        return detail::EnumReflection<E>::to_name(value);
+    }
+} // namespace argon
 
-        auto set_value(std::optional<const std::string_view> str) -> std::expected<void, std::string> override {
-            if (this->m_defaultValue.has_value()) {
-                auto res = this->apply_value_validator(this->m_defaultValue.value());
-                if (!res) {
-                    throw std::logic_error(std::format(
-                        "Default value for flag '{}' does not meet the validation requirement: {}",
-                        this->get_flag(), res.error()));
-                }
-            }
-            if (this->m_implicitValue.has_value()) {
-                auto res = this->apply_value_validator(this->m_implicitValue.value());
-                if (!res) {
-                    throw std::logic_error(std::format(
-                        "Implicit value for flag '{}' does not meet the validation requirement: {}",
-                        this->get_flag(), res.error()));
-                }
-            }
 
-            if (str == std::nullopt) {
-                if (!is_implicit_set()) {
-                    return std::unexpected(
-                        std::format("Flag '{}' does not have an implicit value and no value was given", this->get_flag()));
-                }
-                this->m_valueStorage = m_implicitValue;
-                return {};
-            }
+namespace argon {
+    enum class ResponseFileFormat {
+        Newline,
+        Null,
+    };
 
-            auto convert = this->convert(str.value());
-            if (!convert.has_value()) {
-                return std::unexpected(std::format(
-                    "Invalid value '{}' for flag '{}': {}",
-                    str.value(), this->get_flag(), convert.error()));
-            }
-            this->m_valueStorage = convert.value();
+    struct ResponseFileConfig {
+        ResponseFileFormat format = ResponseFileFormat::Newline;
+        size_t maxDepth = 8;
+    };
 
-            if (auto validate = this->apply_value_validator(this->m_valueStorage.value()); !validate.has_value()) {
-                return std::unexpected(std::format(
-                    "Invalid value '{}' for flag '{}': {}",
-                    str.value(), this->get_flag(), validate.error()));
-            }
-            return {};
-        }
+    // Whether a configuration file that does not exist is an error or is skipped
+    enum class ConfigFilePresence {
+        Optional,
+        Required,
+    };
 
-        [[nodiscard]] auto is_set() const -> bool override {
-            return this->m_valueStorage.has_value();
-        }
+    struct DescriptorSourceConfig {
+        int fd = 0;
+        ResponseFileFormat format = ResponseFileFormat::Null;
+        size_t bufferSize = size_t{1} << 20;
+        // The descriptor is only read in runs given this argument, which is removed before parsing
+        std::string option = "--from-stdin0";
+    };
 
-        [[nodiscard]] auto is_implicit_set() const -> bool override {
-            return m_implicitValue.has_value();
-        }
+    enum class CompletionShell {
+        Bash,
+        Zsh,
+        Fish,
+    };
 
-        [[nodiscard]] auto get_input_hint() const -> const std::string& override {
-            return this->m_inputHint;
-        }
+    enum class CompletionDataFormat {
+        JsonLines,
+        Binary,
+    };
 
-        [[nodiscard]] auto get_description() const -> const std::string& override {
-            return this->m_description;
-        }
-    public:
-        explicit Flag(const std::string_view flag) : FlagBase(flag) {}
+    enum class OptionKind : uint8_t {
+        Flag,
+        MultiFlag,
+        Choice,
+        MultiChoice,
+    };
 
-        auto with_alias(std::string_view alias) & -> Flag& {
-            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
-                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
-            }
-            this->m_aliases.emplace_back(alias);
-            return *this;
-        }
+    // Description of an option in the command tree, for tools that work from the tree instead of running the parser
+    struct OptionInfo {
+        OptionKind kind = OptionKind::Flag;
+        std::string flag;
+        std::vector<std::string> aliases;
+        bool hasImplicit = false;
+        std::vector<std::string> choices;
 
-        auto with_alias(std::string_view alias) && -> Flag&& {
-            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
-                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
-            }
-            this->m_aliases.emplace_back(alias);
-            return std::move(*this);
+        [[nodiscard]] auto takes_multiple_values() const -> bool {
+            return kind == OptionKind::MultiFlag || kind == OptionKind::MultiChoice;
         }
 
-        auto with_implicit(T implicitValue) & -> Flag& {
-            m_implicitValue = std::move(implicitValue);
-            return *this;
-        }
+        auto operator==(const OptionInfo&) const -> bool = default;
+    };
 
-        auto with_implicit(T implicitValue) && -> Flag&& {
-            m_implicitValue = std::move(implicitValue);
-            return std::move(*this);
-        }
+    struct CommandInfo {
+        std::string name;
+        std::string description;
+        std::vector<OptionInfo> options;
+        std::vector<CommandInfo> subcommands;
+
+        auto operator==(const CommandInfo&) const -> bool = default;
     };
+} // namespace argon
 
-    template <typename T>
-    class MultiFlag final
-            : public detail::MultiFlagBase,
-              public detail::VectorValueStorage<MultiFlag<T>, T>,
-              public detail::Converter<MultiFlag<T>, T>,
-              public detail::ValueValidatorMixin<MultiFlag<T>, T>,
-              public detail::GroupValidatorMixin<MultiFlag<T>, T>,
-              public detail::InputHintMixin<MultiFlag<T>, T>,
-              public detail::DescriptionMixin<MultiFlag<T>> {
-        std::optional<std::vector<T>> m_implicitValue;
 
-        auto set_value(const std::span<const std::string_view> values) -> std::expected<void, std::vector<std::string>> override {
-            if (this->m_defaultValue.has_value()) {
-                auto res = this->apply_group_validator(this->m_defaultValue.value());
-                if (!res) {
-                    throw std::logic_error(std::format(
-                        "Default value for flag '{}' does not meet the validation requirement: {}",
-                        this->get_flag(), res.error()));
-                }
-            }
-            if (this->m_implicitValue.has_value()) {
-                auto res = this->apply_group_validator(this->m_implicitValue.value());
-                if (!res) {
-                    throw std::logic_error(std::format(
-                        "Implicit value for flag '{}' does not meet the validation requirement: {}",
-                        this->get_flag(), res.error()));
-                }
-            }
+namespace argon::detail {
+    inline auto read_descriptor(const int fd, char *buffer, const size_t size) -> std::ptrdiff_t {
+#if defined(_WIN32)
+        return _read(fd, buffer, static_cast<unsigned int>(std::min<size_t>(size, INT_MAX)));
+#else
+        return ::read(fd, buffer, size);
+#endif
+    }
 
-            std::vector<std::string> errors;
-            if (values.empty()) {
-                if (!is_implicit_set()) {
-                    errors.emplace_back(std::format(
-                        "Flag '{}' does not have an implicit value and no value was given", this->get_flag()));
-                }
-                this->m_valueStorage = m_implicitValue.value();
-                return {};
-            }
+    inline auto write_descriptor(const int fd, const char *buffer, const size_t size) -> std::ptrdiff_t {
+#if defined(_WIN32)
+        return _write(fd, buffer, static_cast<unsigned int>(std::min<size_t>(size, INT_MAX)));
+#else
+        return ::write(fd, buffer, size);
+#endif
+    }
 
-            for (const auto& value : values) {
-                auto result = this->convert(value);
-                if (!result.has_value()) {
-                    errors.emplace_back(std::format(
-                        "Invalid value '{}' for flag '{}': {}",
-                        value, this->get_flag(), result.error()));
-                    continue;
-                }
+    // Appends everything read from fd until it ends to out, and returns false on a read error
+    inline auto read_all_descriptor(const int fd, std::string& out) -> bool {
+        std::array<char, 64 * 1024> chunk{};
+        while (true) {
+            const auto count = read_descriptor(fd, chunk.data(), chunk.size());
+            if (count < 0 && errno == EINTR) continue;
+            if (count < 0) return false;
+            if (count == 0) return true;
+            out.append(chunk.data(), static_cast<size_t>(count));
+        }
+    }
 
-                if (auto validate = this->apply_value_validator(result.value()); !validate.has_value()) {
-                    errors.emplace_back(std::format(
-                        "Invalid value '{}' for flag '{}': {}",
-                        value, this->get_flag(), validate.error()));
+    // Splits the arguments read from a file descriptor. The buffer is reused between reads, so memory is bounded by the
+    // buffer size and the longest argument. A returned view is only valid until the next call to next.
+    class DescriptorReader {
+        int m_fd;
+        char m_separator;
+        bool m_stripCarriageReturn;
+        std::vector<char> m_buffer;
+        size_t m_begin = 0;
+        size_t m_end = 0;
+        bool m_eof = false;
+        std::optional<std::string_view> m_peeked;
+        std::string m_error;
+
+        auto fill() -> bool {
+            if (m_eof) return false;
+            if (m_begin > 0) {
+                std::copy(m_buffer.begin() + static_cast<std::ptrdiff_t>(m_begin),
+                          m_buffer.begin() + static_cast<std::ptrdiff_t>(m_end), m_buffer.begin());
+                m_end -= m_begin;
+                m_begin = 0;
+            }
+            if (m_end == m_buffer.size()) m_buffer.resize(m_buffer.size() * 2);
+
+            while (true) {
+                const auto count = read_descriptor(m_fd, m_buffer.data() + m_end, m_buffer.size() - m_end);
+                if (count < 0 && errno == EINTR) continue;
+                if (count < 0) m_error = std::format("Unable to read arguments from file descriptor {}", m_fd);
+                if (count <= 0) {
+                    m_eof = true;
+                    return false;
                 }
-                this->m_valueStorage.emplace_back(std::move(result.value()));
+                m_end += static_cast<size_t>(count);
+                return true;
             }
+        }
 
-            if (auto validate = this->apply_group_validator(this->m_valueStorage); !validate.has_value()) {
-                errors.emplace_back(std::format(
-                    "Invalid values for flag '{}': {}",
-                    this->get_flag(), validate.error()));
-            }
+        auto read_next() -> std::optional<std::string_view> {
+            while (true) {
+                const std::string_view data(m_buffer.data() + m_begin, m_end - m_begin);
+                std::string_view arg;
+                if (const size_t separator = data.find(m_separator); separator != std::string_view::npos) {
+                    arg = data.substr(0, separator);
+                    m_begin += separator + 1;
+                } else if (!fill()) {
+                    if (data.empty()) return std::nullopt;
+                    arg = data;
+                    m_begin = m_end;
+                } else {
+                    continue;
+                }
 
-            if (!errors.empty()) {
-                return std::unexpected(std::move(errors));
+                if (m_stripCarriageReturn && arg.ends_with('\r')) arg.remove_suffix(1);
+                if (!arg.empty()) return arg;
             }
-            return {};
         }
 
-        [[nodiscard]] auto is_set() const -> bool override {
-            return !this->m_valueStorage.empty();
-        }
+    public:
+        explicit DescriptorReader(const DescriptorSourceConfig& config)
+            : m_fd(config.fd),
+              m_separator(config.format == ResponseFileFormat::Null ? '\0' : '\n'),
+              m_stripCarriageReturn(config.format == ResponseFileFormat::Newline),
+              m_buffer(std::max<size_t>(config.bufferSize, 1)) {}
 
-        [[nodiscard]] auto is_implicit_set() const -> bool override {
-            return m_implicitValue.has_value();
+        [[nodiscard]] auto peek() -> std::optional<std::string_view> {
+            if (!m_peeked.has_value()) m_peeked = read_next();
+            return m_peeked;
         }
 
-        [[nodiscard]] auto get_input_hint() const -> const std::string& override {
-            return this->m_inputHint;
+        auto next() -> std::optional<std::string_view> {
+            if (m_peeked.has_value()) return std::exchange(m_peeked, std::nullopt);
+            return read_next();
         }
 
-        [[nodiscard]] auto get_description() const -> const std::string& override {
-            return this->m_description;
+        [[nodiscard]] auto get_error() const -> const std::string& {
+            return m_error;
         }
-    public:
-        explicit MultiFlag(const std::string_view flag) : MultiFlagBase(flag) {}
 
-        auto with_alias(std::string_view alias) & -> MultiFlag& {
-            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
-                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+        // Reads everything that is left and returns the arguments as views into the returned buffer
+        [[nodiscard]] auto read_all() -> std::expected<std::pair<std::shared_ptr<const std::string>, std::vector<std::string_view>>, std::string> {
+            auto buffer = std::make_shared<std::string>();
+            std::vector<size_t> offsets;
+            while (const auto arg = next()) {
+                offsets.push_back(buffer->size());
+                buffer->append(arg.value());
+                buffer->push_back('\0');
             }
-            this->m_aliases.emplace_back(alias);
-            return *this;
+            if (!m_error.empty()) return std::unexpected(m_error);
+
+            std::vector<std::string_view> args;
+            args.reserve(offsets.size());
+            for (const size_t offset : offsets) {
+                args.emplace_back(buffer->c_str() + offset);
+            }
+            return std::pair{std::shared_ptr<const std::string>(std::move(buffer)), std::move(args)};
         }
+    };
+} // namespace argon::detail
 
-        auto with_alias(std::string_view alias) && -> MultiFlag&& {
-            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
-                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+
+namespace argon::detail {
+    template <typename T>
+    concept SnapshotValue = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, std::string>
+        || std::is_same_v<T, std::string_view> || std::is_same_v<T, std::filesystem::path>;
+
+    // Encodes option values for a snapshot. Numbers are stored in native byte order, since a snapshot is meant to be
+    // read by another process on the same machine.
+    class SnapshotWriter {
+        std::string m_buffer;
+
+        template <typename T>
+        auto write_value(const T& value) -> void {
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+                write_string(value);
+            } else if constexpr (std::is_same_v<T, std::filesystem::path>) {
+                write_string(value.string());
+            } else if constexpr (std::is_same_v<T, bool>) {
+                write_raw(static_cast<uint8_t>(value));
+            } else if constexpr (std::is_enum_v<T>) {
+                write_raw(std::to_underlying(value));
+            } else {
+                write_raw(value);
             }
-            this->m_aliases.emplace_back(alias);
-            return std::move(*this);
         }
 
-        auto with_implicit(std::vector<T> implicitValue) & -> MultiFlag& {
-            m_implicitValue = std::move(implicitValue);
-            return *this;
+    public:
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        auto write_raw(const T& value) -> void {
+            m_buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
         }
 
-        auto with_implicit(std::vector<T> implicitValue) && -> MultiFlag&& {
-            m_implicitValue = std::move(implicitValue);
-            return std::move(*this);
+        auto write_string(const std::string_view str) -> void {
+            write_raw(static_cast<uint32_t>(str.size()));
+            m_buffer.append(str);
         }
-    };
 
-    template <typename T>
-    class Positional final
-            : public detail::PositionalBase,
-              public detail::SingleValueStorage<Positional<T>, T>,
-              public detail::Converter<Positional<T>, T> ,
-              public detail::ValueValidatorMixin<Positional<T>, T> ,
-              public detail::DescriptionMixin<Positional<T>> {
-        auto set_value(std::optional<const std::string_view> str) -> std::expected<void, std::string>  override {
-            if (this->m_defaultValue.has_value()) {
-                auto res = this->apply_value_validator(this->m_defaultValue.value());
-                if (!res) {
-                    throw std::logic_error(std::format(
-                        "Default value for positional '{}' does not meet the validation requirement: {}",
-                        this->get_name(), res.error()));
+        template <std::ranges::sized_range Range, typename T = std::ranges::range_value_t<Range>>
+        [[nodiscard]] auto write_values(const Range& values, const std::string_view name)
+            -> std::expected<void, std::string> {
+            if constexpr (!SnapshotValue<T>) {
+                if (!values.empty()) {
+                    return std::unexpected(std::format(
+                        "Values of '{}' cannot be written to a snapshot, only builtin types are supported", name));
+                }
+                write_raw(uint32_t{0});
+            } else {
+                write_raw(static_cast<uint32_t>(values.size()));
+                for (const auto& value : values) {
+                    write_value<T>(value);
                 }
-            }
-
-            auto result = this->convert(str.value());
-            if (!result) {
-                return std::unexpected(std::format(
-                    "Invalid value '{}' for '{}': {}",
-                    str.value(), this->get_name(), result.error()));
-            }
-            this->m_valueStorage = result.value();
-
-            if (auto validate = this->apply_value_validator(this->m_valueStorage.value()); !validate.has_value()) {
-                return std::unexpected(std::format(
-                    "Invalid value '{}' for '{}': {}",
-                    str.value(), this->get_name(), validate.error()));
             }
             return {};
         }
 
-        [[nodiscard]] auto is_set() const -> bool override {
-            return this->m_valueStorage.has_value();
+        [[nodiscard]] auto take() && -> std::string {
+            return std::move(m_buffer);
         }
+    };
 
-        [[nodiscard]] auto get_description() const -> const std::string& override {
-            return this->m_description;
+    // Decodes a snapshot in place. String values are views into the snapshot, and std::string_view values are
+    // returned without copying.
+    class SnapshotReader {
+        std::string_view m_data;
+
+        template <typename T>
+        [[nodiscard]] auto read_value() -> std::optional<T> {
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>
+                          || std::is_same_v<T, std::filesystem::path>) {
+                const auto str = read_string();
+                if (!str.has_value()) return std::nullopt;
+                return T(str.value());
+            } else if constexpr (std::is_same_v<T, bool>) {
+                // Any other byte is not a valid bool
+                const auto byte = read_raw<uint8_t>();
+                if (!byte.has_value() || byte.value() > 1) return std::nullopt;
+                return byte.value() == 1;
+            } else if constexpr (std::is_enum_v<T>) {
+                const auto underlying = read_raw<std::underlying_type_t<T>>();
+                if (!underlying.has_value()) return std::nullopt;
+                return static_cast<T>(underlying.value());
+            } else {
+                return read_raw<T>();
+            }
         }
 
     public:
-        explicit Positional(const std::string_view name) : PositionalBase(name) {}
-    };
+        explicit SnapshotReader(const std::string_view data) : m_data(data) {}
 
-    template <typename T>
-    class MultiPositional final
-            : public detail::MultiPositionalBase,
-              public detail::VectorValueStorage<MultiPositional<T>, T>,
-              public detail::Converter<MultiPositional<T>, T>,
-              public detail::ValueValidatorMixin<MultiPositional<T>, T>,
-              public detail::GroupValidatorMixin<MultiPositional<T>, T>,
-              public detail::DescriptionMixin<MultiPositional<T>> {
-        auto set_value(const std::span<const std::string_view> values) -> std::expected<void, std::vector<std::string>>  override {
-            if (this->m_defaultValue.has_value()) {
-                auto res = this->apply_group_validator(this->m_defaultValue.value());
-                if (!res) {
-                    throw std::logic_error(std::format(
-                        "Default value for '{}' does not meet the validation requirement: {}",
-                        this->get_name(), res.error()));
-                }
-            }
+        [[nodiscard]] auto empty() const -> bool {
+            return m_data.empty();
+        }
 
-            std::vector<std::string> errors;
-            for (const auto& value : values) {
-                auto result = this->convert(value);
-                if (!result.has_value()) {
-                    errors.emplace_back(std::format(
-                        "Invalid value '{}' for '{}': {}",
-                        value, this->get_name(), result.error()));
-                    continue;
-                }
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] auto read_raw() -> std::optional<T> {
+            if (m_data.size() < sizeof(T)) return std::nullopt;
+            T value;
+            std::memcpy(&value, m_data.data(), sizeof(T));
+            m_data.remove_prefix(sizeof(T));
+            return value;
+        }
 
-                if (auto validate = this->apply_value_validator(result.value()); !validate.has_value()) {
-                    errors.emplace_back(std::format(
-                        "Invalid value '{}' for '{}': {}",
-                        value, this->get_name(), validate.error()));
-                }
-                this->m_valueStorage.emplace_back(std::move(result.value()));
-            }
+        [[nodiscard]] auto read_string() -> std::optional<std::string_view> {
+            const auto size = read_raw<uint32_t>();
+            if (!size.has_value() || m_data.size() < size.value()) return std::nullopt;
+            const std::string_view str = m_data.substr(0, size.value());
+            m_data.remove_prefix(size.value());
+            return str;
+        }
 
-            if (auto validate = this->apply_group_validator(this->m_valueStorage); !validate.has_value()) {
-                errors.emplace_back(std::format("Invalid values for '{}': {}", this->get_name(), validate.error()));
+        // Accepts every value of its type, options with a fixed set of values check it instead
+        struct AnyValue {
+            [[nodiscard]] auto operator()(const auto&) const -> bool {
+                return true;
             }
+        };
 
-            if (!errors.empty()) {
-                return std::unexpected(std::move(errors));
+        template <typename T, typename Accept = AnyValue>
+        [[nodiscard]] auto read_values(std::vector<T>& out, const Accept& accept = {}) -> bool {
+            const auto count = read_raw<uint32_t>();
+            if (!count.has_value()) return false;
+            out.clear();
+            if constexpr (!SnapshotValue<T>) {
+                return count.value() == 0;
+            } else {
+                out.reserve(std::min<size_t>(count.value(), m_data.size()));
+                for (uint32_t i = 0; i < count.value(); i++) {
+                    auto value = read_value<T>();
+                    if (!value.has_value() || !accept(value.value())) return false;
+                    out.push_back(std::move(value.value()));
+                }
+                return true;
             }
-            return {};
         }
 
-        [[nodiscard]] auto is_set() const -> bool override {
-            return !this->m_valueStorage.empty();
+        template <typename T, typename Accept = AnyValue>
+        [[nodiscard]] auto read_single_value(std::optional<T>& out, const Accept& accept = {}) -> bool {
+            const auto count = read_raw<uint32_t>();
+            if (!count.has_value() || count.value() > 1) return false;
+            out.reset();
+            if (count.value() == 0) return true;
+            if constexpr (!SnapshotValue<T>) {
+                return false;
+            } else {
+                out = read_value<T>();
+                return out.has_value() && accept(out.value());
+            }
         }
+    };
+} // namespace argon::detail
 
-        [[nodiscard]] auto get_description() const -> const std::string& override {
-            return this->m_description;
-        }
 
-    public:
-        explicit MultiPositional(const std::string_view name) : MultiPositionalBase(name) {}
+namespace argon::detail {
+    template <typename T> class ValueStream;
+    class Context;
+
+    // Consecutive values of a streamed multi-positional, which start at argvBegin in argv and at valuesBegin in its
+    // values
+    struct ArgvRun {
+        size_t argvBegin;
+        size_t valuesBegin;
     };
 
-    template <typename T>
-    class Choice final
-            : public detail::ChoiceBase,
-              public detail::SingleValueStorage<Choice<T>, T>,
-              public detail::DescriptionMixin<Choice<T>> {
-        std::vector<std::pair<std::string, T>> m_choices;
-        std::optional<T> m_implicitValue;
-
-        auto set_value(std::optional<const std::string_view> str) -> std::expected<void, std::string> override {
-            if (str == std::nullopt) {
-                if (!is_implicit_set()) {
-                    return std::unexpected(
-                        std::format("Flag '{}' does not have an implicit value and no value was given", this->get_flag()));
-                }
-                this->m_valueStorage = m_implicitValue;
-                return {};
-            }
+    class FlagBase {
+        friend class AstAnalyzer;
+        friend class Context;
 
-            const auto it = std::ranges::find_if(m_choices, [&str](const auto& choice) -> bool {
-                return choice.first == *str;
-            });
-            if (it == m_choices.end()) {
-                std::string values = std::ranges::fold_left(m_choices, std::string{},
-                    [](std::string acc, const auto& choice) {
-                        if (!acc.empty()) acc += " | ";
-                        acc += choice.first;
-                        return acc;
-                    }
-                );
-                return std::unexpected(std::format(
-                    "Invalid value '{}' for flag '{}'. Valid values are: {}",
-                    str.value(), this->get_flag(), values));
-            }
-            this->m_valueStorage = it->second;
-            return {};
+    protected:
+        std::string m_flag;
+        std::vector<std::string> m_aliases;
+        std::string m_environmentVariable;
+        bool m_lazyConversion = false;
+
+        [[nodiscard]] virtual auto set_value(std::optional<const std::string_view> str) -> std::expected<void, Error> = 0;
+        virtual auto clear_value() -> void = 0;
+        [[nodiscard]] virtual auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> = 0;
+        [[nodiscard]] virtual auto read_snapshot(SnapshotReader& in) -> bool = 0;
+        // Converts the values a lazily converted option was given, so that reading them later does not change it
+        [[nodiscard]] virtual auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> = 0;
+    public:
+        FlagBase() = default;
+        explicit FlagBase(const std::string_view flag) {
+            validate_flag(flag);
+            m_flag = flag;
         }
+        virtual ~FlagBase() = default;
 
-        [[nodiscard]] auto is_set() const -> bool override {
-            return this->m_valueStorage.has_value();
-        }
+        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
+        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
 
-        [[nodiscard]] auto is_implicit_set() const -> bool override {
-            return m_implicitValue.has_value();
-        }
+        [[nodiscard]] virtual auto is_set() const -> bool = 0;
+        [[nodiscard]] virtual auto has_default() const -> bool = 0;
+        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
+        [[nodiscard]] virtual auto get_input_hint() const -> const std::string& = 0;
+        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+    };
 
-        [[nodiscard]] auto get_choices() const -> std::vector<std::string> override {
-            return m_choices | std::views::keys | std::ranges::to<std::vector>();
-        }
+    class MultiFlagBase {
+        friend class AstAnalyzer;
+        friend class Context;
 
-        [[nodiscard]] auto get_description() const -> const std::string& override {
-            return this->m_description;
-        }
+    protected:
+        std::string m_flag;
+        std::vector<std::string> m_aliases;
+        std::string m_environmentVariable;
+        bool m_lazyConversion = false;
+
+        // The position of an error about a single value is the index of that value. Conversion stops once maxErrors
+        // errors are found.
+        [[nodiscard]] virtual auto set_value(std::span<const std::string_view> values, size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> = 0;
+        virtual auto clear_value() -> void = 0;
+        [[nodiscard]] virtual auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> = 0;
+        [[nodiscard]] virtual auto read_snapshot(SnapshotReader& in) -> bool = 0;
+        // Converts the values a lazily converted option was given, so that reading them later does not change it
+        [[nodiscard]] virtual auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> = 0;
+    public:
+        MultiFlagBase() = default;
+        explicit MultiFlagBase(const std::string_view flag) {
+            validate_flag(flag);
+            m_flag = flag;
+        };
+        virtual ~MultiFlagBase() = default;
 
+        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
+        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
+
+        [[nodiscard]] virtual auto is_set() const -> bool = 0;
+        [[nodiscard]] virtual auto has_default() const -> bool = 0;
+        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
+        [[nodiscard]] virtual auto get_input_hint() const -> const std::string& = 0;
+        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+    };
+
+    class PositionalBase {
+        friend class AstAnalyzer;
+        friend class Context;
+
+    protected:
+        std::string m_name;
+        bool m_lazyConversion = false;
+
+        [[nodiscard]] virtual auto set_value(std::optional<const std::string_view> str) -> std::expected<void, Error> = 0;
+        virtual auto clear_value() -> void = 0;
+        [[nodiscard]] virtual auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> = 0;
+        [[nodiscard]] virtual auto read_snapshot(SnapshotReader& in) -> bool = 0;
+        // Converts the values a lazily converted option was given, so that reading them later does not change it
+        [[nodiscard]] virtual auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> = 0;
     public:
-        Choice(const std::string_view flag, std::vector<std::pair<std::string, T>> choices) : ChoiceBase(flag) {
-            if (choices.empty()) {
-                throw std::invalid_argument(std::format("Choices map must not be empty for flag '{}'", this->get_flag()));
+        explicit PositionalBase(const std::string_view name) {
+            if (name.empty()) {
+                throw std::invalid_argument("Positional name must not be empty");
             }
-            m_choices = std::move(choices);
+            m_name = name;
         }
+        virtual ~PositionalBase() = default;
 
-        auto with_alias(std::string_view alias) & -> Choice& {
-            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
-                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
-            }
-            this->m_aliases.emplace_back(alias);
-            return *this;
-        }
+        [[nodiscard]] auto get_name() const -> const std::string& { return m_name; }
+        [[nodiscard]] virtual auto is_set() const -> bool = 0;
+        [[nodiscard]] virtual auto has_default() const -> bool = 0;
+        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+    };
 
-        auto with_alias(std::string_view alias) && -> Choice&& {
-            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
-                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+    class MultiPositionalBase {
+        friend class AstAnalyzer;
+        friend class Context;
+
+    protected:
+        std::string m_name;
+        bool m_lazyConversion = false;
+
+        // The position of an error about a single value is the index of that value. Conversion stops once maxErrors
+        // errors are found.
+        [[nodiscard]] virtual auto set_value(std::span<const std::string_view> values, size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> = 0;
+        virtual auto clear_value() -> void = 0;
+        [[nodiscard]] virtual auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> = 0;
+        [[nodiscard]] virtual auto read_snapshot(SnapshotReader& in) -> bool = 0;
+        // Converts the values a lazily converted option was given, so that reading them later does not change it
+        [[nodiscard]] virtual auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> = 0;
+        [[nodiscard]] virtual auto set_stream_source(std::shared_ptr<DescriptorReader> reader) -> bool = 0;
+        // Streamed values are read from argv after the parse, without converting or copying them first
+        virtual auto set_streamed_runs(std::shared_ptr<const std::vector<std::string_view>> argv,
+                                       std::vector<ArgvRun> runs, size_t count) -> void = 0;
+    public:
+        explicit MultiPositionalBase(const std::string_view name) {
+            if (name.empty()) {
+                throw std::invalid_argument("Multi-positional name must not be empty");
             }
-            this->m_aliases.emplace_back(alias);
-            return std::move(*this);
+            m_name = name;
         }
+        virtual ~MultiPositionalBase() = default;
 
-        auto with_implicit(T implicitValue) & -> Choice& {
-            m_implicitValue = std::move(implicitValue);
-            return *this;
-        }
+        [[nodiscard]] auto get_name() const -> const std::string& { return m_name; }
+        [[nodiscard]] virtual auto is_set() const -> bool = 0;
+        [[nodiscard]] virtual auto is_streamed() const -> bool = 0;
+        [[nodiscard]] virtual auto has_default() const -> bool = 0;
+        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+    };
 
-        auto with_implicit(T implicitValue) && -> Choice&& {
-            m_implicitValue = std::move(implicitValue);
-            return std::move(*this);
+    class ChoiceBase {
+        friend class AstAnalyzer;
+        friend class Context;
+
+    protected:
+        std::string m_flag;
+        std::vector<std::string> m_aliases;
+        std::string m_environmentVariable;
+
+        [[nodiscard]] virtual auto set_value(std::optional<const std::string_view> str) -> std::expected<void, Error> = 0;
+        virtual auto clear_value() -> void = 0;
+        [[nodiscard]] virtual auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> = 0;
+        [[nodiscard]] virtual auto read_snapshot(SnapshotReader& in) -> bool = 0;
+    public:
+        ChoiceBase() = default;
+        explicit ChoiceBase(const std::string_view flag) {
+            validate_flag(flag);
+            m_flag = flag;
         }
+        virtual ~ChoiceBase() = default;
+
+        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
+        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
+
+        [[nodiscard]] virtual auto is_set() const -> bool = 0;
+        [[nodiscard]] virtual auto has_default() const -> bool = 0;
+        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
+        [[nodiscard]] virtual auto get_choices() const -> std::vector<std::string> = 0;
+        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
+    };
+
+    class MultiChoiceBase {
+        friend class AstAnalyzer;
+        friend class Context;
+
+    protected:
+        std::string m_flag;
+        std::vector<std::string> m_aliases;
+
+        // The position of an error about a single value is the index of that value. Conversion stops once maxErrors
+        // errors are found.
+        [[nodiscard]] virtual auto set_value(std::span<const std::string_view> values, size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> = 0;
+        virtual auto clear_value() -> void = 0;
+        [[nodiscard]] virtual auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> = 0;
+        [[nodiscard]] virtual auto read_snapshot(SnapshotReader& in) -> bool = 0;
+    public:
+        MultiChoiceBase() = default;
+        explicit MultiChoiceBase(const std::string_view flag) {
+            validate_flag(flag);
+            m_flag = flag;
+        };
+        virtual ~MultiChoiceBase() = default;
+
+        [[nodiscard]] auto get_flag() const -> const std::string& { return m_flag; }
+        [[nodiscard]] auto get_aliases() const -> const std::vector<std::string>& { return m_aliases; }
+
+        [[nodiscard]] virtual auto is_set() const -> bool = 0;
+        [[nodiscard]] virtual auto has_default() const -> bool = 0;
+        [[nodiscard]] virtual auto is_implicit_set() const -> bool = 0;
+        [[nodiscard]] virtual auto get_choices() const -> std::vector<std::string> = 0;
+        [[nodiscard]] virtual auto get_description() const -> const std::string& = 0;
     };
+} // namespace argon::detail
 
+
+namespace argon {
     template <typename T>
-    class MultiChoice final
-            : public detail::MultiChoiceBase,
-              public detail::VectorValueStorage<MultiChoice<T>, T>,
-              public detail::GroupValidatorMixin<MultiChoice<T>, T>,
-              public detail::DescriptionMixin<MultiChoice<T>> {
-        std::vector<std::pair<std::string, T>> m_choices;
-        std::optional<std::vector<T>> m_implicitValue;
+    class Flag final
+            : public detail::FlagBase,
+              public detail::SingleValueStorage<Flag<T>, T>,
+              public detail::Converter<Flag<T>, T>,
+              public detail::ValueValidatorMixin<Flag<T>, T>,
+              public detail::InputHintMixin<Flag<T>, T>,
+              public detail::DescriptionMixin<Flag<T>> {
+        template <typename> friend class Results;
+
+        std::optional<T> m_implicitValue;
+        mutable std::optional<std::string_view> m_deferredValue;
+        mutable std::optional<Error> m_deferredError;
+
+        auto convert_value(const std::string_view str) const -> std::expected<T, Error> {
+            auto convert = this->convert(str);
+            if (!convert.has_value()) {
+                return std::unexpected(Error(ErrorCode::InvalidValue, std::move(convert.error()))
+                    .with_option(this->get_flag()).with_value(str));
+            }
+            if (auto validate = this->apply_value_validator(convert.value()); !validate.has_value()) {
+                return std::unexpected(Error(ErrorCode::InvalidValue, std::move(validate.error()))
+                    .with_option(this->get_flag()).with_value(str));
+            }
+            return std::move(convert.value());
+        }
+
+        auto resolve_deferred_value() const -> std::expected<void, Error> {
+            if (m_deferredError.has_value()) return std::unexpected(m_deferredError.value());
+            if (!m_deferredValue.has_value()) return {};
 
-        auto set_value(const std::span<const std::string_view> values) -> std::expected<void, std::vector<std::string>> override {
+            auto value = convert_value(m_deferredValue.value());
+            if (!value.has_value()) {
+                m_deferredError = value.error();
+                return std::unexpected(std::move(value.error()));
+            }
+            this->m_valueStorage = std::move(value.value());
+            m_deferredValue.reset();
+            return {};
+        }
+
+        auto set_value(std::optional<const std::string_view> str) -> std::expected<void, Error> override {
             if (this->m_defaultValue.has_value()) {
-                auto res = this->apply_group_validator(this->m_defaultValue.value());
+                auto res = this->apply_value_validator(this->m_defaultValue.value());
                 if (!res) {
                     throw std::logic_error(std::format(
                         "Default value for flag '{}' does not meet the validation requirement: {}",
@@ -1101,7 +1790,7 @@ namespace argon {
                 }
             }
             if (this->m_implicitValue.has_value()) {
-                auto res = this->apply_group_validator(this->m_implicitValue.value());
+                auto res = this->apply_value_validator(this->m_implicitValue.value());
                 if (!res) {
                     throw std::logic_error(std::format(
                         "Implicit value for flag '{}' does not meet the validation requirement: {}",
@@ -1109,74 +1798,87 @@ namespace argon {
                 }
             }
 
-            std::vector<std::string> errors;
-            if (values.empty()) {
+            m_deferredValue.reset();
+            m_deferredError.reset();
+            if (str == std::nullopt) {
                 if (!is_implicit_set()) {
-                    errors.emplace_back(std::format(
-                        "Flag '{}' does not have an implicit value and no value was given", this->get_flag()));
+                    return std::unexpected(Error(ErrorCode::MissingValue).with_option(this->get_flag()));
                 }
-                this->m_valueStorage = m_implicitValue.value();
+                this->m_valueStorage = m_implicitValue;
                 return {};
             }
 
-            for (const auto& value : values) {
-                const auto it = std::ranges::find_if(m_choices, [&value](const auto& choice) -> bool {
-                    return choice.first == value;
-                });
-                if (it == m_choices.end()) {
-                    std::string possibleValues = std::ranges::fold_left(m_choices, std::string{},
-                        [](std::string acc, const auto& choice) {
-                            if (!acc.empty()) acc += " | ";
-                            acc += choice.first;
-                            return acc;
-                        }
-                    );
-                    errors.emplace_back(std::format(
-                        "Invalid value '{}' for flag '{}'. Valid values are: {}",
-                        value, this->get_flag(), possibleValues));
-                    continue;
-                }
-                this->m_valueStorage.emplace_back(it->second);
-            }
-
-            if (auto validate = this->apply_group_validator(this->m_valueStorage); !validate.has_value()) {
-                errors.emplace_back(std::format(
-                    "Invalid values for flag '{}': {}",
-                    this->get_flag(), validate.error()));
+            if (this->m_lazyConversion) {
+                this->m_valueStorage.reset();
+                m_deferredValue = str.value();
+                return {};
             }
 
-            if (!errors.empty()) {
-                return std::unexpected(std::move(errors));
+            auto value = convert_value(str.value());
+            if (!value.has_value()) {
+                return std::unexpected(std::move(value.error()));
             }
+            this->m_valueStorage = std::move(value.value());
             return {};
         }
 
         [[nodiscard]] auto is_set() const -> bool override {
-            return !this->m_valueStorage.empty();
+            return this->m_valueStorage.has_value() || m_deferredValue.has_value();
         }
 
         [[nodiscard]] auto is_implicit_set() const -> bool override {
             return m_implicitValue.has_value();
         }
 
-        [[nodiscard]] auto get_choices() const -> std::vector<std::string> override {
-            return m_choices | std::views::keys | std::ranges::to<std::vector>();
+        [[nodiscard]] auto get_input_hint() const -> const std::string& override {
+            return this->m_inputHint;
+        }
+
+        [[nodiscard]] auto write_snapshot(detail::SnapshotWriter& out) const -> std::expected<void, std::string> override {
+            if (auto resolved = resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(resolved.error().message());
+            }
+            return out.write_values(this->single_value_span(), this->get_flag());
+        }
+
+        [[nodiscard]] auto read_snapshot(detail::SnapshotReader& in) -> bool override {
+            return in.read_single_value(this->m_valueStorage);
+        }
+
+        [[nodiscard]] auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> override {
+            if (auto resolved = resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(std::vector{std::move(resolved.error())});
+            }
+            return {};
+        }
+
+        auto clear_value() -> void override {
+            this->m_valueStorage.reset();
+            m_deferredValue.reset();
+            m_deferredError.reset();
+        }
+
+        [[nodiscard]] auto has_default() const -> bool override {
+            return this->m_defaultValue.has_value();
         }
 
         [[nodiscard]] auto get_description() const -> const std::string& override {
             return this->m_description;
         }
-
     public:
-        MultiChoice(const std::string_view flag, std::vector<std::pair<std::string, T>> choices) : MultiChoiceBase(flag) {
-            if (choices.empty()) {
-                throw std::invalid_argument(std::format("Choices map must not be empty for flag '{}'", this->get_flag()));
-            }
-            m_choices = std::move(choices);
+        explicit Flag(const std::string_view flag) : FlagBase(flag) {}
+
+        auto with_lazy_conversion() & -> Flag& {
+            this->m_lazyConversion = true;
+            return *this;
         }
 
+        auto with_lazy_conversion() && -> Flag&& {
+            this->m_lazyConversion = true;
+            return std::move(*this);
+        }
 
-        auto with_alias(std::string_view alias) & -> MultiChoice& {
+        auto with_alias(std::string_view alias) & -> Flag& {
             if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
                 throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
             }
@@ -1184,7 +1886,7 @@ namespace argon {
             return *this;
         }
 
-        auto with_alias(std::string_view alias) && -> MultiChoice&& {
+        auto with_alias(std::string_view alias) && -> Flag&& {
             if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
                 throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
             }
@@ -1192,666 +1894,3193 @@ namespace argon {
             return std::move(*this);
         }
 
-        auto with_implicit(std::vector<T> implicitValue) & -> MultiChoice& {
+        auto with_env(const std::string_view variable) & -> Flag& {
+            this->m_environmentVariable = variable;
+            return *this;
+        }
+
+        auto with_env(const std::string_view variable) && -> Flag&& {
+            this->m_environmentVariable = variable;
+            return std::move(*this);
+        }
+
+        auto with_implicit(T implicitValue) & -> Flag& {
             m_implicitValue = std::move(implicitValue);
             return *this;
         }
 
-        auto with_implicit(std::vector<T> implicitValue) && -> MultiChoice&& {
+        auto with_implicit(T implicitValue) && -> Flag&& {
             m_implicitValue = std::move(implicitValue);
             return std::move(*this);
         }
     };
- } // namespace argon::detail
-
 
-namespace argon::detail {
-    class UniqueId {
-        size_t m_id;
+    template <typename T>
+    class MultiFlag final
+            : public detail::MultiFlagBase,
+              public detail::VectorValueStorage<MultiFlag<T>, T>,
+              public detail::Converter<MultiFlag<T>, T>,
+              public detail::ValueValidatorMixin<MultiFlag<T>, T>,
+              public detail::GroupValidatorMixin<MultiFlag<T>, T>,
+              public detail::InputHintMixin<MultiFlag<T>, T>,
+              public detail::DescriptionMixin<MultiFlag<T>>,
+              public detail::ParallelConversionMixin<MultiFlag<T>> {
+        template <typename> friend class Results;
 
-        static auto next() -> size_t {
-            static std::atomic<size_t> counter{0};
-            return counter.fetch_add(1, std::memory_order_relaxed);
+        std::optional<std::vector<T>> m_implicitValue;
+        mutable std::vector<std::string_view> m_deferredValues;
+        mutable std::optional<std::vector<Error>> m_deferredErrors;
+
+        template <typename Range>
+        auto append_values(const Range& values, std::vector<Error>& errors, const size_t maxErrors) const -> void {
+            const auto convertOne = [this](const size_t index, const std::string_view value, std::vector<T>& out,
+                                           std::vector<Error>& errs) {
+                auto result = this->convert(value);
+                if (!result.has_value()) {
+                    errs.emplace_back(Error(ErrorCode::InvalidValue, std::move(result.error()))
+                        .with_option(this->get_flag()).with_value(value).with_position(index));
+                    return;
+                }
+
+                if (auto validate = this->apply_value_validator(result.value()); !validate.has_value()) {
+                    errs.emplace_back(Error(ErrorCode::InvalidValue, std::move(validate.error()))
+                        .with_option(this->get_flag()).with_value(value).with_position(index));
+                }
+                out.emplace_back(std::move(result.value()));
+            };
+            detail::convert_values(values, this->get_num_threads(std::ranges::size(values)),
+                this->m_valueStorage, errors, maxErrors, convertOne);
+            if (errors.size() >= maxErrors) return;
+
+            if (auto validate = this->apply_group_validator(this->m_valueStorage); !validate.has_value()) {
+                errors.emplace_back(Error(ErrorCode::InvalidValues, std::move(validate.error())).with_option(this->get_flag()));
+            }
         }
-    public:
-        UniqueId() : m_id(next()) {}
-        [[nodiscard]] auto get_id() const -> size_t { return m_id; }
-        auto operator<=>(const UniqueId&) const = default;
-    };
-} // namespace argon::detail
 
+        auto resolve_deferred_value() const -> std::expected<void, std::vector<Error>> {
+            if (m_deferredErrors.has_value()) return std::unexpected(m_deferredErrors.value());
+            if (m_deferredValues.empty()) return {};
 
-namespace argon {
-    template <typename CommandTag, typename ValueType, typename HandleTag>
-    class Handle {
-        // ReSharper disable CppDFANotInitializedField
-        detail::UniqueId m_id;
-        // ReSharper restore CppDFANotInitializedField
+            std::vector<Error> errors;
+            append_values(m_deferredValues, errors, std::numeric_limits<size_t>::max());
+            m_deferredValues.clear();
+            if (!errors.empty()) {
+                m_deferredErrors = errors;
+                return std::unexpected(std::move(errors));
+            }
+            return {};
+        }
 
-    public:
-        Handle() = delete;
-        explicit Handle(const detail::UniqueId& id) : m_id(id) {}
+        auto set_value(const std::span<const std::string_view> values, const size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> override {
+            if (this->m_defaultValue.has_value()) {
+                auto res = this->apply_group_validator(this->m_defaultValue.value());
+                if (!res) {
+                    throw std::logic_error(std::format(
+                        "Default value for flag '{}' does not meet the validation requirement: {}",
+                        this->get_flag(), res.error()));
+                }
+            }
+            if (this->m_implicitValue.has_value()) {
+                auto res = this->apply_group_validator(this->m_implicitValue.value());
+                if (!res) {
+                    throw std::logic_error(std::format(
+                        "Implicit value for flag '{}' does not meet the validation requirement: {}",
+                        this->get_flag(), res.error()));
+                }
+            }
 
-        [[nodiscard]] auto get_id() const -> detail::UniqueId {
-            return m_id;
+            if (values.empty()) {
+                if (!is_implicit_set()) {
+                    return std::unexpected(std::vector{Error(ErrorCode::MissingValue).with_option(this->get_flag())});
+                }
+                m_deferredValues.clear();
+                this->m_valueStorage = m_implicitValue.value();
+                return {};
+            }
+
+            if (this->m_lazyConversion) {
+                m_deferredValues.insert(m_deferredValues.end(), values.begin(), values.end());
+                return {};
+            }
+
+            std::vector<Error> errors;
+            append_values(values, errors, maxErrors);
+            if (!errors.empty()) {
+                return std::unexpected(std::move(errors));
+            }
+            return {};
         }
-    };
 
-    template <typename CommandTag, typename ValueType> using FlagHandle            = Handle<CommandTag, ValueType, struct FlagTag>;
-    template <typename CommandTag, typename ValueType> using MultiFlagHandle       = Handle<CommandTag, ValueType, struct MultiFlagTag>;
-    template <typename CommandTag, typename ValueType> using PositionalHandle      = Handle<CommandTag, ValueType, struct PositionalTag>;
-    template <typename CommandTag, typename ValueType> using MultiPositionalHandle = Handle<CommandTag, ValueType, struct MultiPositionalTag>;
-    template <typename CommandTag, typename ValueType> using ChoiceHandle          = Handle<CommandTag, ValueType, struct ChoiceTag>;
-    template <typename CommandTag, typename ValueType> using MultiChoiceHandle     = Handle<CommandTag, ValueType, struct MultiChoiceTag>;
-    template <typename CommandTag> using CommandHandle = Handle<CommandTag, void, struct SubcommandTag>;
-    using AnyCommandHandle = Handle<struct AnyCommandTag, void, struct AnyCommandTag>;
+        [[nodiscard]] auto is_set() const -> bool override {
+            return !this->m_valueStorage.empty() || !m_deferredValues.empty();
+        }
 
-    template <typename T>
-    concept IsSingleValueHandleTag =
-        std::is_same_v<T, FlagTag> ||
-        std::is_same_v<T, PositionalTag> ||
-        std::is_same_v<T, ChoiceTag>;
+        [[nodiscard]] auto is_implicit_set() const -> bool override {
+            return m_implicitValue.has_value();
+        }
 
-    template <typename T>
-    concept IsMultiValueHandleTag =
-        std::is_same_v<T, MultiFlagTag> ||
-        std::is_same_v<T, MultiPositionalTag> ||
-        std::is_same_v<T, MultiChoiceTag>;
+        [[nodiscard]] auto get_input_hint() const -> const std::string& override {
+            return this->m_inputHint;
+        }
 
-    template <typename T>
-    struct is_argument_handle : std::false_type {};
+        [[nodiscard]] auto write_snapshot(detail::SnapshotWriter& out) const -> std::expected<void, std::string> override {
+            if (auto resolved = resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(resolved.error().front().message());
+            }
+            return out.write_values(this->m_valueStorage, this->get_flag());
+        }
 
-    template <typename CommandTag, typename Value, typename Tag>
-    struct is_argument_handle<Handle<CommandTag, Value, Tag>> : std::bool_constant<
-        std::is_same_v<Tag, FlagTag> ||
-        std::is_same_v<Tag, MultiFlagTag> ||
-        std::is_same_v<Tag, PositionalTag> ||
-        std::is_same_v<Tag, MultiPositionalTag> ||
-        std::is_same_v<Tag, ChoiceTag> ||
-        std::is_same_v<Tag, MultiChoiceTag>
-    > {};
+        [[nodiscard]] auto read_snapshot(detail::SnapshotReader& in) -> bool override {
+            return in.read_values(this->m_valueStorage);
+        }
 
-    template <typename T>
-    concept IsArgumentHandle = is_argument_handle<std::remove_cvref_t<T>>::value;
+        [[nodiscard]] auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> override {
+            return resolve_deferred_value();
+        }
 
-    template <typename T>
-    struct command_tag_of {};
+        auto clear_value() -> void override {
+            this->m_valueStorage.clear();
+            m_deferredValues.clear();
+            m_deferredErrors.reset();
+        }
 
-    template <typename CommandTag, typename Value, typename Tag>
-    struct command_tag_of<Handle<CommandTag, Value, Tag>> {
-        using type = CommandTag;
-    };
+        [[nodiscard]] auto has_default() const -> bool override {
+            return this->m_defaultValue.has_value();
+        }
 
-    template <typename T>
-    using command_tag_of_t = typename command_tag_of<std::remove_cvref_t<T>>::type;
+        [[nodiscard]] auto get_description() const -> const std::string& override {
+            return this->m_description;
+        }
+    public:
+        explicit MultiFlag(const std::string_view flag) : MultiFlagBase(flag) {}
 
-} // namespace argon
+        auto with_lazy_conversion() & -> MultiFlag& {
+            this->m_lazyConversion = true;
+            return *this;
+        }
 
+        auto with_lazy_conversion() && -> MultiFlag&& {
+            this->m_lazyConversion = true;
+            return std::move(*this);
+        }
 
+        auto with_alias(std::string_view alias) & -> MultiFlag& {
+            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
+                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+            }
+            this->m_aliases.emplace_back(alias);
+            return *this;
+        }
 
-template <>
-struct std::hash<argon::detail::UniqueId> {
-    auto operator()(const argon::detail::UniqueId& id) const noexcept -> std::size_t {
-        return id.get_id();
-    }
-};
+        auto with_alias(std::string_view alias) && -> MultiFlag&& {
+            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
+                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+            }
+            this->m_aliases.emplace_back(alias);
+            return std::move(*this);
+        }
 
-namespace argon::detail {
-    enum class FlagKind {
-        Flag,
-        MultiFlag,
-        Choice,
-        MultiChoice,
-    };
+        auto with_env(const std::string_view variable) & -> MultiFlag& {
+            this->m_environmentVariable = variable;
+            return *this;
+        }
 
-    struct FlagOrderEntry {
-        FlagKind kind = FlagKind::Flag;
-        UniqueId id = {};
+        auto with_env(const std::string_view variable) && -> MultiFlag&& {
+            this->m_environmentVariable = variable;
+            return std::move(*this);
+        }
+
+        auto with_implicit(std::vector<T> implicitValue) & -> MultiFlag& {
+            m_implicitValue = std::move(implicitValue);
+            return *this;
+        }
+
+        auto with_implicit(std::vector<T> implicitValue) && -> MultiFlag&& {
+            m_implicitValue = std::move(implicitValue);
+            return std::move(*this);
+        }
     };
 
-    class Context {
-        std::unordered_map<UniqueId, Polymorphic<FlagBase>> m_flags;
-        std::unordered_map<UniqueId, Polymorphic<MultiFlagBase>> m_multiFlags;
-        std::unordered_map<UniqueId, Polymorphic<PositionalBase>> m_positionals;
-        std::vector<UniqueId> m_positionalOrder;
-        std::optional<std::pair<UniqueId, Polymorphic<MultiPositionalBase>>> m_multiPositional;
-        std::unordered_map<UniqueId, Polymorphic<ChoiceBase>> m_choices;
-        std::unordered_map<UniqueId, Polymorphic<MultiChoiceBase>> m_multiChoices;
-        std::vector<FlagOrderEntry> m_insertionOrder;
+    template <typename T>
+    class Positional final
+            : public detail::PositionalBase,
+              public detail::SingleValueStorage<Positional<T>, T>,
+              public detail::Converter<Positional<T>, T> ,
+              public detail::ValueValidatorMixin<Positional<T>, T> ,
+              public detail::DescriptionMixin<Positional<T>> {
+        template <typename> friend class Results;
 
-        template <typename T>
-        [[nodiscard]] auto flag_or_alias_exists(const T& flag) const -> std::optional<std::string> {
-            if (const auto flag_str = flag.get_flag(); contains_flag(flag_str) ||
-                                                       contains_multi_flag(flag_str) ||
-                                                       contains_choice(flag_str) ||
-                                                       contains_multi_choice(flag_str)) {
-                return flag.get_flag();
+        mutable std::optional<std::string_view> m_deferredValue;
+        mutable std::optional<Error> m_deferredError;
+
+        auto convert_value(const std::string_view str) const -> std::expected<T, Error> {
+            auto result = this->convert(str);
+            if (!result) {
+                return std::unexpected(Error(ErrorCode::InvalidValue, std::move(result.error()))
+                    .with_option(this->get_name()).with_value(str));
             }
-            for (const auto& alias : flag.get_aliases()) {
-                if (contains_flag(alias) || contains_multi_flag(alias) || contains_choice(alias) || contains_multi_choice(alias)) {
-                    return alias;
-                }
+            if (auto validate = this->apply_value_validator(result.value()); !validate.has_value()) {
+                return std::unexpected(Error(ErrorCode::InvalidValue, std::move(validate.error()))
+                    .with_option(this->get_name()).with_value(str));
             }
-            return std::nullopt;
+            return std::move(result.value());
         }
 
-    public:
-        template <typename T>
-        [[nodiscard]] auto add_flag(Flag<T> flag) -> UniqueId {
-            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
-                throw std::invalid_argument(std::format(
-                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+        auto resolve_deferred_value() const -> std::expected<void, Error> {
+            if (m_deferredError.has_value()) return std::unexpected(m_deferredError.value());
+            if (!m_deferredValue.has_value()) return {};
+
+            auto value = convert_value(m_deferredValue.value());
+            if (!value.has_value()) {
+                m_deferredError = value.error();
+                return std::unexpected(std::move(value.error()));
             }
-            const UniqueId id{};
-            m_flags.emplace(id, detail::make_polymorphic<FlagBase>(std::move(flag)));
-            m_insertionOrder.emplace_back(FlagKind::Flag, id);
-            return id;
+            this->m_valueStorage = std::move(value.value());
+            m_deferredValue.reset();
+            return {};
         }
 
-        template <typename T>
-        [[nodiscard]] auto add_multi_flag(MultiFlag<T> flag) -> UniqueId {
-            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
-                throw std::invalid_argument(std::format(
-                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+        auto set_value(std::optional<const std::string_view> str) -> std::expected<void, Error>  override {
+            if (this->m_defaultValue.has_value()) {
+                auto res = this->apply_value_validator(this->m_defaultValue.value());
+                if (!res) {
+                    throw std::logic_error(std::format(
+                        "Default value for positional '{}' does not meet the validation requirement: {}",
+                        this->get_name(), res.error()));
+                }
             }
-            const UniqueId id{};
-            m_multiFlags.emplace(id, detail::make_polymorphic<MultiFlagBase>(std::move(flag)));
-            m_insertionOrder.emplace_back(FlagKind::MultiFlag, id);
-            return id;
+
+            m_deferredError.reset();
+            if (this->m_lazyConversion) {
+                this->m_valueStorage.reset();
+                m_deferredValue = str.value();
+                return {};
+            }
+
+            auto value = convert_value(str.value());
+            if (!value.has_value()) {
+                return std::unexpected(std::move(value.error()));
+            }
+            this->m_valueStorage = std::move(value.value());
+            return {};
         }
 
-        template <typename T>
-        [[nodiscard]] auto add_positional(Positional<T> positional) -> UniqueId {
-            const UniqueId id{};
-            m_positionalOrder.emplace_back(id);
-            m_positionals.emplace(id, detail::make_polymorphic<PositionalBase>(std::move(positional)));
-            return id;
+        [[nodiscard]] auto is_set() const -> bool override {
+            return this->m_valueStorage.has_value() || m_deferredValue.has_value();
+        }
+
+        [[nodiscard]] auto write_snapshot(detail::SnapshotWriter& out) const -> std::expected<void, std::string> override {
+            if (auto resolved = resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(resolved.error().message());
+            }
+            return out.write_values(this->single_value_span(), this->get_name());
+        }
+
+        [[nodiscard]] auto read_snapshot(detail::SnapshotReader& in) -> bool override {
+            return in.read_single_value(this->m_valueStorage);
         }
 
-        template <typename T>
-        [[nodiscard]] auto add_multi_positional(MultiPositional<T> positional) -> UniqueId {
-            if (contains_multi_positional()) {
-                throw std::logic_error("only one MultiPositional may be specified per context");
+        [[nodiscard]] auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> override {
+            if (auto resolved = resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(std::vector{std::move(resolved.error())});
+            }
+            return {};
+        }
+
+        auto clear_value() -> void override {
+            this->m_valueStorage.reset();
+            m_deferredValue.reset();
+            m_deferredError.reset();
+        }
+
+        [[nodiscard]] auto has_default() const -> bool override {
+            return this->m_defaultValue.has_value();
+        }
+
+        [[nodiscard]] auto get_description() const -> const std::string& override {
+            return this->m_description;
+        }
+
+    public:
+        explicit Positional(const std::string_view name) : PositionalBase(name) {}
+
+        auto with_lazy_conversion() & -> Positional& {
+            this->m_lazyConversion = true;
+            return *this;
+        }
+
+        auto with_lazy_conversion() && -> Positional&& {
+            this->m_lazyConversion = true;
+            return std::move(*this);
+        }
+    };
+
+    template <typename T>
+    class MultiPositional final
+            : public detail::MultiPositionalBase,
+              public detail::VectorValueStorage<MultiPositional<T>, T>,
+              public detail::Converter<MultiPositional<T>, T>,
+              public detail::ValueValidatorMixin<MultiPositional<T>, T>,
+              public detail::GroupValidatorMixin<MultiPositional<T>, T>,
+              public detail::DescriptionMixin<MultiPositional<T>>,
+              public detail::ParallelConversionMixin<MultiPositional<T>> {
+        template <typename> friend class Results;
+        template <typename> friend class detail::ValueStream;
+        friend class detail::Context;
+
+        mutable std::vector<std::string_view> m_deferredValues;
+        mutable std::optional<std::vector<Error>> m_deferredErrors;
+
+        bool m_streaming = false;
+        // Views into the arguments of the parse, which are shared instead of copied since a stream can have millions
+        std::shared_ptr<const std::vector<std::string_view>> m_streamedArgv;
+        std::vector<detail::ArgvRun> m_streamedRuns;
+        size_t m_numStreamed = 0;
+        mutable std::shared_ptr<detail::DescriptorReader> m_streamSource;
+        // Whether the stream source had a value or an error when it was attached, so that checking whether the option
+        // is set never reads from the descriptor
+        bool m_streamSourceHasValues = false;
+
+        [[nodiscard]] auto has_stream_source_values() const -> bool {
+            return m_streamSourceHasValues;
+        }
+
+        [[nodiscard]] auto uses_default_stream() const -> bool {
+            return m_numStreamed == 0 && !has_stream_source_values() && this->m_defaultValue.has_value();
+        }
+
+        // Number of values known without reading from the stream source
+        [[nodiscard]] auto get_stream_size() const -> size_t {
+            if (uses_default_stream()) return this->m_defaultValue->size();
+            return m_numStreamed;
+        }
+
+        [[nodiscard]] auto get_streamed_word(const size_t index) const -> std::string_view {
+            const auto run = std::ranges::upper_bound(m_streamedRuns, index, {}, &detail::ArgvRun::valuesBegin) - 1;
+            return (*m_streamedArgv)[run->argvBegin + (index - run->valuesBegin)];
+        }
+
+        // Next value from the stream source, or its read error. The error is only returned once.
+        [[nodiscard]] auto next_stream_source_value() const -> std::optional<std::expected<std::string_view, std::string>> {
+            if (m_streamSource == nullptr) return std::nullopt;
+            if (auto value = m_streamSource->next()) return value.value();
+            if (!m_streamSource->get_error().empty()) {
+                auto error = std::unexpected(m_streamSource->get_error());
+                m_streamSource.reset();
+                return error;
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] auto get_streamed_value(const size_t index) const -> std::expected<T, std::string> {
+            if (uses_default_stream()) return this->m_defaultValue.value()[index];
+            return convert_streamed_value(get_streamed_word(index));
+        }
+
+        [[nodiscard]] auto convert_streamed_value(const std::string_view value) const -> std::expected<T, std::string> {
+            auto result = this->convert(value);
+            if (!result.has_value()) {
+                return std::unexpected(Error(ErrorCode::InvalidValue, std::move(result.error()))
+                    .with_option(this->get_name()).with_value(value).message());
+            }
+            if (auto validate = this->apply_value_validator(result.value()); !validate.has_value()) {
+                return std::unexpected(Error(ErrorCode::InvalidValue, std::move(validate.error()))
+                    .with_option(this->get_name()).with_value(value).message());
+            }
+            return result;
+        }
+
+        template <typename Range>
+        auto append_values(const Range& values, std::vector<Error>& errors, const size_t maxErrors) const -> void {
+            const auto convertOne = [this](const size_t index, const std::string_view value, std::vector<T>& out,
+                                           std::vector<Error>& errs) {
+                auto result = this->convert(value);
+                if (!result.has_value()) {
+                    errs.emplace_back(Error(ErrorCode::InvalidValue, std::move(result.error()))
+                        .with_option(this->get_name()).with_value(value).with_position(index));
+                    return;
+                }
+
+                if (auto validate = this->apply_value_validator(result.value()); !validate.has_value()) {
+                    errs.emplace_back(Error(ErrorCode::InvalidValue, std::move(validate.error()))
+                        .with_option(this->get_name()).with_value(value).with_position(index));
+                }
+                out.emplace_back(std::move(result.value()));
+            };
+            detail::convert_values(values, this->get_num_threads(std::ranges::size(values)),
+                this->m_valueStorage, errors, maxErrors, convertOne);
+            if (errors.size() >= maxErrors) return;
+
+            if (auto validate = this->apply_group_validator(this->m_valueStorage); !validate.has_value()) {
+                errors.emplace_back(Error(ErrorCode::InvalidValues, std::move(validate.error())).with_option(this->get_name()));
+            }
+        }
+
+        auto resolve_deferred_value() const -> std::expected<void, std::vector<Error>> {
+            if (m_deferredErrors.has_value()) return std::unexpected(m_deferredErrors.value());
+            if (m_deferredValues.empty()) return {};
+
+            std::vector<Error> errors;
+            append_values(m_deferredValues, errors, std::numeric_limits<size_t>::max());
+            m_deferredValues.clear();
+            if (!errors.empty()) {
+                m_deferredErrors = errors;
+                return std::unexpected(std::move(errors));
+            }
+            return {};
+        }
+
+        auto set_value(const std::span<const std::string_view> values, const size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> override {
+            if (this->m_defaultValue.has_value()) {
+                auto res = this->apply_group_validator(this->m_defaultValue.value());
+                if (!res) {
+                    throw std::logic_error(std::format(
+                        "Default value for '{}' does not meet the validation requirement: {}",
+                        this->get_name(), res.error()));
+                }
+            }
+
+            // Values that are not runs of argv, such as those of an incremental parse, are copied into a new one
+            if (m_streaming) {
+                auto argv = std::make_shared<std::vector<std::string_view>>();
+                argv->reserve(m_numStreamed + values.size());
+                for (size_t i = 0; i < m_numStreamed; ++i) argv->push_back(get_streamed_word(i));
+                argv->insert(argv->end(), values.begin(), values.end());
+                m_numStreamed = argv->size();
+                m_streamedRuns = {detail::ArgvRun{.argvBegin = 0, .valuesBegin = 0}};
+                m_streamedArgv = std::move(argv);
+                return {};
+            }
+
+            if (this->m_lazyConversion) {
+                m_deferredValues.insert(m_deferredValues.end(), values.begin(), values.end());
+                return {};
+            }
+
+            std::vector<Error> errors;
+            append_values(values, errors, maxErrors);
+            if (!errors.empty()) {
+                return std::unexpected(std::move(errors));
+            }
+            return {};
+        }
+
+        [[nodiscard]] auto is_set() const -> bool override {
+            return !this->m_valueStorage.empty() || !m_deferredValues.empty() || m_numStreamed != 0
+                || has_stream_source_values();
+        }
+
+        [[nodiscard]] auto is_streamed() const -> bool override {
+            return m_streaming;
+        }
+
+        auto set_streamed_runs(std::shared_ptr<const std::vector<std::string_view>> argv,
+                               std::vector<detail::ArgvRun> runs, const size_t count) -> void override {
+            m_streamedArgv = std::move(argv);
+            m_streamedRuns = std::move(runs);
+            m_numStreamed = count;
+        }
+
+        [[nodiscard]] auto set_stream_source(std::shared_ptr<detail::DescriptorReader> reader) -> bool override {
+            if (!m_streaming) return false;
+            m_streamSourceHasValues = reader->peek().has_value() || !reader->get_error().empty();
+            m_streamSource = std::move(reader);
+            return true;
+        }
+
+        [[nodiscard]] auto write_snapshot(detail::SnapshotWriter& out) const -> std::expected<void, std::string> override {
+            if (m_streaming && is_set()) {
+                return std::unexpected(std::format(
+                    "Streamed multi-positional '{}' cannot be written to a snapshot", this->get_name()));
+            }
+            if (auto resolved = resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(resolved.error().front().message());
+            }
+            return out.write_values(this->m_valueStorage, this->get_name());
+        }
+
+        [[nodiscard]] auto read_snapshot(detail::SnapshotReader& in) -> bool override {
+            if (!m_streaming) return in.read_values(this->m_valueStorage);
+            std::vector<T> values;
+            return in.read_values(values) && values.empty();
+        }
+
+        [[nodiscard]] auto convert_deferred_values() const -> std::expected<void, std::vector<Error>> override {
+            return resolve_deferred_value();
+        }
+
+        auto clear_value() -> void override {
+            this->m_valueStorage.clear();
+            m_deferredValues.clear();
+            m_deferredErrors.reset();
+            m_streamedArgv.reset();
+            m_streamedRuns.clear();
+            m_numStreamed = 0;
+            m_streamSource.reset();
+            m_streamSourceHasValues = false;
+        }
+
+        [[nodiscard]] auto has_default() const -> bool override {
+            return this->m_defaultValue.has_value();
+        }
+
+        [[nodiscard]] auto get_description() const -> const std::string& override {
+            return this->m_description;
+        }
+
+        // Streamed values are never held together, so there is nothing to give a group validator
+        auto validate_streaming() const -> void {
+            if (m_streaming && this->has_group_validators()) {
+                throw std::logic_error(std::format(
+                    "Multi-positional '{}' is streamed and cannot have group validators", this->get_name()));
+            }
+        }
+
+    public:
+        explicit MultiPositional(const std::string_view name) : MultiPositionalBase(name) {}
+
+        auto with_streaming() & -> MultiPositional& {
+            m_streaming = true;
+            validate_streaming();
+            return *this;
+        }
+
+        auto with_streaming() && -> MultiPositional&& {
+            m_streaming = true;
+            validate_streaming();
+            return std::move(*this);
+        }
+
+        auto with_lazy_conversion() & -> MultiPositional& {
+            this->m_lazyConversion = true;
+            return *this;
+        }
+
+        auto with_lazy_conversion() && -> MultiPositional&& {
+            this->m_lazyConversion = true;
+            return std::move(*this);
+        }
+    };
+
+    template <typename T>
+    class Choice final
+            : public detail::ChoiceBase,
+              public detail::SingleValueStorage<Choice<T>, T>,
+              public detail::DescriptionMixin<Choice<T>> {
+        detail::ChoiceMap<T> m_choices;
+        std::optional<T> m_implicitValue;
+
+        auto set_value(std::optional<const std::string_view> str) -> std::expected<void, Error> override {
+            if (str == std::nullopt) {
+                if (!is_implicit_set()) {
+                    return std::unexpected(Error(ErrorCode::MissingValue).with_option(this->get_flag()));
+                }
+                this->m_valueStorage = m_implicitValue;
+                return {};
+            }
+
+            const auto choice = m_choices.find(str.value());
+            if (!choice.has_value()) {
+                return std::unexpected(Error(ErrorCode::InvalidChoice).with_candidates(m_choices.get_shared_names())
+                    .with_option(this->get_flag()).with_value(str.value()));
+            }
+            this->m_valueStorage = choice.value();
+            return {};
+        }
+
+        [[nodiscard]] auto is_set() const -> bool override {
+            return this->m_valueStorage.has_value();
+        }
+
+        [[nodiscard]] auto is_implicit_set() const -> bool override {
+            return m_implicitValue.has_value();
+        }
+
+        [[nodiscard]] auto get_choices() const -> std::vector<std::string> override {
+            return m_choices.get_names();
+        }
+
+        [[nodiscard]] auto write_snapshot(detail::SnapshotWriter& out) const -> std::expected<void, std::string> override {
+            return out.write_values(this->single_value_span(), this->get_flag());
+        }
+
+        [[nodiscard]] auto read_snapshot(detail::SnapshotReader& in) -> bool override {
+            return in.read_single_value(this->m_valueStorage, [this](const auto& value) {
+                return m_choices.contains(value) || m_implicitValue == value;
+            });
+        }
+
+        auto clear_value() -> void override {
+            this->m_valueStorage.reset();
+        }
+
+        [[nodiscard]] auto has_default() const -> bool override {
+            return this->m_defaultValue.has_value();
+        }
+
+        [[nodiscard]] auto get_description() const -> const std::string& override {
+            return this->m_description;
+        }
+
+    public:
+        Choice(const std::string_view flag, std::vector<std::pair<std::string, T>> choices)
+            : ChoiceBase(flag), m_choices(std::move(choices)) {
+            if (m_choices.empty()) {
+                throw std::invalid_argument(std::format("Choices map must not be empty for flag '{}'", this->get_flag()));
+            }
+        }
+
+        explicit Choice(const std::string_view flag) requires std::is_scoped_enum_v<T>
+            : ChoiceBase(flag), m_choices(detail::ChoiceMap<T>::from_enum()) {}
+
+        auto with_alias(std::string_view alias) & -> Choice& {
+            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
+                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+            }
+            this->m_aliases.emplace_back(alias);
+            return *this;
+        }
+
+        auto with_alias(std::string_view alias) && -> Choice&& {
+            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
+                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+            }
+            this->m_aliases.emplace_back(alias);
+            return std::move(*this);
+        }
+
+        auto with_env(const std::string_view variable) & -> Choice& {
+            this->m_environmentVariable = variable;
+            return *this;
+        }
+
+        auto with_env(const std::string_view variable) && -> Choice&& {
+            this->m_environmentVariable = variable;
+            return std::move(*this);
+        }
+
+        auto with_implicit(T implicitValue) & -> Choice& {
+            m_implicitValue = std::move(implicitValue);
+            return *this;
+        }
+
+        auto with_implicit(T implicitValue) && -> Choice&& {
+            m_implicitValue = std::move(implicitValue);
+            return std::move(*this);
+        }
+    };
+
+    template <typename T>
+    class MultiChoice final
+            : public detail::MultiChoiceBase,
+              public detail::VectorValueStorage<MultiChoice<T>, T>,
+              public detail::GroupValidatorMixin<MultiChoice<T>, T>,
+              public detail::DescriptionMixin<MultiChoice<T>> {
+        detail::ChoiceMap<T> m_choices;
+        std::optional<std::vector<T>> m_implicitValue;
+
+        auto set_value(const std::span<const std::string_view> values, const size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> override {
+            if (this->m_defaultValue.has_value()) {
+                auto res = this->apply_group_validator(this->m_defaultValue.value());
+                if (!res) {
+                    throw std::logic_error(std::format(
+                        "Default value for flag '{}' does not meet the validation requirement: {}",
+                        this->get_flag(), res.error()));
+                }
+            }
+            if (this->m_implicitValue.has_value()) {
+                auto res = this->apply_group_validator(this->m_implicitValue.value());
+                if (!res) {
+                    throw std::logic_error(std::format(
+                        "Implicit value for flag '{}' does not meet the validation requirement: {}",
+                        this->get_flag(), res.error()));
+                }
+            }
+
+            if (values.empty()) {
+                if (!is_implicit_set()) {
+                    return std::unexpected(std::vector{Error(ErrorCode::MissingValue).with_option(this->get_flag())});
+                }
+                this->m_valueStorage = m_implicitValue.value();
+                return {};
+            }
+
+            std::vector<Error> errors;
+            for (size_t i = 0; i < values.size() && errors.size() < maxErrors; i++) {
+                const auto choice = m_choices.find(values[i]);
+                if (!choice.has_value()) {
+                    errors.emplace_back(Error(ErrorCode::InvalidChoice).with_candidates(m_choices.get_shared_names())
+                        .with_option(this->get_flag()).with_value(values[i]).with_position(i));
+                    continue;
+                }
+                this->m_valueStorage.emplace_back(choice.value());
+            }
+
+            if (errors.size() < maxErrors) {
+                if (auto validate = this->apply_group_validator(this->m_valueStorage); !validate.has_value()) {
+                    errors.emplace_back(Error(ErrorCode::InvalidValues, std::move(validate.error()))
+                        .with_option(this->get_flag()));
+                }
+            }
+
+            if (!errors.empty()) {
+                return std::unexpected(std::move(errors));
+            }
+            return {};
+        }
+
+        [[nodiscard]] auto is_set() const -> bool override {
+            return !this->m_valueStorage.empty();
+        }
+
+        [[nodiscard]] auto is_implicit_set() const -> bool override {
+            return m_implicitValue.has_value();
+        }
+
+        [[nodiscard]] auto get_choices() const -> std::vector<std::string> override {
+            return m_choices.get_names();
+        }
+
+        [[nodiscard]] auto write_snapshot(detail::SnapshotWriter& out) const -> std::expected<void, std::string> override {
+            return out.write_values(this->m_valueStorage, this->get_flag());
+        }
+
+        [[nodiscard]] auto read_snapshot(detail::SnapshotReader& in) -> bool override {
+            return in.read_values(this->m_valueStorage, [this](const auto& value) {
+                return m_choices.contains(value)
+                    || (m_implicitValue.has_value() && std::ranges::contains(m_implicitValue.value(), value));
+            });
+        }
+
+        auto clear_value() -> void override {
+            this->m_valueStorage.clear();
+        }
+
+        [[nodiscard]] auto has_default() const -> bool override {
+            return this->m_defaultValue.has_value();
+        }
+
+        [[nodiscard]] auto get_description() const -> const std::string& override {
+            return this->m_description;
+        }
+
+    public:
+        MultiChoice(const std::string_view flag, std::vector<std::pair<std::string, T>> choices)
+            : MultiChoiceBase(flag), m_choices(std::move(choices)) {
+            if (m_choices.empty()) {
+                throw std::invalid_argument(std::format("Choices map must not be empty for flag '{}'", this->get_flag()));
+            }
+        }
+
+        explicit MultiChoice(const std::string_view flag) requires std::is_scoped_enum_v<T>
+            : MultiChoiceBase(flag), m_choices(detail::ChoiceMap<T>::from_enum()) {}
+
+
+        auto with_alias(std::string_view alias) & -> MultiChoice& {
+            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
+                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+            }
+            this->m_aliases.emplace_back(alias);
+            return *this;
+        }
+
+        auto with_alias(std::string_view alias) && -> MultiChoice&& {
+            if (this->m_flag == alias || std::ranges::contains(this->m_aliases, alias)) {
+                throw std::invalid_argument(std::format("Unable to add alias: flag/alias '{}' already exists", alias));
+            }
+            this->m_aliases.emplace_back(alias);
+            return std::move(*this);
+        }
+
+        auto with_implicit(std::vector<T> implicitValue) & -> MultiChoice& {
+            m_implicitValue = std::move(implicitValue);
+            return *this;
+        }
+
+        auto with_implicit(std::vector<T> implicitValue) && -> MultiChoice&& {
+            m_implicitValue = std::move(implicitValue);
+            return std::move(*this);
+        }
+    };
+ } // namespace argon::detail
+
+
+namespace argon::detail {
+    // Input range over the values of a streamed multi-positional. Each value is converted and validated when the
+    // iterator is dereferenced, so only views into argv are kept rather than a vector of converted values. Values from
+    // a file descriptor source are read while iterating, so they can only be iterated once.
+    template <typename T>
+    class ValueStream {
+        const MultiPositional<T> *m_source;
+
+    public:
+        class Iterator {
+            const MultiPositional<T> *m_source = nullptr;
+            size_t m_index = 0;
+            size_t m_size = 0;
+            // A value read from the descriptor source. Its view is only valid until the source is read again.
+            std::optional<std::expected<std::string_view, std::string>> m_sourceValue;
+
+            auto read_source_value() -> void {
+                if (m_index >= m_size) m_sourceValue = m_source->next_stream_source_value();
+            }
+
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::expected<T, std::string>;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(const MultiPositional<T> *source)
+                : m_source(source), m_size(source->get_stream_size()) {
+                read_source_value();
+            }
+
+            auto operator*() const -> value_type {
+                if (m_index < m_size) return m_source->get_streamed_value(m_index);
+                if (!m_sourceValue->has_value()) return std::unexpected(m_sourceValue->error());
+                return m_source->convert_streamed_value(m_sourceValue->value());
+            }
+
+            auto operator++() -> Iterator& {
+                if (m_index < m_size) ++m_index;
+                read_source_value();
+                return *this;
+            }
+
+            auto operator++(int) -> void {
+                ++*this;
+            }
+
+            auto operator==(std::default_sentinel_t) const -> bool {
+                return m_index >= m_size && !m_sourceValue.has_value();
+            }
+        };
+
+        explicit ValueStream(const MultiPositional<T> *source) : m_source(source) {}
+
+        [[nodiscard]] auto begin() const -> Iterator { return Iterator{m_source}; }
+        [[nodiscard]] auto end() const -> std::default_sentinel_t { return std::default_sentinel; }
+        [[nodiscard]] auto empty() const -> bool {
+            return m_source->get_stream_size() == 0 && !m_source->has_stream_source_values();
+        }
+    };
+} // namespace argon::detail
+
+
+namespace argon::detail {
+    class UniqueId {
+        size_t m_id;
+
+        static auto next() -> size_t {
+            return counter()->fetch_add(1, std::memory_order_relaxed);
+        }
+    public:
+        // Each shared object has its own copy of this counter, so plugins point theirs at the one of the program
+        // loading them to keep ids unique
+        static auto counter() -> std::atomic<size_t> *& {
+            static std::atomic<size_t> local{0};
+            static std::atomic<size_t> *current = &local;
+            return current;
+        }
+
+        UniqueId() : m_id(next()) {}
+        [[nodiscard]] auto get_id() const -> size_t { return m_id; }
+        auto operator<=>(const UniqueId&) const = default;
+    };
+} // namespace argon::detail
+
+
+namespace argon {
+    template <typename CommandTag, typename ValueType, typename HandleTag>
+    class Handle {
+        // ReSharper disable CppDFANotInitializedField
+        detail::UniqueId m_id;
+        // ReSharper restore CppDFANotInitializedField
+
+    public:
+        Handle() = delete;
+        explicit Handle(const detail::UniqueId& id) : m_id(id) {}
+
+        [[nodiscard]] auto get_id() const -> detail::UniqueId {
+            return m_id;
+        }
+    };
+
+    template <typename CommandTag, typename ValueType> using FlagHandle            = Handle<CommandTag, ValueType, struct FlagTag>;
+    template <typename CommandTag, typename ValueType> using MultiFlagHandle       = Handle<CommandTag, ValueType, struct MultiFlagTag>;
+    template <typename CommandTag, typename ValueType> using PositionalHandle      = Handle<CommandTag, ValueType, struct PositionalTag>;
+    template <typename CommandTag, typename ValueType> using MultiPositionalHandle = Handle<CommandTag, ValueType, struct MultiPositionalTag>;
+    template <typename CommandTag, typename ValueType> using ChoiceHandle          = Handle<CommandTag, ValueType, struct ChoiceTag>;
+    template <typename CommandTag, typename ValueType> using MultiChoiceHandle     = Handle<CommandTag, ValueType, struct MultiChoiceTag>;
+    template <typename CommandTag> using CommandHandle = Handle<CommandTag, void, struct SubcommandTag>;
+    using AnyCommandHandle = Handle<struct AnyCommandTag, void, struct AnyCommandTag>;
+
+    template <typename T>
+    concept IsSingleValueHandleTag =
+        std::is_same_v<T, FlagTag> ||
+        std::is_same_v<T, PositionalTag> ||
+        std::is_same_v<T, ChoiceTag>;
+
+    template <typename T>
+    concept IsMultiValueHandleTag =
+        std::is_same_v<T, MultiFlagTag> ||
+        std::is_same_v<T, MultiPositionalTag> ||
+        std::is_same_v<T, MultiChoiceTag>;
+
+    template <typename T>
+    struct is_argument_handle : std::false_type {};
+
+    template <typename CommandTag, typename Value, typename Tag>
+    struct is_argument_handle<Handle<CommandTag, Value, Tag>> : std::bool_constant<
+        std::is_same_v<Tag, FlagTag> ||
+        std::is_same_v<Tag, MultiFlagTag> ||
+        std::is_same_v<Tag, PositionalTag> ||
+        std::is_same_v<Tag, MultiPositionalTag> ||
+        std::is_same_v<Tag, ChoiceTag> ||
+        std::is_same_v<Tag, MultiChoiceTag>
+    > {};
+
+    template <typename T>
+    concept IsArgumentHandle = is_argument_handle<std::remove_cvref_t<T>>::value;
+
+    template <typename T>
+    struct is_command_handle : std::false_type {};
+
+    template <typename CommandTag, typename Tag>
+    struct is_command_handle<Handle<CommandTag, void, Tag>> : std::bool_constant<
+        std::is_same_v<Tag, SubcommandTag> ||
+        std::is_same_v<Tag, AnyCommandTag>
+    > {};
+
+    template <typename T>
+    concept IsCommandHandle = is_command_handle<std::remove_cvref_t<T>>::value;
+
+    template <typename T>
+    struct command_tag_of {};
+
+    template <typename CommandTag, typename Value, typename Tag>
+    struct command_tag_of<Handle<CommandTag, Value, Tag>> {
+        using type = CommandTag;
+    };
+
+    template <typename T>
+    using command_tag_of_t = typename command_tag_of<std::remove_cvref_t<T>>::type;
+
+} // namespace argon
+
+
+
+template <>
+struct std::hash<argon::detail::UniqueId> {
+    auto operator()(const argon::detail::UniqueId& id) const noexcept -> std::size_t {
+        return id.get_id();
+    }
+};
+
+namespace argon {
+    enum class ValueSource {
+        None,
+        Default,
+        ConfigFile,
+        Environment,
+        CommandLine,
+    };
+} // namespace argon
+
+
+namespace argon::detail {
+    // Compressed prefix trie over names, used to resolve abbreviations. Each edge holds the characters shared by every
+    // name below it, so a lookup compares each character of the prefix once, and a subtree holding a single name is a
+    // single node.
+    class RadixTrie {
+        struct Node {
+            std::string label;
+            std::optional<std::string> word;
+            size_t count = 0;
+            std::vector<Node> children;
+        };
+
+        Node m_root;
+
+        [[nodiscard]] static auto find_child(const Node& node, const char c) -> size_t {
+            const auto it = std::ranges::find_if(node.children, [c](const Node& child) { return child.label[0] == c; });
+            return static_cast<size_t>(it - node.children.begin());
+        }
+
+        static auto collect(const Node& node, std::vector<std::string_view>& out) -> void {
+            if (node.word.has_value()) out.emplace_back(node.word.value());
+            for (const Node& child : node.children) {
+                collect(child, out);
+            }
+        }
+
+    public:
+        auto insert(const std::string_view word) -> void {
+            if (const auto found = find_prefix(word); found.size() == 1 && found.front() == word) return;
+
+            Node *node = &m_root;
+            std::string_view rest = word;
+            node->count++;
+            while (!rest.empty()) {
+                const size_t index = find_child(*node, rest[0]);
+                if (index == node->children.size()) {
+                    node->children.push_back(Node{.label = std::string(rest), .word = std::string(word), .count = 1});
+                    return;
+                }
+
+                Node& child = node->children[index];
+                const size_t common = static_cast<size_t>(std::ranges::mismatch(child.label, rest).in1 - child.label.begin());
+                if (common < child.label.size()) {
+                    Node tail = std::move(child);
+                    tail.label.erase(0, common);
+                    child = Node{.label = std::string(rest.substr(0, common)), .count = tail.count};
+                    child.children.push_back(std::move(tail));
+                }
+                child.count++;
+                node = &child;
+                rest.remove_prefix(common);
+            }
+            node->word = std::string(word);
+        }
+
+        // Names that start with prefix, in lexicographic order, or only prefix if it is a name itself
+        [[nodiscard]] auto find_prefix(const std::string_view prefix) const -> std::vector<std::string_view> {
+            const Node *node = &m_root;
+            std::string_view rest = prefix;
+            while (!rest.empty()) {
+                const size_t index = find_child(*node, rest[0]);
+                if (index == node->children.size()) return {};
+                const Node& child = node->children[index];
+                const size_t common = static_cast<size_t>(std::ranges::mismatch(child.label, rest).in1 - child.label.begin());
+                if (common < std::min(child.label.size(), rest.size())) return {};
+                node = &child;
+                rest.remove_prefix(std::min(common, rest.size()));
+            }
+
+            if (node->word == prefix) return {node->word.value()};
+            std::vector<std::string_view> names;
+            names.reserve(node->count);
+            collect(*node, names);
+            std::ranges::sort(names);
+            return names;
+        }
+    };
+
+    enum class FlagKind {
+        Flag,
+        MultiFlag,
+        Choice,
+        MultiChoice,
+    };
+
+    struct FlagOrderEntry {
+        FlagKind kind = FlagKind::Flag;
+        UniqueId id = {};
+    };
+
+    // Options handled by the Cli instead of being parsed, which a command enables with enable_help or enable_version
+    enum class BuiltinFlag {
+        Help,
+        Version,
+    };
+
+    enum class SnapshotOptionKind : uint8_t {
+        Flag,
+        MultiFlag,
+        Positional,
+        MultiPositional,
+        Choice,
+        MultiChoice,
+    };
+
+    class Context {
+        std::unordered_map<UniqueId, Polymorphic<FlagBase>> m_flags;
+        std::unordered_map<UniqueId, Polymorphic<MultiFlagBase>> m_multiFlags;
+        std::unordered_map<UniqueId, Polymorphic<PositionalBase>> m_positionals;
+        std::vector<UniqueId> m_positionalOrder;
+        std::optional<std::pair<UniqueId, Polymorphic<MultiPositionalBase>>> m_multiPositional;
+        std::unordered_map<UniqueId, Polymorphic<ChoiceBase>> m_choices;
+        std::unordered_map<UniqueId, Polymorphic<MultiChoiceBase>> m_multiChoices;
+        std::vector<FlagOrderEntry> m_insertionOrder;
+        bool m_lazyConversion = false;
+        std::optional<RadixTrie> m_abbreviations;
+        std::unordered_map<UniqueId, ValueSource> m_valueSources;
+        std::vector<std::string> m_helpFlags;
+        std::vector<std::string> m_versionFlags;
+        // Names and aliases of the flags and choices, shared with the errors of unknown flags that suggest them
+        std::shared_ptr<std::vector<std::string>> m_optionNames = std::make_shared<std::vector<std::string>>();
+
+        template <typename Options>
+        auto record_sources_of(const Options& options, const ValueSource source) -> void {
+            for (const auto& [id, option] : options) {
+                if (option->is_set()) m_valueSources.try_emplace(id, source);
+            }
+        }
+
+        template <typename T>
+        auto add_abbreviations(const T& flag) -> void {
+            if (!m_abbreviations.has_value()) return;
+            if (flag.get_flag().starts_with("--")) m_abbreviations->insert(flag.get_flag());
+            for (const auto& alias : flag.get_aliases()) {
+                if (alias.starts_with("--")) m_abbreviations->insert(alias);
+            }
+        }
+
+        // Errors that still hold the names keep the ones they were checked against, so those are copied first
+        template <typename T>
+        auto add_option_names(const T& flag) -> void {
+            if (m_optionNames.use_count() > 1) m_optionNames = std::make_shared<std::vector<std::string>>(*m_optionNames);
+            m_optionNames->push_back(flag.get_flag());
+            m_optionNames->insert(m_optionNames->end(), flag.get_aliases().begin(), flag.get_aliases().end());
+        }
+
+        [[nodiscard]] auto contains_name(const std::string_view name) const -> bool {
+            return contains_flag(name) || contains_multi_flag(name) || contains_choice(name)
+                || contains_multi_choice(name) || find_builtin_flag(name).has_value();
+        }
+
+        template <typename T>
+        [[nodiscard]] auto flag_or_alias_exists(const T& flag) const -> std::optional<std::string> {
+            if (contains_name(flag.get_flag())) {
+                return flag.get_flag();
+            }
+            for (const auto& alias : flag.get_aliases()) {
+                if (contains_name(alias)) {
+                    return alias;
+                }
+            }
+            return std::nullopt;
+        }
+
+        auto set_builtin_flags(std::vector<std::string>& builtinFlags, std::vector<std::string> names) -> void {
+            if (names.empty()) throw std::invalid_argument("Built-in option must have at least one name");
+            builtinFlags.clear();
+            for (const auto& name : names) {
+                validate_flag(name);
+                if (contains_name(name)) {
+                    throw std::invalid_argument(std::format(
+                        "Unable to add flag/alias: flag/alias '{}' already exists", name));
+                }
+            }
+            builtinFlags = std::move(names);
+        }
+
+    public:
+        template <typename T>
+        [[nodiscard]] auto add_flag(Flag<T> flag) -> UniqueId {
+            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
+                throw std::invalid_argument(std::format(
+                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+            }
+            flag.m_lazyConversion |= m_lazyConversion;
+            const UniqueId id{};
+            add_abbreviations(flag);
+            add_option_names(flag);
+            m_flags.emplace(id, detail::make_polymorphic<FlagBase>(std::move(flag)));
+            m_insertionOrder.emplace_back(FlagKind::Flag, id);
+            return id;
+        }
+
+        template <typename T>
+        [[nodiscard]] auto add_multi_flag(MultiFlag<T> flag) -> UniqueId {
+            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
+                throw std::invalid_argument(std::format(
+                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+            }
+            flag.m_lazyConversion |= m_lazyConversion;
+            const UniqueId id{};
+            add_abbreviations(flag);
+            add_option_names(flag);
+            m_multiFlags.emplace(id, detail::make_polymorphic<MultiFlagBase>(std::move(flag)));
+            m_insertionOrder.emplace_back(FlagKind::MultiFlag, id);
+            return id;
+        }
+
+        template <typename T>
+        [[nodiscard]] auto add_positional(Positional<T> positional) -> UniqueId {
+            positional.m_lazyConversion |= m_lazyConversion;
+            const UniqueId id{};
+            m_positionalOrder.emplace_back(id);
+            m_positionals.emplace(id, detail::make_polymorphic<PositionalBase>(std::move(positional)));
+            return id;
+        }
+
+        template <typename T>
+        [[nodiscard]] auto add_multi_positional(MultiPositional<T> positional) -> UniqueId {
+            if (contains_multi_positional()) {
+                throw std::logic_error("only one MultiPositional may be specified per context");
+            }
+            positional.validate_streaming();
+
+            positional.m_lazyConversion |= m_lazyConversion;
+            const UniqueId id{};
+            m_multiPositional = std::pair{
+                id, detail::make_polymorphic<MultiPositionalBase>(std::move(positional))
+            };
+            return id;
+        }
+
+        template <typename T>
+        [[nodiscard]] auto add_choice(Choice<T> flag) -> UniqueId {
+            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
+                throw std::invalid_argument(std::format(
+                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+            }
+            const UniqueId id{};
+            add_abbreviations(flag);
+            add_option_names(flag);
+            m_choices.emplace(id, detail::make_polymorphic<ChoiceBase>(std::move(flag)));
+            m_insertionOrder.emplace_back(FlagKind::Choice, id);
+            return id;
+        }
+
+        template <typename T>
+        [[nodiscard]] auto add_multi_choice(MultiChoice<T> flag) -> UniqueId {
+            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
+                throw std::invalid_argument(std::format(
+                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+            }
+            const UniqueId id{};
+            add_abbreviations(flag);
+            add_option_names(flag);
+            m_multiChoices.emplace(id, detail::make_polymorphic<MultiChoiceBase>(std::move(flag)));
+            m_insertionOrder.emplace_back(FlagKind::MultiChoice, id);
+            return id;
+        }
+
+        [[nodiscard]] auto get_option_names() const -> std::shared_ptr<const std::vector<std::string>> {
+            return m_optionNames;
+        }
+
+        auto enable_lazy_conversion() -> void {
+            m_lazyConversion = true;
+            for (auto& flag : m_flags | std::views::values) flag->m_lazyConversion = true;
+            for (auto& flag : m_multiFlags | std::views::values) flag->m_lazyConversion = true;
+            for (auto& positional : m_positionals | std::views::values) positional->m_lazyConversion = true;
+            if (m_multiPositional.has_value()) m_multiPositional->second->m_lazyConversion = true;
+        }
+
+        // Lets long options be given by any prefix that matches only one of their names, such as '--verb' for '--verbose'
+        auto enable_abbreviations() -> void {
+            if (m_abbreviations.has_value()) return;
+            m_abbreviations.emplace();
+            for (const auto& flag : m_flags | std::views::values) add_abbreviations(*flag);
+            for (const auto& flag : m_multiFlags | std::views::values) add_abbreviations(*flag);
+            for (const auto& choice : m_choices | std::views::values) add_abbreviations(*choice);
+            for (const auto& choice : m_multiChoices | std::views::values) add_abbreviations(*choice);
+        }
+
+        auto enable_help_flags(std::vector<std::string> names) -> void {
+            set_builtin_flags(m_helpFlags, std::move(names));
+        }
+
+        auto enable_version_flags(std::vector<std::string> names) -> void {
+            set_builtin_flags(m_versionFlags, std::move(names));
+        }
+
+        [[nodiscard]] auto has_builtin_flags() const -> bool {
+            return !m_helpFlags.empty() || !m_versionFlags.empty();
+        }
+
+        [[nodiscard]] auto get_help_flags() const -> const std::vector<std::string>& { return m_helpFlags; }
+        [[nodiscard]] auto get_version_flags() const -> const std::vector<std::string>& { return m_versionFlags; }
+
+        [[nodiscard]] auto find_builtin_flag(const std::string_view name) const -> std::optional<BuiltinFlag> {
+            if (std::ranges::contains(m_helpFlags, name)) return BuiltinFlag::Help;
+            if (std::ranges::contains(m_versionFlags, name)) return BuiltinFlag::Version;
+            return std::nullopt;
+        }
+
+        // Long option names that start with name, or only name if it is one. Empty if abbreviations are not enabled.
+        [[nodiscard]] auto find_abbreviation(const std::string_view name) const -> std::vector<std::string_view> {
+            if (!m_abbreviations.has_value() || !name.starts_with("--") || name.size() <= 2) return {};
+            return m_abbreviations->find_prefix(name);
+        }
+
+        [[nodiscard]] auto contains_flag(const std::string_view flagName) const -> bool {
+            return get_flag(flagName) != nullptr;
+        }
+
+        [[nodiscard]] auto contains_multi_flag(const std::string_view flagName) const -> bool {
+            return get_multi_flag(flagName) != nullptr;
+        }
+
+        [[nodiscard]] auto contains_multi_positional() const -> bool {
+            return m_multiPositional.has_value();
+        }
+
+        [[nodiscard]] auto contains_choice(const std::string_view flagName) const -> bool {
+            return get_choice(flagName) != nullptr;
+        }
+
+        [[nodiscard]] auto contains_multi_choice(const std::string_view flagName) const -> bool {
+            return get_multi_choice(flagName) != nullptr;
+        }
+
+        [[nodiscard]] auto get_flag(const std::string_view flagName) -> FlagBase * {
+            const auto it = std::ranges::find_if(m_flags, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_flags.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_flag(const std::string_view flagName) const -> const FlagBase * {
+            const auto it = std::ranges::find_if(m_flags, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_flags.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_flags() const -> const std::unordered_map<UniqueId, Polymorphic<FlagBase>>& {
+            return m_flags;
+        }
+
+        [[nodiscard]] auto get_multi_flag(const std::string_view flagName) -> MultiFlagBase * {
+            const auto it = std::ranges::find_if(m_multiFlags, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_multiFlags.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_multi_flag(const std::string_view flagName) const -> const MultiFlagBase * {
+            const auto it = std::ranges::find_if(m_multiFlags, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_multiFlags.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_multi_flags() const -> const std::unordered_map<UniqueId, Polymorphic<MultiFlagBase>>& {
+            return m_multiFlags;
+        }
+
+        [[nodiscard]] auto get_positional(const size_t index) -> PositionalBase * {
+            if (index >= m_positionalOrder.size()) return nullptr;
+            return m_positionals.at(m_positionalOrder[index]).get();
+        }
+
+        [[nodiscard]] auto get_positional(const size_t index) const -> const PositionalBase * {
+            if (index >= m_positionalOrder.size()) return nullptr;
+            return m_positionals.at(m_positionalOrder[index]).get();
+        }
+
+        [[nodiscard]] auto get_positional_id(const size_t index) const -> const UniqueId& {
+            return m_positionalOrder.at(index);
+        }
+
+        [[nodiscard]] auto get_num_positionals() const -> size_t {
+            return m_positionals.size();
+        }
+
+        [[nodiscard]] auto get_positionals() const -> const std::unordered_map<UniqueId, Polymorphic<PositionalBase>>& {
+            return m_positionals;
+        }
+
+        [[nodiscard]] auto get_multi_positional_with_id() const
+            -> const std::optional<std::pair<UniqueId, Polymorphic<MultiPositionalBase>>>& {
+            return m_multiPositional;
+        }
+
+        [[nodiscard]] auto get_multi_positional_ptr() -> MultiPositionalBase * {
+            if (!contains_multi_positional()) return nullptr;
+            return m_multiPositional->second.get();
+        }
+
+        [[nodiscard]] auto get_multi_positional_ptr() const -> const MultiPositionalBase * {
+            if (!contains_multi_positional()) return nullptr;
+            return m_multiPositional->second.get();
+        }
+
+        [[nodiscard]] auto get_choice(const std::string_view flagName) -> ChoiceBase * {
+            const auto it = std::ranges::find_if(m_choices, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_choices.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_choice(const std::string_view flagName) const -> const ChoiceBase * {
+            const auto it = std::ranges::find_if(m_choices, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_choices.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_choices() const -> const std::unordered_map<UniqueId, Polymorphic<ChoiceBase>>& {
+            return m_choices;
+        }
+
+        [[nodiscard]] auto get_multi_choice(const std::string_view flagName) -> MultiChoiceBase * {
+            const auto it = std::ranges::find_if(m_multiChoices, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_multiChoices.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_multi_choice(const std::string_view flagName) const -> const MultiChoiceBase * {
+            const auto it = std::ranges::find_if(m_multiChoices, [&](auto&& pair) -> bool {
+                const auto& flag = pair.second;
+                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+            });
+            if (it == m_multiChoices.end()) return nullptr;
+            return it->second.get();
+        }
+
+        [[nodiscard]] auto get_multi_choices() const -> const std::unordered_map<UniqueId, Polymorphic<MultiChoiceBase>>& {
+            return m_multiChoices;
+        }
+
+        [[nodiscard]] auto get_insertion_order() const -> const std::vector<FlagOrderEntry>& {
+            return m_insertionOrder;
+        }
+
+        // Named options in the order they were added
+        [[nodiscard]] auto describe_options() const -> std::vector<OptionInfo> {
+            const auto describe = [](const OptionKind kind, const auto& option, std::vector<std::string> choices) {
+                return OptionInfo{
+                    .kind = kind,
+                    .flag = option->get_flag(),
+                    .aliases = option->get_aliases(),
+                    .hasImplicit = option->is_implicit_set(),
+                    .choices = std::move(choices),
+                };
+            };
+
+            std::vector<OptionInfo> options;
+            options.reserve(m_insertionOrder.size());
+            for (const auto& [kind, id] : m_insertionOrder) {
+                switch (kind) {
+                    case FlagKind::Flag:
+                        options.push_back(describe(OptionKind::Flag, m_flags.at(id), {}));
+                        break;
+                    case FlagKind::MultiFlag:
+                        options.push_back(describe(OptionKind::MultiFlag, m_multiFlags.at(id), {}));
+                        break;
+                    case FlagKind::Choice: {
+                        const auto& choice = m_choices.at(id);
+                        options.push_back(describe(OptionKind::Choice, choice, choice->get_choices()));
+                        break;
+                    }
+                    case FlagKind::MultiChoice: {
+                        const auto& choice = m_multiChoices.at(id);
+                        options.push_back(describe(OptionKind::MultiChoice, choice, choice->get_choices()));
+                        break;
+                    }
+                }
+            }
+            for (const auto *builtinFlags : {&m_helpFlags, &m_versionFlags}) {
+                if (builtinFlags->empty()) continue;
+                options.push_back(OptionInfo{
+                    .kind = OptionKind::Flag,
+                    .flag = builtinFlags->front(),
+                    .aliases = {builtinFlags->begin() + 1, builtinFlags->end()},
+                    .hasImplicit = true,
+                    .choices = {},
+                });
+            }
+            return options;
+        }
+
+        [[nodiscard]] auto find_named_option(const std::string_view name) const -> std::optional<FlagOrderEntry> {
+            const auto matches = [name](const auto& pair) {
+                return pair.second->get_flag() == name || std::ranges::contains(pair.second->get_aliases(), name);
+            };
+            if (const auto it = std::ranges::find_if(m_flags, matches); it != m_flags.end())
+                return FlagOrderEntry{FlagKind::Flag, it->first};
+            if (const auto it = std::ranges::find_if(m_multiFlags, matches); it != m_multiFlags.end())
+                return FlagOrderEntry{FlagKind::MultiFlag, it->first};
+            if (const auto it = std::ranges::find_if(m_choices, matches); it != m_choices.end())
+                return FlagOrderEntry{FlagKind::Choice, it->first};
+            if (const auto it = std::ranges::find_if(m_multiChoices, matches); it != m_multiChoices.end())
+                return FlagOrderEntry{FlagKind::MultiChoice, it->first};
+            return std::nullopt;
+        }
+
+        [[nodiscard]] auto is_option_set(const FlagOrderEntry& option) const -> bool {
+            switch (option.kind) {
+                case FlagKind::Flag:        return m_flags.at(option.id)->is_set();
+                case FlagKind::MultiFlag:   return m_multiFlags.at(option.id)->is_set();
+                case FlagKind::Choice:      return m_choices.at(option.id)->is_set();
+                case FlagKind::MultiChoice: return m_multiChoices.at(option.id)->is_set();
+            }
+            return false;
+        }
+
+        // Sets the values of a named option from a source other than argv. Single value options take the last value,
+        // and an empty value uses the implicit value.
+        [[nodiscard]] auto set_option_values(
+            const FlagOrderEntry& option,
+            const std::span<const std::string_view> values,
+            const size_t maxErrors
+        ) -> std::expected<void, std::vector<Error>> {
+            const auto toSingleValue = [&values]() -> std::optional<const std::string_view> {
+                if (values.empty() || values.back().empty()) return std::nullopt;
+                return values.back();
+            };
+            const auto toVector = [](std::expected<void, Error> result) -> std::expected<void, std::vector<Error>> {
+                if (!result.has_value()) return std::unexpected(std::vector{std::move(result.error())});
+                return {};
+            };
+
+            switch (option.kind) {
+                case FlagKind::Flag:        return toVector(m_flags.at(option.id)->set_value(toSingleValue()));
+                case FlagKind::MultiFlag:   return m_multiFlags.at(option.id)->set_value(values, maxErrors);
+                case FlagKind::Choice:      return toVector(m_choices.at(option.id)->set_value(toSingleValue()));
+                case FlagKind::MultiChoice: return m_multiChoices.at(option.id)->set_value(values, maxErrors);
+            }
+            return {};
+        }
+
+        // Options bound to an environment variable with with_env, in insertion order
+        [[nodiscard]] auto get_environment_bindings() const -> std::vector<std::pair<FlagOrderEntry, std::string_view>> {
+            std::vector<std::pair<FlagOrderEntry, std::string_view>> bindings;
+            for (const auto& entry : m_insertionOrder) {
+                std::string_view variable;
+                switch (entry.kind) {
+                    case FlagKind::Flag:        variable = m_flags.at(entry.id)->m_environmentVariable; break;
+                    case FlagKind::MultiFlag:   variable = m_multiFlags.at(entry.id)->m_environmentVariable; break;
+                    case FlagKind::Choice:      variable = m_choices.at(entry.id)->m_environmentVariable; break;
+                    case FlagKind::MultiChoice: break;
+                }
+                if (!variable.empty()) bindings.emplace_back(entry, variable);
+            }
+            return bindings;
+        }
+
+        // Unsets every option, so that the context can be parsed into again
+        auto clear_values() -> void {
+            for (auto& option : m_flags | std::views::values) option->clear_value();
+            for (auto& option : m_multiFlags | std::views::values) option->clear_value();
+            for (auto& option : m_positionals | std::views::values) option->clear_value();
+            if (m_multiPositional.has_value()) m_multiPositional->second->clear_value();
+            for (auto& option : m_choices | std::views::values) option->clear_value();
+            for (auto& option : m_multiChoices | std::views::values) option->clear_value();
+        }
+
+        // Unsets every option that is not in kept
+        auto clear_values_except(const std::unordered_set<UniqueId>& kept) -> void {
+            const auto clear = [&kept](auto& options) {
+                for (auto& [id, option] : options) {
+                    if (!kept.contains(id)) option->clear_value();
+                }
+            };
+            clear(m_flags);
+            clear(m_multiFlags);
+            clear(m_positionals);
+            if (m_multiPositional.has_value() && !kept.contains(m_multiPositional->first)) {
+                m_multiPositional->second->clear_value();
+            }
+            clear(m_choices);
+            clear(m_multiChoices);
+        }
+
+        // Whether each named option, positional and the multi-positional is set, in the order they were added
+        [[nodiscard]] auto get_presence() const -> std::vector<bool> {
+            std::vector<bool> presence;
+            for (const auto& entry : m_insertionOrder) presence.push_back(is_option_set(entry));
+            for (const auto& id : m_positionalOrder) presence.push_back(m_positionals.at(id)->is_set());
+            if (m_multiPositional.has_value()) presence.push_back(m_multiPositional->second->is_set());
+            return presence;
+        }
+
+        // Gives the values read from a file descriptor to the multi-positional, if it is streamed
+        [[nodiscard]] auto set_stream_source(std::shared_ptr<DescriptorReader> reader) -> bool {
+            return m_multiPositional.has_value() && m_multiPositional->second->set_stream_source(std::move(reader));
+        }
+
+        auto clear_value_sources() -> void {
+            m_valueSources.clear();
+        }
+
+        // Attributes every option that is now set, and was not set by an earlier source, to the given source
+        auto record_value_sources(const ValueSource source) -> void {
+            record_sources_of(m_flags, source);
+            record_sources_of(m_multiFlags, source);
+            record_sources_of(m_positionals, source);
+            if (m_multiPositional.has_value() && m_multiPositional->second->is_set()) {
+                m_valueSources.try_emplace(m_multiPositional->first, source);
+            }
+            record_sources_of(m_choices, source);
+            record_sources_of(m_multiChoices, source);
+        }
+
+        [[nodiscard]] auto get_value_source(const UniqueId& id) const -> std::optional<ValueSource> {
+            const auto it = m_valueSources.find(id);
+            if (it == m_valueSources.end()) return std::nullopt;
+            return it->second;
+        }
+
+        // Converts the values of every lazily converted option, in the order errors of a run are reported, and returns
+        // the errors of those that fail. Afterwards, reading results no longer writes to any option.
+        [[nodiscard]] auto convert_deferred_values() const -> std::vector<Error> {
+            std::vector<Error> errors;
+            const auto convert = [&errors](const auto& option) {
+                if (auto converted = option->convert_deferred_values(); !converted.has_value()) {
+                    std::ranges::move(converted.error(), std::back_inserter(errors));
+                }
+            };
+            for (const auto& [kind, id] : m_insertionOrder) {
+                if (kind == FlagKind::Flag) convert(m_flags.at(id));
+                if (kind == FlagKind::MultiFlag) convert(m_multiFlags.at(id));
+            }
+            for (const auto& id : m_positionalOrder) convert(m_positionals.at(id));
+            if (m_multiPositional.has_value()) convert(m_multiPositional->second);
+            return errors;
+        }
+
+        // The value source and values of each option, encoded so that two parses can be compared. Options whose values
+        // cannot be encoded map to std::nullopt, and streamed multi-positionals, whose values are only read when
+        // iterated, are left out.
+        [[nodiscard]] auto encode_options() const -> std::unordered_map<UniqueId, std::optional<std::string>> {
+            std::unordered_map<UniqueId, std::optional<std::string>> encoded;
+            const auto encode = [&](const UniqueId& id, const auto& option) {
+                SnapshotWriter out;
+                out.write_raw(get_value_source(id).value_or(ValueSource::None));
+                if (option->write_snapshot(out).has_value()) {
+                    encoded.emplace(id, std::move(out).take());
+                } else {
+                    encoded.emplace(id, std::nullopt);
+                }
+            };
+            for (const auto& [id, option] : m_flags) encode(id, option);
+            for (const auto& [id, option] : m_multiFlags) encode(id, option);
+            for (const auto& [id, option] : m_positionals) encode(id, option);
+            if (m_multiPositional.has_value() && !m_multiPositional->second->is_streamed()) {
+                encode(m_multiPositional->first, m_multiPositional->second);
+            }
+            for (const auto& [id, option] : m_choices) encode(id, option);
+            for (const auto& [id, option] : m_multiChoices) encode(id, option);
+            return encoded;
+        }
+
+        // Writes every option as its kind, name, value source and values
+        [[nodiscard]] auto write_snapshot(SnapshotWriter& out) const -> std::expected<void, std::string> {
+            const size_t optionCount = m_flags.size() + m_multiFlags.size() + m_positionals.size()
+                + (m_multiPositional.has_value() ? 1 : 0) + m_choices.size() + m_multiChoices.size();
+            out.write_raw(static_cast<uint32_t>(optionCount));
+
+            const auto writeOption = [&](const SnapshotOptionKind kind, const UniqueId& id, const std::string_view name,
+                                         const auto& option) -> std::expected<void, std::string> {
+                out.write_raw(kind);
+                out.write_string(name);
+                out.write_raw(get_value_source(id).value_or(ValueSource::None));
+                return option->write_snapshot(out);
+            };
+
+            for (const auto& [kind, id] : m_insertionOrder) {
+                std::expected<void, std::string> success;
+                switch (kind) {
+                    case FlagKind::Flag: {
+                        const auto& flag = m_flags.at(id);
+                        success = writeOption(SnapshotOptionKind::Flag, id, flag->get_flag(), flag);
+                        break;
+                    }
+                    case FlagKind::MultiFlag: {
+                        const auto& flag = m_multiFlags.at(id);
+                        success = writeOption(SnapshotOptionKind::MultiFlag, id, flag->get_flag(), flag);
+                        break;
+                    }
+                    case FlagKind::Choice: {
+                        const auto& choice = m_choices.at(id);
+                        success = writeOption(SnapshotOptionKind::Choice, id, choice->get_flag(), choice);
+                        break;
+                    }
+                    case FlagKind::MultiChoice: {
+                        const auto& choice = m_multiChoices.at(id);
+                        success = writeOption(SnapshotOptionKind::MultiChoice, id, choice->get_flag(), choice);
+                        break;
+                    }
+                }
+                if (!success.has_value()) return success;
+            }
+            for (const auto& id : m_positionalOrder) {
+                const auto& positional = m_positionals.at(id);
+                if (auto success = writeOption(SnapshotOptionKind::Positional, id, positional->get_name(), positional);
+                    !success.has_value()) {
+                    return success;
+                }
+            }
+            if (m_multiPositional.has_value()) {
+                const auto& [id, positional] = m_multiPositional.value();
+                return writeOption(SnapshotOptionKind::MultiPositional, id, positional->get_name(), positional);
+            }
+            return {};
+        }
+
+        // Replaces the values of every option with those in the snapshot. Options missing from the snapshot are unset.
+        [[nodiscard]] auto read_snapshot(SnapshotReader& in) -> std::expected<void, std::string> {
+            clear_values();
+            clear_value_sources();
+
+            const auto malformed = std::unexpected(std::string("Snapshot is truncated or malformed"));
+            const auto optionCount = in.read_raw<uint32_t>();
+            if (!optionCount.has_value()) return malformed;
+
+            const auto findNamed = [](const auto& options, const std::string_view name, const auto& getName)
+                -> std::optional<UniqueId> {
+                const auto it = std::ranges::find_if(options, [&](const auto& pair) { return getName(pair.second) == name; });
+                if (it == options.end()) return std::nullopt;
+                return it->first;
+            };
+            const auto flagName = [](const auto& option) -> std::string_view { return option->get_flag(); };
+            const auto positionalName = [](const auto& option) -> std::string_view { return option->get_name(); };
+
+            for (uint32_t i = 0; i < optionCount.value(); i++) {
+                const auto kind = in.read_raw<SnapshotOptionKind>();
+                const auto name = in.read_string();
+                const auto source = in.read_raw<ValueSource>();
+                if (!kind.has_value() || !name.has_value() || !source.has_value()
+                    || source.value() < ValueSource::None || source.value() > ValueSource::CommandLine) {
+                    return malformed;
+                }
+
+                std::optional<UniqueId> id;
+                bool read = false;
+                switch (kind.value()) {
+                    case SnapshotOptionKind::Flag:
+                        if ((id = findNamed(m_flags, name.value(), flagName))) read = m_flags.at(*id)->read_snapshot(in);
+                        break;
+                    case SnapshotOptionKind::MultiFlag:
+                        if ((id = findNamed(m_multiFlags, name.value(), flagName))) read = m_multiFlags.at(*id)->read_snapshot(in);
+                        break;
+                    case SnapshotOptionKind::Positional:
+                        if ((id = findNamed(m_positionals, name.value(), positionalName))) read = m_positionals.at(*id)->read_snapshot(in);
+                        break;
+                    case SnapshotOptionKind::MultiPositional:
+                        if (m_multiPositional.has_value() && m_multiPositional->second->get_name() == name.value()) {
+                            id = m_multiPositional->first;
+                            read = m_multiPositional->second->read_snapshot(in);
+                        }
+                        break;
+                    case SnapshotOptionKind::Choice:
+                        if ((id = findNamed(m_choices, name.value(), flagName))) read = m_choices.at(*id)->read_snapshot(in);
+                        break;
+                    case SnapshotOptionKind::MultiChoice:
+                        if ((id = findNamed(m_multiChoices, name.value(), flagName))) read = m_multiChoices.at(*id)->read_snapshot(in);
+                        break;
+                    default:
+                        return malformed;
+                }
+
+                if (!id.has_value()) {
+                    return std::unexpected(std::format("Option '{}' in the snapshot does not exist", name.value()));
+                }
+                if (!read) return malformed;
+                if (source.value() != ValueSource::None) m_valueSources[id.value()] = source.value();
+            }
+            return {};
+        }
+    };
+} // namespace argon::detail
+
+
+namespace argon::detail {
+    class HelpMessageBuilder {
+        constexpr static size_t minLineWidth = 40;
+        constexpr static size_t maxDescriptionColumn = 32;
+        constexpr static size_t groupNameColumn = 2;
+        constexpr static size_t usageColumn = 4;
+        constexpr static size_t bufferBetweenUsageAndDesc = 2;
+
+        [[nodiscard]] static auto accumulate_flag_and_aliases(
+            const std::string& flagName,
+            const std::vector<std::string>& aliases
+        ) -> std::string {
+            return std::ranges::fold_left(aliases, flagName,
+                [](std::string acc, const std::string& alias) {
+                    acc += ", " + alias;
+                    return acc;
+                }
+            );
+        }
+
+        [[nodiscard]] static auto accumulate_names(const std::vector<std::string>& names) -> std::string {
+            return std::ranges::fold_left(names | std::views::drop(1), names.at(0),
+                [](std::string acc, const std::string& name) {
+                    acc += ", " + name;
+                    return acc;
+                }
+            );
+        }
+
+        [[nodiscard]] static auto accumulate_choices(const std::vector<std::string>& choices) -> std::string {
+            return std::ranges::fold_left(choices | std::views::drop(1), choices.at(0),
+                [](std::string acc, const std::string& choice) {
+                    acc += "|" + choice;
+                    return acc;
+                }
+            );
+        }
+
+        [[nodiscard]] static auto get_flag_usage(const FlagBase *flag) -> std::string {
+            std::string names = accumulate_flag_and_aliases(flag->get_flag(), flag->get_aliases());
+            names += " ";
+            names += flag->is_implicit_set() ? "[<" : "<";
+            names += flag->get_input_hint();
+            names += flag->is_implicit_set() ? ">]" : ">";
+            return names;
+        }
+
+        [[nodiscard]] static auto get_multi_flag_usage(const MultiFlagBase *flag) -> std::string {
+            std::string names = accumulate_flag_and_aliases(flag->get_flag(), flag->get_aliases());
+            names += " ";
+            if (flag->is_implicit_set()) names += "[";
+            names += "<";
+            names += flag->get_input_hint();
+            names += ">...";
+            if (flag->is_implicit_set()) names += "]";
+            return names;
+        }
+
+        [[nodiscard]] static auto get_choice_usage(const ChoiceBase *choice) -> std::string {
+            std::string names = accumulate_flag_and_aliases(choice->get_flag(), choice->get_aliases());
+            names += " ";
+            names += choice->is_implicit_set() ? "[<" : "<";
+            names += accumulate_choices(choice->get_choices());
+            names += choice->is_implicit_set() ? ">]" : ">";
+            return names;
+        }
+
+        [[nodiscard]] static auto get_multi_choice_usage(const MultiChoiceBase *choice) -> std::string {
+            std::string names = accumulate_flag_and_aliases(choice->get_flag(), choice->get_aliases());
+            names += " ";
+            if (choice->is_implicit_set()) names += "[";
+            names += "<";
+            names += accumulate_choices(choice->get_choices());
+            names += ">...";
+            if (choice->is_implicit_set()) names += "]";
+            return names;
+        }
+
+        [[nodiscard]] static auto get_option_usage_messages(const Context& context) -> std::vector<std::string> {
+            std::vector<std::string> usages;
+
+            for (const auto& [kind, id] : context.get_insertion_order()) {
+                switch (kind) {
+                    case FlagKind::Flag: {
+                        usages.emplace_back(get_flag_usage(context.get_flags().at(id).get()));
+                    } break;
+                    case FlagKind::MultiFlag: {
+                        usages.emplace_back(get_multi_flag_usage(context.get_multi_flags().at(id).get()));
+                    } break;
+                    case FlagKind::Choice: {
+                        usages.emplace_back(get_choice_usage(context.get_choices().at(id).get()));
+                    } break;
+                    case FlagKind::MultiChoice: {
+                        usages.emplace_back(get_multi_choice_usage(context.get_multi_choices().at(id).get()));
+                    } break;
+                }
+            }
+            for (const auto *builtinFlags : {&context.get_help_flags(), &context.get_version_flags()}) {
+                if (!builtinFlags->empty()) usages.emplace_back(accumulate_names(*builtinFlags));
+            }
+            return usages;
+        }
+
+        // Lines refer to desc
+        [[nodiscard]] static auto wrap_description(
+            const std::string_view desc,
+            const size_t wrapWidth
+        ) -> std::vector<std::string_view> {
+            std::vector<std::string_view> result;
+            size_t pos = 0;
+
+            while (pos < desc.size()) {
+                while (pos < desc.size() && isspace(desc[pos])) ++pos;
+                if (desc.substr(pos).empty()) return result;
+
+                size_t end = std::min(pos + wrapWidth, desc.size());
+                if (end < desc.size()) {
+                    if (const size_t lastSpace = desc.rfind(' ', end);
+                        lastSpace != std::string::npos && lastSpace > pos) {
+                        end = lastSpace;
+                    }
+                }
+
+                result.emplace_back(desc.substr(pos, end - pos));
+                pos = end;
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] static auto get_option_descriptions(
+            const Context& context,
+            const size_t wrapWidth
+        ) -> std::vector<std::vector<std::string_view>> {
+            std::vector<std::vector<std::string_view>> descriptions;
+
+            for (const auto& [kind, id] : context.get_insertion_order()) {
+                switch (kind) {
+                    case FlagKind::Flag: {
+                        descriptions.emplace_back(wrap_description(context.get_flags().at(id)->get_description(), wrapWidth));
+                    } break;
+                    case FlagKind::MultiFlag: {
+                        descriptions.emplace_back(wrap_description(context.get_multi_flags().at(id)->get_description(), wrapWidth));
+                    } break;
+                    case FlagKind::Choice: {
+                        descriptions.emplace_back(wrap_description(context.get_choices().at(id)->get_description(), wrapWidth));
+                    } break;
+                    case FlagKind::MultiChoice: {
+                        descriptions.emplace_back(wrap_description(context.get_multi_choices().at(id)->get_description(), wrapWidth));
+                    } break;
+                }
+            }
+            if (!context.get_help_flags().empty()) {
+                descriptions.emplace_back(wrap_description("Show this help message", wrapWidth));
+            }
+            if (!context.get_version_flags().empty()) {
+                descriptions.emplace_back(wrap_description("Show the version", wrapWidth));
+            }
+            return descriptions;
+        }
+
+        [[nodiscard]] static auto get_positional_usage_messages(const Context& context) -> std::vector<std::string> {
+            std::vector<std::string> usages;
+            for (size_t i = 0; i < context.get_num_positionals(); ++i) {
+                const PositionalBase *pos = context.get_positional(i);
+                usages.emplace_back(std::format("<{}>", pos->get_name()));
+            }
+            if (const auto multiPos = context.get_multi_positional_ptr()) {
+                usages.emplace_back(std::format("<{}>...", multiPos->get_name()));
+            }
+            return usages;
+        }
+
+        [[nodiscard]] static auto get_positional_descriptions(
+            const Context& context,
+            const size_t wrapWidth
+        ) -> std::vector<std::vector<std::string_view>> {
+            std::vector<std::vector<std::string_view>> descriptions;
+            for (size_t i = 0; i < context.get_num_positionals(); i++) {
+                descriptions.emplace_back(wrap_description(context.get_positional(i)->get_description(), wrapWidth));
+            }
+            if (const auto multiPos = context.get_multi_positional_ptr()) {
+                descriptions.emplace_back(wrap_description(multiPos->get_description(), wrapWidth));
+            }
+            return descriptions;
+        }
+
+        template <std::output_iterator<char> Out>
+        static auto concat_name_and_desc(
+            Out out,
+            const std::string_view name,
+            const std::vector<std::string_view>& desc,
+            const size_t descCol
+        ) -> Out {
+            out = std::format_to(out, "{:{}}{}{:{}}", "", usageColumn, name, "", bufferBetweenUsageAndDesc);
+            if (desc.empty()) {
+                *out++ = '\n';
+                return out;
+            }
+
+            if (usageColumn + name.size() + bufferBetweenUsageAndDesc > descCol) {
+                out = std::format_to(out, "\n{:{}}{}\n", "", descCol, desc.at(0));
+            } else {
+                out = std::format_to(out, "{:{}}{}\n", "", descCol - (usageColumn + name.size() + bufferBetweenUsageAndDesc),
+                    desc.at(0));
+            }
+            for (const auto& str : desc | std::views::drop(1)) {
+                out = std::format_to(out, "{:{}}{}\n", "", descCol, str);
+            }
+            return out;
+        }
+
+    public:
+        constexpr static size_t defaultLineWidth = 80;
+
+        template <std::output_iterator<char> Out>
+        static auto build_to(
+            Out out,
+            const Context& context,
+            const std::vector<std::pair<std::string_view, std::string_view>>& subcommandNamesAndDesc,
+            const std::string_view commandPath,
+            const std::string_view commandDescription,
+            size_t lineWidth = defaultLineWidth
+        ) -> Out {
+            lineWidth = std::max(lineWidth, minLineWidth);
+
+            const auto optionUsageMessages = get_option_usage_messages(context);
+            const auto positionalUsageMessages = get_positional_usage_messages(context);
+
+            // Usage message
+            out = std::format_to(out, "Usage:\n");
+            if (!subcommandNamesAndDesc.empty()) {
+                out = std::format_to(out, "{:{}}{} <command>\n", "", usageColumn, commandPath);
+            }
+            if (!optionUsageMessages.empty() || !positionalUsageMessages.empty()) {
+                out = std::format_to(out, "{:{}}{}", "", usageColumn, commandPath);
+                if (!optionUsageMessages.empty()) {
+                    out = std::format_to(out, " [options]");
+                }
+                for (const auto& posUsage : positionalUsageMessages) {
+                    out = std::format_to(out, " {}", posUsage);
+                }
+            }
+            if (subcommandNamesAndDesc.empty() && optionUsageMessages.empty() && positionalUsageMessages.empty()) {
+                out = std::format_to(out, "{:{}}{}", "", usageColumn, commandPath);
+            }
+
+            // Description
+            bool prevSectionSet = false;
+            if (!commandDescription.empty()) {
+                out = std::format_to(out, "\n\nDescription:\n");
+                for (const auto descriptions = wrap_description(commandDescription, lineWidth - usageColumn);
+                        const auto& str : descriptions) {
+                    out = std::format_to(out, "{:{}}{}\n", "", usageColumn, str);
+                }
+                prevSectionSet = true;
+            }
+
+            // Subcommands
+            if (!subcommandNamesAndDesc.empty()) {
+                if (prevSectionSet) {
+                    *out++ = '\n';
+                }
+                out = std::format_to(out, "Commands:\n");
+
+                const size_t maxCmdName =
+                    std::min(maxDescriptionColumn, std::ranges::max(subcommandNamesAndDesc
+                        | std::views::keys
+                        | std::views::transform([](const auto& str) {
+                            return str.size();
+                        })));
+                const size_t descCol = std::min(maxDescriptionColumn, usageColumn + maxCmdName + bufferBetweenUsageAndDesc);
+                const size_t descriptionWrapWidth = lineWidth - descCol;
+
+                for (const auto& [name, desc] : subcommandNamesAndDesc) {
+                    const auto wrapped = wrap_description(desc, descriptionWrapWidth);
+                    out = concat_name_and_desc(out, name, wrapped, descCol);
+                }
+                prevSectionSet = true;
+            }
+
+            // Calculate the column for the description
+            const size_t maxOptionUsageLen = optionUsageMessages.empty() ? 0 :
+                std::ranges::max(optionUsageMessages | std::views::transform([](const auto& str) { return str.size(); }));
+            const size_t maxPositionalUsageLen = positionalUsageMessages.empty() ? 0 :
+                std::ranges::max(positionalUsageMessages | std::views::transform([](const auto& str) { return str.size(); }));
+            const size_t maxUsageLen = std::max(maxOptionUsageLen, maxPositionalUsageLen);
+
+            const size_t descCol = std::min(maxDescriptionColumn, usageColumn + maxUsageLen + bufferBetweenUsageAndDesc);
+            const size_t descriptionWrapWidth = lineWidth - descCol;
+
+            const auto optionDescriptions = get_option_descriptions(context, descriptionWrapWidth);
+            const auto positionalDescriptions = get_positional_descriptions(context, descriptionWrapWidth);
+
+            // All non-positional usage and description messages
+            if (!optionUsageMessages.empty()) {
+                if (prevSectionSet) {
+                    *out++ = '\n';
+                }
+
+                out = std::format_to(out, "Options:\n");
+                for (size_t i = 0; i < optionUsageMessages.size(); i++) {
+                    const auto& usage = optionUsageMessages[i];
+                    const auto& desc = optionDescriptions[i];
+                    out = concat_name_and_desc(out, usage, desc, descCol);
+                }
+                prevSectionSet = true;
             }
 
-            const UniqueId id{};
-            m_multiPositional = std::pair{
-                id, detail::make_polymorphic<MultiPositionalBase>(std::move(positional))
-            };
-            return id;
-        }
+            // Positional usage and description messages
+            if (!positionalUsageMessages.empty()) {
+                if (prevSectionSet) {
+                    *out++ = '\n';
+                }
 
-        template <typename T>
-        [[nodiscard]] auto add_choice(Choice<T> flag) -> UniqueId {
-            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
-                throw std::invalid_argument(std::format(
-                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
+                out = std::format_to(out, "Positionals:\n");
+                for (size_t i = 0; i < positionalUsageMessages.size(); i++) {
+                    const auto& usage = positionalUsageMessages[i];
+                    const auto& desc = positionalDescriptions[i];
+                    out = concat_name_and_desc(out, usage, desc, descCol);
+                }
             }
-            const UniqueId id{};
-            m_choices.emplace(id, detail::make_polymorphic<ChoiceBase>(std::move(flag)));
-            m_insertionOrder.emplace_back(FlagKind::Choice, id);
-            return id;
+            return out;
         }
+    };
+} // namespace argon::detail
 
-        template <typename T>
-        [[nodiscard]] auto add_multi_choice(MultiChoice<T> flag) -> UniqueId {
-            if (const auto duplicateFlag = flag_or_alias_exists(flag); duplicateFlag.has_value()) {
-                throw std::invalid_argument(std::format(
-                    "Unable to add flag/alias: flag/alias '{}' already exists", duplicateFlag.value()));
-            }
-            const UniqueId id{};
-            m_multiChoices.emplace(id, detail::make_polymorphic<MultiChoiceBase>(std::move(flag)));
-            m_insertionOrder.emplace_back(FlagKind::MultiChoice, id);
-            return id;
-        }
 
-        [[nodiscard]] auto contains_flag(const std::string_view flagName) const -> bool {
-            return get_flag(flagName) != nullptr;
-        }
+namespace argon::detail {
+    // Help messages rendered by a Cli, by command and line width. Messages are immutable once rendered, so callers
+    // share them without copying, and finding one only takes a shared lock. Copies of a cache start empty.
+    class HelpCache {
+        struct Key {
+            UniqueId command;
+            size_t width;
+
+            auto operator==(const Key&) const -> bool = default;
+        };
 
-        [[nodiscard]] auto contains_multi_flag(const std::string_view flagName) const -> bool {
-            return get_multi_flag(flagName) != nullptr;
-        }
+        struct KeyHash {
+            auto operator()(const Key& key) const noexcept -> size_t {
+                return std::hash<UniqueId>{}(key.command) * 31 + key.width;
+            }
+        };
 
-        [[nodiscard]] auto contains_multi_positional() const -> bool {
-            return m_multiPositional.has_value();
-        }
+        mutable std::shared_mutex m_mutex;
+        std::unordered_map<Key, std::shared_ptr<const std::string>, KeyHash> m_messages;
 
-        [[nodiscard]] auto contains_choice(const std::string_view flagName) const -> bool {
-            return get_choice(flagName) != nullptr;
-        }
+    public:
+        HelpCache() = default;
+        HelpCache(const HelpCache&) {}
+        HelpCache(HelpCache&&) noexcept {}
 
-        [[nodiscard]] auto contains_multi_choice(const std::string_view flagName) const -> bool {
-            return get_multi_choice(flagName) != nullptr;
+        auto operator=(const HelpCache&) -> HelpCache& {
+            clear();
+            return *this;
         }
 
-        [[nodiscard]] auto get_flag(const std::string_view flagName) -> FlagBase * {
-            const auto it = std::ranges::find_if(m_flags, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
-            });
-            if (it == m_flags.end()) return nullptr;
-            return it->second.get();
+        auto operator=(HelpCache&&) noexcept -> HelpCache& {
+            clear();
+            return *this;
         }
 
-        [[nodiscard]] auto get_flag(const std::string_view flagName) const -> const FlagBase * {
-            const auto it = std::ranges::find_if(m_flags, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
-            });
-            if (it == m_flags.end()) return nullptr;
-            return it->second.get();
-        }
+        template <typename Render>
+        [[nodiscard]] auto get(const UniqueId& command, const size_t width, Render render)
+            -> std::shared_ptr<const std::string> {
+            const Key key{.command = command, .width = width};
+            {
+                std::shared_lock lock{m_mutex};
+                if (const auto it = m_messages.find(key); it != m_messages.end()) return it->second;
+            }
 
-        [[nodiscard]] auto get_flags() const -> const std::unordered_map<UniqueId, Polymorphic<FlagBase>>& {
-            return m_flags;
+            std::unique_lock lock{m_mutex};
+            if (const auto it = m_messages.find(key); it != m_messages.end()) return it->second;
+            auto message = std::make_shared<const std::string>(render());
+            m_messages.emplace(key, message);
+            return message;
         }
 
-        [[nodiscard]] auto get_multi_flag(const std::string_view flagName) -> MultiFlagBase * {
-            const auto it = std::ranges::find_if(m_multiFlags, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
-            });
-            if (it == m_multiFlags.end()) return nullptr;
-            return it->second.get();
+        auto clear() -> void {
+            std::unique_lock lock{m_mutex};
+            m_messages.clear();
         }
+    };
 
-        [[nodiscard]] auto get_multi_flag(const std::string_view flagName) const -> const MultiFlagBase * {
-            const auto it = std::ranges::find_if(m_multiFlags, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
-            });
-            if (it == m_multiFlags.end()) return nullptr;
-            return it->second.get();
-        }
+    // Output iterator into a fixed buffer. Characters past its end are dropped but still counted, like snprintf.
+    class BoundedBufferIterator {
+        char *m_next;
+        char *m_end;
+        size_t m_count = 0;
 
-        [[nodiscard]] auto get_multi_flags() const -> const std::unordered_map<UniqueId, Polymorphic<MultiFlagBase>>& {
-            return m_multiFlags;
-        }
+    public:
+        using difference_type = std::ptrdiff_t;
 
-        [[nodiscard]] auto get_positional(const size_t index) -> PositionalBase * {
-            if (index >= m_positionalOrder.size()) return nullptr;
-            return m_positionals.at(m_positionalOrder[index]).get();
-        }
+        explicit BoundedBufferIterator(const std::span<char> buffer)
+            : m_next(buffer.data()), m_end(buffer.data() + buffer.size()) {}
 
-        [[nodiscard]] auto get_positional(const size_t index) const -> const PositionalBase * {
-            if (index >= m_positionalOrder.size()) return nullptr;
-            return m_positionals.at(m_positionalOrder[index]).get();
+        auto operator=(const char c) -> BoundedBufferIterator& {
+            if (m_next != m_end) *m_next++ = c;
+            ++m_count;
+            return *this;
         }
 
-        [[nodiscard]] auto get_num_positionals() const -> size_t {
-            return m_positionals.size();
-        }
+        auto operator*() -> BoundedBufferIterator& { return *this; }
+        auto operator++() -> BoundedBufferIterator& { return *this; }
+        auto operator++(int) -> BoundedBufferIterator& { return *this; }
 
-        [[nodiscard]] auto get_positionals() const -> const std::unordered_map<UniqueId, Polymorphic<PositionalBase>>& {
-            return m_positionals;
-        }
+        [[nodiscard]] auto get_count() const -> size_t { return m_count; }
+    };
+} // namespace argon::detail
 
-        [[nodiscard]] auto get_multi_positional_with_id() const
-            -> const std::optional<std::pair<UniqueId, Polymorphic<MultiPositionalBase>>>& {
-            return m_multiPositional;
-        }
 
-        [[nodiscard]] auto get_multi_positional_ptr() -> MultiPositionalBase * {
-            if (!contains_multi_positional()) return nullptr;
-            return m_multiPositional->second.get();
-        }
+namespace argon::detail {
+    // Words that share a prefix are next to each other once sorted, so the sorted words work as a prefix trie whose
+    // nodes are ranges of words, found with two binary searches. Building it is a single sort, which keeps completion
+    // fast when the program is started for every request.
+    class CompletionIndex {
+        std::vector<std::string_view> m_words;
 
-        [[nodiscard]] auto get_multi_positional_ptr() const -> const MultiPositionalBase * {
-            if (!contains_multi_positional()) return nullptr;
-            return m_multiPositional->second.get();
+    public:
+        explicit CompletionIndex(std::vector<std::string_view> words) : m_words(std::move(words)) {
+            std::ranges::sort(m_words);
+            const auto [first, last] = std::ranges::unique(m_words);
+            m_words.erase(first, last);
         }
 
-        [[nodiscard]] auto get_choice(const std::string_view flagName) -> ChoiceBase * {
-            const auto it = std::ranges::find_if(m_choices, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+        [[nodiscard]] auto find_prefix(const std::string_view prefix) const -> std::vector<std::string> {
+            const auto first = std::ranges::lower_bound(m_words, prefix);
+            const auto last = std::partition_point(first, m_words.end(), [prefix](const std::string_view word) {
+                return word.starts_with(prefix);
             });
-            if (it == m_choices.end()) return nullptr;
-            return it->second.get();
+            return std::vector<std::string>(first, last);
         }
+    };
 
-        [[nodiscard]] auto get_choice(const std::string_view flagName) const -> const ChoiceBase * {
-            const auto it = std::ranges::find_if(m_choices, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
-            });
-            if (it == m_choices.end()) return nullptr;
-            return it->second.get();
-        }
+    [[nodiscard]] inline auto find_completion_option(const std::span<const OptionInfo> options,
+                                                     const std::string_view name) -> const OptionInfo * {
+        const auto it = std::ranges::find_if(options, [name](const OptionInfo& option) {
+            return option.flag == name || std::ranges::contains(option.aliases, name);
+        });
+        return it == options.end() ? nullptr : &*it;
+    }
 
-        [[nodiscard]] auto get_choices() const -> const std::unordered_map<UniqueId, Polymorphic<ChoiceBase>>& {
-            return m_choices;
+    // Completes the value of the last flag in arguments, if the word being completed belongs to it
+    [[nodiscard]] inline auto complete_flag_value(
+        const std::span<const OptionInfo> options, const std::span<const std::string_view> arguments,
+        const std::string_view prefix
+    ) -> std::optional<std::vector<std::string>> {
+        const auto last = std::ranges::find_if(arguments | std::views::reverse,
+            [](const std::string_view word) { return looks_like_flag(word); });
+        if (last == arguments.rend()) return std::nullopt;
+
+        const OptionInfo *option = find_completion_option(options, *last);
+        if (option == nullptr) return std::nullopt;
+        const bool isNextWord = last == arguments.rbegin();
+        const auto complete_choice = [&] {
+            return CompletionIndex{option->choices | std::ranges::to<std::vector<std::string_view>>()}
+                .find_prefix(prefix);
+        };
+        switch (option->kind) {
+            case OptionKind::Flag:
+                if (isNextWord && !option->hasImplicit) return std::vector<std::string>{};
+                break;
+            case OptionKind::MultiFlag:
+                return std::vector<std::string>{};
+            case OptionKind::Choice:
+                if (isNextWord) return complete_choice();
+                break;
+            case OptionKind::MultiChoice:
+                return complete_choice();
         }
+        return std::nullopt;
+    }
 
-        [[nodiscard]] auto get_multi_choice(const std::string_view flagName) -> MultiChoiceBase * {
-            const auto it = std::ranges::find_if(m_multiChoices, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
-            });
-            if (it == m_multiChoices.end()) return nullptr;
-            return it->second.get();
-        }
+    // Candidates for prefix in a command with the given options and subcommands, after the arguments given to it
+    [[nodiscard]] inline auto complete_word(
+        const std::span<const OptionInfo> options, std::vector<std::string_view> subcommands,
+        const std::span<const std::string_view> arguments, const std::string_view prefix
+    ) -> std::vector<std::string> {
+        if (std::ranges::contains(arguments, std::string_view("--"))) return {};
+        if (looks_like_flag(prefix)) {
+            std::vector<std::string_view> names;
+            for (const OptionInfo& option : options) {
+                names.emplace_back(option.flag);
+                names.insert(names.end(), option.aliases.begin(), option.aliases.end());
+            }
+            return CompletionIndex{std::move(names)}.find_prefix(prefix);
+        }
+        if (auto value = complete_flag_value(options, arguments, prefix)) return std::move(value.value());
+        if (!arguments.empty()) return {};
+        return CompletionIndex{std::move(subcommands)}.find_prefix(prefix);
+    }
 
-        [[nodiscard]] auto get_multi_choice(const std::string_view flagName) const -> const MultiChoiceBase * {
-            const auto it = std::ranges::find_if(m_multiChoices, [&](auto&& pair) -> bool {
-                const auto& flag = pair.second;
-                return flag->get_flag() == flagName || std::ranges::contains(flag->get_aliases(), flagName);
+    // Splits a command line into the words before the one being completed, without the program, and that word
+    [[nodiscard]] inline auto split_completion_words(const std::span<const std::string_view> words, const size_t cword)
+        -> std::optional<std::pair<std::span<const std::string_view>, std::string_view>> {
+        if (cword == 0 || words.empty()) return std::nullopt;
+        const std::string_view prefix = cword < words.size() ? words[cword] : std::string_view{};
+        return std::pair{words.subspan(1, std::min(cword, words.size()) - 1), prefix};
+    }
+
+    constexpr std::string_view completeCommand = "__complete";
+
+    constexpr std::string_view bashCompletionScript = R"SCRIPT(# bash completion for @PROGRAM@
+@FUNCTION@() {
+    local IFS=$'\n'
+    COMPREPLY=($("${COMP_WORDS[0]}" __complete "$COMP_CWORD" "${COMP_WORDS[@]}" 2>/dev/null))
+}
+complete -o default -F @FUNCTION@ @PROGRAM@
+)SCRIPT";
+
+    constexpr std::string_view zshCompletionScript = R"SCRIPT(#compdef @PROGRAM@
+@FUNCTION@() {
+    local -a completions
+    completions=(${(f)"$("${words[1]}" __complete "$((CURRENT - 1))" "${words[@]}" 2>/dev/null)"})
+    if (( ${#completions} )); then
+        compadd -a completions
+    else
+        _files
+    fi
+}
+compdef @FUNCTION@ @PROGRAM@
+)SCRIPT";
+
+    constexpr std::string_view fishCompletionScript = R"SCRIPT(# fish completion for @PROGRAM@
+function @FUNCTION@
+    set -l tokens (commandline -opc)
+    $tokens[1] __complete (count $tokens) $tokens (commandline -ct) 2>/dev/null
+end
+complete -c @PROGRAM@ -a '(@FUNCTION@)'
+)SCRIPT";
+
+    inline auto replace_script_markers(std::string_view script, const std::string_view program,
+                                       const std::string_view data = {}) -> std::string {
+        std::string function = "_argon_complete_";
+        for (const char c : program) {
+            function += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        }
+
+        constexpr std::array<std::string_view, 3> markers{"@PROGRAM@", "@FUNCTION@", "@DATA@"};
+        const std::array<std::string_view, 3> replacements{program, function, data};
+        std::string result;
+        while (!script.empty()) {
+            const size_t marker = script.find('@');
+            result += script.substr(0, marker);
+            if (marker == std::string_view::npos) break;
+            script.remove_prefix(marker);
+            const auto it = std::ranges::find_if(markers, [script](const std::string_view m) {
+                return script.starts_with(m);
             });
-            if (it == m_multiChoices.end()) return nullptr;
-            return it->second.get();
+            if (it == markers.end()) {
+                result += '@';
+                script.remove_prefix(1);
+            } else {
+                result += replacements[static_cast<size_t>(it - markers.begin())];
+                script.remove_prefix(it->size());
+            }
         }
+        return result;
+    }
 
-        [[nodiscard]] auto get_multi_choices() const -> const std::unordered_map<UniqueId, Polymorphic<MultiChoiceBase>>& {
-            return m_multiChoices;
+    inline auto get_completion_script(const CompletionShell shell, const std::string_view program) -> std::string {
+        switch (shell) {
+            case CompletionShell::Bash: return replace_script_markers(bashCompletionScript, program);
+            case CompletionShell::Zsh:  return replace_script_markers(zshCompletionScript, program);
+            case CompletionShell::Fish: return replace_script_markers(fishCompletionScript, program);
         }
+        return {};
+    }
 
-        [[nodiscard]] auto get_insertion_order() const -> const std::vector<FlagOrderEntry>& {
-            return m_insertionOrder;
-        }
-    };
-} // namespace argon::detail
+    constexpr std::string_view completionDataMagic = "ARGONCOMPLETION1";
 
+    [[nodiscard]] constexpr auto get_option_kind_name(const OptionKind kind) -> std::string_view {
+        switch (kind) {
+            case OptionKind::Flag:        return "flag";
+            case OptionKind::MultiFlag:   return "multi-flag";
+            case OptionKind::Choice:      return "choice";
+            case OptionKind::MultiChoice: return "multi-choice";
+        }
+        return "";
+    }
 
-namespace argon::detail {
-    class HelpMessageBuilder {
-        constexpr static size_t maxLineWidth = 80;
-        constexpr static size_t maxDescriptionColumn = 32;
-        constexpr static size_t groupNameColumn = 2;
-        constexpr static size_t usageColumn = 4;
-        constexpr static size_t bufferBetweenUsageAndDesc = 2;
+    template <typename Out>
+    auto write_json_string(Out out, const std::string_view str) -> Out {
+        *out++ = '"';
+        for (const char c : str) {
+            switch (c) {
+                case '"':  out = std::ranges::copy(std::string_view(R"(\")"), out).out; break;
+                case '\\': out = std::ranges::copy(std::string_view(R"(\\)"), out).out; break;
+                case '\n': out = std::ranges::copy(std::string_view(R"(\n)"), out).out; break;
+                case '\t': out = std::ranges::copy(std::string_view(R"(\t)"), out).out; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out = std::format_to(out, "\\u{:04x}", static_cast<unsigned>(c));
+                    } else {
+                        *out++ = c;
+                    }
+            }
+        }
+        *out++ = '"';
+        return out;
+    }
 
-        [[nodiscard]] static auto accumulate_flag_and_aliases(
-            const std::string& flagName,
-            const std::vector<std::string>& aliases
-        ) -> std::string {
-            return std::ranges::fold_left(aliases, flagName,
-                [](std::string acc, const std::string& alias) {
-                    acc += ", " + alias;
-                    return acc;
-                }
-            );
+    template <typename Out, std::ranges::input_range Range>
+    auto write_json_strings(Out out, const Range& strings) -> Out {
+        *out++ = '[';
+        bool first = true;
+        for (const std::string_view str : strings) {
+            if (!std::exchange(first, false)) *out++ = ',';
+            out = write_json_string(out, str);
         }
+        *out++ = ']';
+        return out;
+    }
 
-        [[nodiscard]] static auto accumulate_choices(const std::vector<std::string>& choices) -> std::string {
-            return std::ranges::fold_left(choices | std::views::drop(1), choices.at(0),
-                [](std::string acc, const std::string& choice) {
-                    acc += "|" + choice;
-                    return acc;
-                }
-            );
+    // One record per command, identified by the names of the subcommands leading to it, with the keys always in the same
+    // order so that a shell can find and match records without a JSON parser
+    inline auto write_completion_json_lines(std::string& out, const CommandInfo& cmd, const std::string& path) -> void {
+        auto it = std::back_inserter(out);
+        out += R"({"command":)";
+        it = write_json_string(it, path);
+        out += R"(,"description":)";
+        it = write_json_string(it, cmd.description);
+        out += R"(,"subcommands":)";
+        it = write_json_strings(it, cmd.subcommands | std::views::transform(&CommandInfo::name));
+        out += R"(,"options":[)";
+        for (const OptionInfo& option : cmd.options) {
+            if (&option != &cmd.options.front()) out += ',';
+            out += R"({"names":[)";
+            it = write_json_string(it, option.flag);
+            for (const std::string& alias : option.aliases) {
+                out += ',';
+                it = write_json_string(it, alias);
+            }
+            std::format_to(it, R"(],"kind":"{}","implicit":{},"choices":)",
+                get_option_kind_name(option.kind), option.hasImplicit);
+            it = write_json_strings(it, option.choices);
+            out += '}';
+        }
+        out += "]}\n";
+
+        for (const CommandInfo& subcommand : cmd.subcommands) {
+            write_completion_json_lines(out, subcommand, path.empty() ? subcommand.name : path + ' ' + subcommand.name);
         }
+    }
 
-        [[nodiscard]] static auto get_flag_usage(const FlagBase *flag) -> std::string {
-            std::string names = accumulate_flag_and_aliases(flag->get_flag(), flag->get_aliases());
-            names += " ";
-            names += flag->is_implicit_set() ? "[<" : "<";
-            names += flag->get_input_hint();
-            names += flag->is_implicit_set() ? ">]" : ">";
-            return names;
+    inline auto write_completion_binary(SnapshotWriter& out, const CommandInfo& cmd) -> void {
+        out.write_string(cmd.name);
+        out.write_string(cmd.description);
+        out.write_raw(static_cast<uint32_t>(cmd.options.size()));
+        for (const OptionInfo& option : cmd.options) {
+            out.write_raw(option.kind);
+            out.write_raw(option.hasImplicit);
+            out.write_string(option.flag);
+            std::ignore = out.write_values(option.aliases, option.flag);
+            std::ignore = out.write_values(option.choices, option.flag);
+        }
+        out.write_raw(static_cast<uint32_t>(cmd.subcommands.size()));
+        for (const CommandInfo& subcommand : cmd.subcommands) {
+            write_completion_binary(out, subcommand);
         }
+    }
 
-        [[nodiscard]] static auto get_multi_flag_usage(const MultiFlagBase *flag) -> std::string {
-            std::string names = accumulate_flag_and_aliases(flag->get_flag(), flag->get_aliases());
-            names += " ";
-            if (flag->is_implicit_set()) names += "[";
-            names += "<";
-            names += flag->get_input_hint();
-            names += ">...";
-            if (flag->is_implicit_set()) names += "]";
-            return names;
+    [[nodiscard]] inline auto read_completion_binary(SnapshotReader& in, CommandInfo& cmd) -> bool {
+        const auto name = in.read_string();
+        const auto description = in.read_string();
+        const auto optionCount = in.read_raw<uint32_t>();
+        if (!name || !description || !optionCount) return false;
+        cmd.name = name.value();
+        cmd.description = description.value();
+
+        for (uint32_t i = 0; i < optionCount.value(); i++) {
+            const auto kind = in.read_raw<uint8_t>();
+            const auto hasImplicit = in.read_raw<bool>();
+            const auto flag = in.read_string();
+            if (!kind || kind.value() > std::to_underlying(OptionKind::MultiChoice) || !hasImplicit || !flag) {
+                return false;
+            }
+            OptionInfo& option = cmd.options.emplace_back(OptionInfo{
+                .kind = static_cast<OptionKind>(kind.value()),
+                .flag = std::string(flag.value()),
+                .hasImplicit = hasImplicit.value(),
+            });
+            if (!in.read_values(option.aliases) || !in.read_values(option.choices)) return false;
         }
 
-        [[nodiscard]] static auto get_choice_usage(const ChoiceBase *choice) -> std::string {
-            std::string names = accumulate_flag_and_aliases(choice->get_flag(), choice->get_aliases());
-            names += " ";
-            names += choice->is_implicit_set() ? "[<" : "<";
-            names += accumulate_choices(choice->get_choices());
-            names += choice->is_implicit_set() ? ">]" : ">";
-            return names;
+        const auto subcommandCount = in.read_raw<uint32_t>();
+        if (!subcommandCount) return false;
+        for (uint32_t i = 0; i < subcommandCount.value(); i++) {
+            if (!read_completion_binary(in, cmd.subcommands.emplace_back())) return false;
         }
+        return true;
+    }
+
+    // Completes from a completion data file with shell builtins only, the same way as Cli::complete. Records are matched
+    // with regular expressions, so names containing '"' or ']' are not completed. Subcommands are written after their
+    // parent, so each one is searched for from the line of its parent.
+    constexpr std::string_view bashCompletionDataScript = R"SCRIPT(# bash completion for @PROGRAM@ from its completion data, without running @PROGRAM@
+@FUNCTION@_find() {
+    local key="{\"command\":\"$1\"," n
+    for (( n = position; n < ${#lines[@]}; n++ )); do
+        [[ ${lines[n]} == "$key"* ]] && { record=${lines[n]} position=$n; return 0; }
+    done
+    return 1
+}
+@FUNCTION@_add() {
+    local list=$1 word_re='^"([^"]*)",?(.*)$'
+    while [[ $list =~ $word_re ]]; do
+        [[ ${BASH_REMATCH[1]} == "$cur"* ]] && COMPREPLY+=("${BASH_REMATCH[1]}")
+        list=${BASH_REMATCH[2]}
+    done
+}
+@FUNCTION@_is_flag() {
+    [[ $1 == -* && $1 != -[0-9]* && $1 != -.[0-9]* ]]
+}
+@FUNCTION@() {
+    COMPREPLY=()
+    local -a lines
+    mapfile -t lines < @DATA@ || return
+    local cur="${COMP_WORDS[COMP_CWORD]}" command="" record="" position=0 word i j k
+    @FUNCTION@_find "" || return
+    for (( i = 1; i < COMP_CWORD; i++ )); do
+        @FUNCTION@_find "${command:+$command }${COMP_WORDS[i]}" || break
+        command="${command:+$command }${COMP_WORDS[i]}"
+    done
+
+    local -a arguments=("${COMP_WORDS[@]:i:COMP_CWORD-i}")
+    for word in "${arguments[@]}"; do
+        [[ $word == -- ]] && return
+    done
+
+    local -a names kinds implicits choices
+    local options_re='"options":\[(.*)\]\}$'
+    local option_re='^,?\{"names":\[([^]]*)\],"kind":"([a-z-]+)","implicit":(true|false),"choices":\[([^]]*)\]\}(.*)$'
+    [[ $record =~ $options_re ]] || return
+    local rest=${BASH_REMATCH[1]}
+    while [[ $rest =~ $option_re ]]; do
+        names+=("${BASH_REMATCH[1]}") kinds+=("${BASH_REMATCH[2]}")
+        implicits+=("${BASH_REMATCH[3]}") choices+=("${BASH_REMATCH[4]}")
+        rest=${BASH_REMATCH[5]}
+    done
+
+    if @FUNCTION@_is_flag "$cur"; then
+        for (( k = 0; k < ${#names[@]}; k++ )); do
+            @FUNCTION@_add "${names[k]}"
+        done
+        return
+    fi
+
+    for (( j = ${#arguments[@]} - 1; j >= 0; j-- )); do
+        @FUNCTION@_is_flag "${arguments[j]}" || continue
+        local next=$(( j == ${#arguments[@]} - 1 ))
+        for (( k = 0; k < ${#names[@]}; k++ )); do
+            [[ ,${names[k]}, == *",\"${arguments[j]}\","* ]] || continue
+            case ${kinds[k]} in
+                flag) (( next )) && [[ ${implicits[k]} == false ]] && return ;;
+                multi-flag) return ;;
+                choice) (( next )) && { @FUNCTION@_add "${choices[k]}"; return; } ;;
+                multi-choice) @FUNCTION@_add "${choices[k]}"; return ;;
+            esac
+            break
+        done
+        break
+    done
+
+    local subcommands_re='"subcommands":\[([^]]*)\]'
+    (( ${#arguments[@]} == 0 )) && [[ $record =~ $subcommands_re ]] && @FUNCTION@_add "${BASH_REMATCH[1]}"
+}
+complete -o default -F @FUNCTION@ @PROGRAM@
+)SCRIPT";
+} // namespace argon::detail
+
+
+namespace argon {
+    // Candidates for words[cword] of a command line whose first word is the program, completed from a command tree
+    // read back with read_completion_data in the same way as Cli::complete
+    [[nodiscard]] inline auto complete_command_line(
+        const CommandInfo& root, const std::span<const std::string_view> words, const size_t cword
+    ) -> std::vector<std::string> {
+        const auto split = detail::split_completion_words(words, cword);
+        if (!split.has_value()) return {};
+        const auto [before, prefix] = split.value();
+
+        const CommandInfo *cmd = &root;
+        size_t selected = 0;
+        for (; selected < before.size(); ++selected) {
+            const auto it = std::ranges::find(cmd->subcommands, before[selected], &CommandInfo::name);
+            if (it == cmd->subcommands.end()) break;
+            cmd = &*it;
+        }
+
+        std::vector<std::string_view> names;
+        for (const CommandInfo& subcommand : cmd->subcommands) {
+            names.emplace_back(subcommand.name);
+        }
+        return detail::complete_word(cmd->options, std::move(names), before.subspan(selected), prefix);
+    }
 
-        [[nodiscard]] static auto get_multi_choice_usage(const MultiChoiceBase *choice) -> std::string {
-            std::string names = accumulate_flag_and_aliases(choice->get_flag(), choice->get_aliases());
-            names += " ";
-            if (choice->is_implicit_set()) names += "[";
-            names += "<";
-            names += accumulate_choices(choice->get_choices());
-            names += ">...";
-            if (choice->is_implicit_set()) names += "]";
-            return names;
+    // Reads a command tree exported in the binary completion data format, which stores numbers in native byte order
+    [[nodiscard]] inline auto read_completion_data(const std::string_view data) -> std::expected<CommandInfo, std::string> {
+        detail::SnapshotReader in{data};
+        CommandInfo root;
+        if (in.read_string() != detail::completionDataMagic || !detail::read_completion_binary(in, root) || !in.empty()) {
+            return std::unexpected(std::string("Completion data is truncated or malformed"));
         }
+        return root;
+    }
+} // namespace argon
 
-        [[nodiscard]] static auto get_option_usage_messages(const Context& context) -> std::vector<std::string> {
-            std::vector<std::string> usages;
 
-            for (const auto& [kind, id] : context.get_insertion_order()) {
-                switch (kind) {
-                    case FlagKind::Flag: {
-                        usages.emplace_back(get_flag_usage(context.get_flags().at(id).get()));
-                    } break;
-                    case FlagKind::MultiFlag: {
-                        usages.emplace_back(get_multi_flag_usage(context.get_multi_flags().at(id).get()));
-                    } break;
-                    case FlagKind::Choice: {
-                        usages.emplace_back(get_choice_usage(context.get_choices().at(id).get()));
-                    } break;
-                    case FlagKind::MultiChoice: {
-                        usages.emplace_back(get_multi_choice_usage(context.get_multi_choices().at(id).get()));
-                    } break;
+namespace argon::detail {
+    // Read-only view of a file's contents. The file is memory mapped where supported, so views into contents() do not
+    // copy the file, otherwise it is read into memory.
+    class MappedFile {
+        std::string_view m_contents;
+#ifdef ARGON_HAS_MMAP
+        void *m_mapping = nullptr;
+        size_t m_mappingSize = 0;
+#else
+        std::string m_buffer;
+#endif
+
+        MappedFile() = default;
+
+    public:
+        MappedFile(const MappedFile&) = delete;
+        auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : m_contents(std::exchange(other.m_contents, {}))
+#ifdef ARGON_HAS_MMAP
+            , m_mapping(std::exchange(other.m_mapping, nullptr))
+            , m_mappingSize(std::exchange(other.m_mappingSize, 0)) {}
+#else
+            , m_buffer(std::move(other.m_buffer)) {
+            m_contents = m_buffer;
+        }
+#endif
+
+        auto operator=(MappedFile&&) -> MappedFile& = delete;
+
+        ~MappedFile() {
+#ifdef ARGON_HAS_MMAP
+            if (m_mapping != nullptr) munmap(m_mapping, m_mappingSize);
+#endif
+        }
+
+        [[nodiscard]] static auto open(const std::filesystem::path& path) -> std::expected<MappedFile, std::string> {
+            MappedFile file;
+#ifdef ARGON_HAS_MMAP
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) return std::unexpected(std::format("unable to open '{}'", path.string()));
+
+            struct stat info{};
+            if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+                ::close(fd);
+                return std::unexpected(std::format("'{}' is not a regular file", path.string()));
+            }
+
+            if (info.st_size > 0) {
+                file.m_mappingSize = static_cast<size_t>(info.st_size);
+                file.m_mapping = mmap(nullptr, file.m_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (file.m_mapping == MAP_FAILED) {
+                    file.m_mapping = nullptr;
+                    ::close(fd);
+                    return std::unexpected(std::format("unable to map '{}'", path.string()));
                 }
+                file.m_contents = std::string_view(static_cast<const char *>(file.m_mapping), file.m_mappingSize);
             }
-            return usages;
+            ::close(fd);
+#else
+            std::FILE *stream = std::fopen(path.string().c_str(), "rb");
+            if (stream == nullptr) return std::unexpected(std::format("unable to open '{}'", path.string()));
+            std::array<char, 64 * 1024> chunk{};
+            size_t count;
+            while ((count = std::fread(chunk.data(), 1, chunk.size(), stream)) > 0) {
+                file.m_buffer.append(chunk.data(), count);
+            }
+            const bool failed = std::ferror(stream) != 0;
+            std::fclose(stream);
+            if (failed) return std::unexpected(std::format("unable to read '{}'", path.string()));
+            file.m_contents = file.m_buffer;
+#endif
+            return file;
         }
 
-        [[nodiscard]] static auto wrap_description(
-            const std::string_view desc,
-            const size_t wrapWidth
-        ) -> std::vector<std::string> {
-            std::vector<std::string> result;
-            size_t pos = 0;
-
-            while (pos < desc.size()) {
-                while (pos < desc.size() && isspace(desc[pos])) ++pos;
-                if (desc.substr(pos).empty()) return result;
+        [[nodiscard]] auto contents() const -> std::string_view {
+            return m_contents;
+        }
+    };
 
-                size_t end = std::min(pos + wrapWidth, desc.size());
-                if (end < desc.size()) {
-                    if (const size_t lastSpace = desc.rfind(' ', end);
-                        lastSpace != std::string::npos && lastSpace > pos) {
-                        end = lastSpace;
-                    }
-                }
+    class ResponseFileExpander {
+        const ResponseFileConfig& m_config;
+        std::vector<std::shared_ptr<const MappedFile>>& m_files;
+        std::vector<std::filesystem::path> m_openFiles;
+        bool m_expanding = true;
 
-                result.emplace_back(desc.substr(pos, end - pos));
-                pos = end;
+        [[nodiscard]] auto expand_token(
+            const std::string_view token,
+            const std::filesystem::path& baseDir,
+            std::vector<std::string_view>& out
+        ) -> std::expected<void, std::string> {
+            if (token == "--") m_expanding = false;
+            if (!m_expanding || token.size() < 2 || token[0] != '@') {
+                out.push_back(token);
+                return {};
             }
 
-            return result;
-        }
+            const std::filesystem::path path = baseDir / token.substr(1);
+            std::error_code ec;
+            std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+            if (ec) canonical = path;
 
-        [[nodiscard]] static auto get_option_descriptions(
-            const Context& context,
-            const size_t wrapWidth
-        ) -> std::vector<std::vector<std::string>> {
-            std::vector<std::vector<std::string>> descriptions;
+            if (std::ranges::contains(m_openFiles, canonical)) {
+                return std::unexpected(std::format("Response file '{}' includes itself", path.string()));
+            }
+            if (m_openFiles.size() >= m_config.maxDepth) {
+                return std::unexpected(std::format(
+                    "Response file '{}' exceeds the maximum nesting depth of {}", path.string(), m_config.maxDepth));
+            }
 
-            for (const auto& [kind, id] : context.get_insertion_order()) {
-                switch (kind) {
-                    case FlagKind::Flag: {
-                        descriptions.emplace_back(wrap_description(context.get_flags().at(id)->get_description(), wrapWidth));
-                    } break;
-                    case FlagKind::MultiFlag: {
-                        descriptions.emplace_back(wrap_description(context.get_multi_flags().at(id)->get_description(), wrapWidth));
-                    } break;
-                    case FlagKind::Choice: {
-                        descriptions.emplace_back(wrap_description(context.get_choices().at(id)->get_description(), wrapWidth));
-                    } break;
-                    case FlagKind::MultiChoice: {
-                        descriptions.emplace_back(wrap_description(context.get_multi_choices().at(id)->get_description(), wrapWidth));
-                    } break;
+            auto file = MappedFile::open(path);
+            if (!file.has_value()) {
+                return std::unexpected(std::format("Unable to read response file: {}", file.error()));
+            }
+            const auto& mapped = m_files.emplace_back(std::make_shared<const MappedFile>(std::move(file.value())));
+
+            m_openFiles.push_back(canonical);
+            const char separator = m_config.format == ResponseFileFormat::Null ? '\0' : '\n';
+            // Counting the arguments first keeps a large file from reallocating out, which would need both copies
+            const size_t needed = out.size() + static_cast<size_t>(std::ranges::count(mapped->contents(), separator)) + 1;
+            if (needed > out.capacity()) out.reserve(std::max(needed, out.capacity() * 2));
+            for (auto line : mapped->contents() | std::views::split(separator)) {
+                std::string_view arg(line.begin(), line.end());
+                if (m_config.format == ResponseFileFormat::Newline && arg.ends_with('\r')) {
+                    arg.remove_suffix(1);
+                }
+                if (arg.empty()) continue;
+                if (auto success = expand_token(arg, canonical.parent_path(), out); !success) {
+                    return success;
                 }
             }
-            return descriptions;
+            m_openFiles.pop_back();
+            return {};
         }
 
-        [[nodiscard]] static auto get_positional_usage_messages(const Context& context) -> std::vector<std::string> {
-            std::vector<std::string> usages;
-            for (size_t i = 0; i < context.get_num_positionals(); ++i) {
-                const PositionalBase *pos = context.get_positional(i);
-                usages.emplace_back(std::format("<{}>", pos->get_name()));
-            }
-            if (const auto multiPos = context.get_multi_positional_ptr()) {
-                usages.emplace_back(std::format("<{}>...", multiPos->get_name()));
+    public:
+        ResponseFileExpander(const ResponseFileConfig& config, std::vector<std::shared_ptr<const MappedFile>>& files)
+            : m_config(config), m_files(files) {}
+
+        // Expands every '@path' token after the program name, stopping at '--'. Relative paths inside a response file
+        // are resolved against the directory of that file.
+        [[nodiscard]] auto expand(const int argc, const char * const *argv)
+            -> std::expected<std::vector<std::string_view>, std::string> {
+            std::vector<std::string_view> out;
+            out.reserve(static_cast<size_t>(argc));
+            for (int i = 0; i < argc; i++) {
+                if (i == 0) {
+                    out.emplace_back(argv[i]);
+                    continue;
+                }
+                if (auto success = expand_token(argv[i], {}, out); !success) {
+                    return std::unexpected(std::move(success.error()));
+                }
             }
-            return usages;
+            return out;
         }
 
-        [[nodiscard]] static auto get_positional_descriptions(
-            const Context& context,
-            const size_t wrapWidth
-        ) -> std::vector<std::vector<std::string>> {
-            std::vector<std::vector<std::string>> descriptions;
-            for (size_t i = 0; i < context.get_num_positionals(); i++) {
-                descriptions.emplace_back(wrap_description(context.get_positional(i)->get_description(), wrapWidth));
-            }
-            if (const auto multiPos = context.get_multi_positional_ptr()) {
-                descriptions.emplace_back(wrap_description(multiPos->get_description(), wrapWidth));
+        // Expands every '@path' token of args, which do not include a program name
+        [[nodiscard]] auto expand(const std::span<const std::string_view> args)
+            -> std::expected<std::vector<std::string_view>, std::string> {
+            std::vector<std::string_view> out;
+            out.reserve(args.size());
+            for (const std::string_view arg : args) {
+                if (auto success = expand_token(arg, {}, out); !success) {
+                    return std::unexpected(std::move(success.error()));
+                }
             }
-            return descriptions;
+            return out;
         }
+    };
+} // namespace argon::detail
 
-        static auto concat_name_and_desc(
-            std::ostream& os,
-            const std::string_view name,
-            const std::vector<std::string>& desc,
-            const size_t descCol
-        ) -> void {
-            os << std::string(usageColumn, ' ') << name << std::string(bufferBetweenUsageAndDesc, ' ');
-            if (desc.empty()) {
-                os << "\n";
-                return;
-            }
 
-            if (usageColumn + name.size() + bufferBetweenUsageAndDesc > descCol) {
-                os << "\n";
-                os << std::string(descCol, ' ') << desc.at(0) << "\n";
-            } else {
-                os << std::string(descCol - (usageColumn + name.size() + bufferBetweenUsageAndDesc) , ' ');
-                os << desc.at(0) << "\n";
+namespace argon::detail {
+    // Index of the first whitespace, quote or backslash at or after pos, or the size of text if there is none
+    inline auto find_word_boundary(const std::string_view text, size_t pos) -> size_t {
+#if defined(__SSE2__)
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i carriageReturn = _mm_set1_epi8('\r');
+        const __m128i singleQuote = _mm_set1_epi8('\'');
+        const __m128i doubleQuote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        for (; pos + 16 <= text.size(); pos += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + pos));
+            const __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriageReturn)));
+            const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, singleQuote), _mm_cmpeq_epi8(chunk, doubleQuote)),
+                _mm_cmpeq_epi8(chunk, backslash));
+            if (const int mask = _mm_movemask_epi8(_mm_or_si128(whitespace, special)); mask != 0) {
+                return pos + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+            }
+        }
+#endif
+        for (; pos < text.size(); pos++) {
+            switch (text[pos]) {
+                case ' ': case '\t': case '\n': case '\r': case '\'': case '"': case '\\':
+                    return pos;
+                default:
+                    break;
             }
-            for (const auto& str : desc | std::views::drop(1)) {
-                os << std::string(descCol, ' ') << str << "\n";
+        }
+        return text.size();
+    }
+
+    // Index of the first double quote or backslash at or after pos, or the size of text if there is none
+    inline auto find_double_quote_boundary(const std::string_view text, size_t pos) -> size_t {
+#if defined(__SSE2__)
+        const __m128i doubleQuote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        for (; pos + 16 <= text.size(); pos += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + pos));
+            const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, doubleQuote), _mm_cmpeq_epi8(chunk, backslash));
+            if (const int mask = _mm_movemask_epi8(special); mask != 0) {
+                return pos + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
             }
         }
+#endif
+        for (; pos < text.size(); pos++) {
+            if (text[pos] == '"' || text[pos] == '\\') return pos;
+        }
+        return text.size();
+    }
 
-    public:
-        [[nodiscard]] static auto build(
-            const Context& context,
-            const std::vector<std::pair<std::string_view, std::string_view>>& subcommandNamesAndDesc,
-            const std::string_view commandPath,
-            const std::string_view commandDescription
-        ) -> std::string {
-            std::ostringstream msg;
+    enum class SplitError {
+        UnterminatedSingleQuote,
+        UnterminatedDoubleQuote,
+        TrailingBackslash,
+    };
 
-            const auto& optionOrders = context.get_insertion_order();
-            const auto optionUsageMessages = get_option_usage_messages(context);
-            const auto positionalUsageMessages = get_positional_usage_messages(context);
+    // Splits a command string into words like a POSIX shell, without expansions. A word is a view into the line when
+    // it is a single unquoted or quoted run. Words that need unescaping or joining are copied into the buffer, which
+    // is reserved up front so that earlier words stay valid.
+    class CommandLineSplitter {
+        std::string_view m_line;
+        std::string& m_buffer;
+        size_t m_pos = 0;
 
-            // Usage message
-            msg << "Usage:\n";
-            if (!subcommandNamesAndDesc.empty()) {
-                msg << std::string(usageColumn, ' ') << commandPath << " <command>\n";
-            }
-            if (!optionOrders.empty() || !positionalUsageMessages.empty()) {
-                msg << std::string(usageColumn, ' ') << commandPath;
-                if (!optionOrders.empty()) {
-                    msg << " [options]";
-                }
-                for (const auto& posUsage : positionalUsageMessages) {
-                    msg << " " << posUsage;
+        // Joins the pieces of a word, only copying once a piece does not directly follow the previous one
+        class Word {
+            std::string& m_buffer;
+            size_t m_start;
+            std::optional<std::string_view> m_view;
+            bool m_copying = false;
+
+        public:
+            explicit Word(std::string& buffer) : m_buffer(buffer), m_start(buffer.size()) {}
+
+            auto append(const std::string_view piece) -> void {
+                if (m_copying) {
+                    m_buffer.append(piece);
+                } else if (!m_view.has_value()) {
+                    m_view = piece;
+                } else if (m_view->data() + m_view->size() == piece.data()) {
+                    m_view = std::string_view(m_view->data(), m_view->size() + piece.size());
+                } else {
+                    m_buffer.append(m_view.value());
+                    m_buffer.append(piece);
+                    m_copying = true;
                 }
             }
-            if (subcommandNamesAndDesc.empty() && optionOrders.empty() && positionalUsageMessages.empty()) {
-                msg << std::string(usageColumn, ' ') << commandPath;
+
+            // Whether anything, including an empty quoted string, was appended
+            [[nodiscard]] auto has_value() const -> bool {
+                return m_copying || m_view.has_value();
             }
 
-            // Description
-            bool prevSectionSet = false;
-            if (!commandDescription.empty()) {
-                msg << "\n\nDescription:\n";
-                for (const auto descriptions = wrap_description(commandDescription, maxLineWidth - usageColumn);
-                        const auto& str : descriptions) {
-                    msg << std::string(usageColumn, ' ') << str << "\n";
+            [[nodiscard]] auto get() const -> std::string_view {
+                if (m_copying) return std::string_view(m_buffer).substr(m_start);
+                return m_view.value_or(std::string_view(m_buffer.data() + m_start, 0));
+            }
+        };
+
+        static auto is_whitespace(const char c) -> bool {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        auto read_single_quoted(Word& word) -> std::expected<void, SplitError> {
+            const size_t end = m_line.find('\'', m_pos);
+            if (end == std::string_view::npos) return std::unexpected(SplitError::UnterminatedSingleQuote);
+            word.append(m_line.substr(m_pos, end - m_pos));
+            m_pos = end + 1;
+            return {};
+        }
+
+        auto read_double_quoted(Word& word) -> std::expected<void, SplitError> {
+            while (true) {
+                const size_t end = find_double_quote_boundary(m_line, m_pos);
+                if (end == m_line.size()) return std::unexpected(SplitError::UnterminatedDoubleQuote);
+                word.append(m_line.substr(m_pos, end - m_pos));
+                m_pos = end + 1;
+                if (m_line[end] == '"') return {};
+
+                // Inside double quotes, a backslash only escapes '$', '`', '"', '\' and newline
+                if (m_pos == m_line.size()) return std::unexpected(SplitError::UnterminatedDoubleQuote);
+                switch (m_line[m_pos]) {
+                    case '\n':
+                        m_pos++;
+                        break;
+                    case '$': case '`': case '"': case '\\':
+                        word.append(m_line.substr(m_pos++, 1));
+                        break;
+                    default:
+                        word.append(m_line.substr(end, 1));
+                        break;
                 }
-                prevSectionSet = true;
             }
+        }
 
-            // Subcommands
-            if (!subcommandNamesAndDesc.empty()) {
-                if (prevSectionSet) {
-                    msg << "\n";
+    public:
+        CommandLineSplitter(const std::string_view line, std::string& buffer) : m_line(line), m_buffer(buffer) {
+            m_buffer.clear();
+            m_buffer.reserve(line.size());
+        }
+
+        [[nodiscard]] auto split() -> std::expected<std::vector<std::string_view>, SplitError> {
+            std::vector<std::string_view> words;
+            while (true) {
+                while (m_pos < m_line.size() && is_whitespace(m_line[m_pos])) m_pos++;
+                if (m_pos == m_line.size() || m_line[m_pos] == '#') return words;
+
+                Word word{m_buffer};
+                bool inWord = true;
+                while (inWord && m_pos < m_line.size()) {
+                    const size_t end = find_word_boundary(m_line, m_pos);
+                    if (end > m_pos) word.append(m_line.substr(m_pos, end - m_pos));
+                    m_pos = end;
+                    if (m_pos == m_line.size()) break;
+
+                    switch (m_line[m_pos++]) {
+                        case '\'':
+                            if (auto success = read_single_quoted(word); !success) return std::unexpected(success.error());
+                            break;
+                        case '"':
+                            if (auto success = read_double_quoted(word); !success) return std::unexpected(success.error());
+                            break;
+                        case '\\':
+                            if (m_pos == m_line.size()) return std::unexpected(SplitError::TrailingBackslash);
+                            // A backslash-newline joins lines, any other escaped character is taken literally
+                            if (m_line[m_pos] != '\n') word.append(m_line.substr(m_pos, 1));
+                            m_pos++;
+                            break;
+                        default:
+                            inWord = false;
+                            break;
+                    }
                 }
-                msg << "Commands:\n";
+                if (word.has_value()) words.push_back(word.get());
+            }
+        }
+    };
 
-                const size_t maxCmdName =
-                    std::min(maxDescriptionColumn, std::ranges::max(subcommandNamesAndDesc
-                        | std::views::keys
-                        | std::views::transform([](const auto& str) {
-                            return str.size();
-                        })));
-                const size_t descCol = std::min(maxDescriptionColumn, usageColumn + maxCmdName + bufferBetweenUsageAndDesc);
-                const size_t descriptionWrapWidth = maxLineWidth - descCol;
+    inline auto get_split_error_message(const SplitError error) -> std::string_view {
+        switch (error) {
+            case SplitError::UnterminatedSingleQuote: return "Unterminated single quote";
+            case SplitError::UnterminatedDoubleQuote: return "Unterminated double quote";
+            case SplitError::TrailingBackslash:       return "Unexpected end of line after '\\'";
+        }
+        return "Invalid command line";
+    }
+} // namespace argon::detail
 
-                for (const auto& [name, desc] : subcommandNamesAndDesc) {
-                    const auto wrapped = wrap_description(desc, descriptionWrapWidth);
-                    concat_name_and_desc(msg, name, wrapped, descCol);
+
+namespace argon::detail {
+    struct ConfigEntry {
+        std::string_view key;
+        std::string_view value;
+        size_t line;
+    };
+
+    struct ConfigSection {
+        std::string_view path;
+        std::span<const ConfigEntry> entries;
+    };
+
+    inline auto trim_whitespace(std::string_view str) -> std::string_view {
+        constexpr std::string_view whitespace = " \t\r";
+        const size_t begin = str.find_first_not_of(whitespace);
+        if (begin == std::string_view::npos) return {};
+        const size_t end = str.find_last_not_of(whitespace);
+        return str.substr(begin, end - begin + 1);
+    }
+
+    // Parses a subset of INI. Each '[section]' names a subcommand path such as 'remote.add', and entries before the
+    // first section belong to the root command. Keys and values are views into the mapped file.
+    class ConfigFile {
+        std::string m_path;
+        std::shared_ptr<const MappedFile> m_file;
+        std::unordered_map<std::string_view, std::vector<ConfigEntry>> m_sections;
+
+    public:
+        [[nodiscard]] static auto parse(const std::filesystem::path& path) -> std::expected<ConfigFile, std::string> {
+            auto file = MappedFile::open(path);
+            if (!file.has_value()) {
+                return std::unexpected(std::format("Unable to read config file: {}", file.error()));
+            }
+
+            ConfigFile config;
+            config.m_path = path.string();
+            config.m_file = std::make_shared<const MappedFile>(std::move(file.value()));
+
+            std::string_view section;
+            size_t lineNumber = 0;
+            for (const auto rawLine : config.m_file->contents() | std::views::split('\n')) {
+                lineNumber++;
+                const std::string_view line = trim_whitespace(std::string_view(rawLine.begin(), rawLine.end()));
+                if (line.empty() || line.starts_with('#') || line.starts_with(';')) continue;
+
+                if (line.starts_with('[')) {
+                    if (!line.ends_with(']')) {
+                        return std::unexpected(std::format(
+                            "Invalid section header in config file '{}' at line {}", config.m_path, lineNumber));
+                    }
+                    section = trim_whitespace(line.substr(1, line.size() - 2));
+                    continue;
                 }
-                prevSectionSet = true;
+
+                const size_t equals = line.find('=');
+                if (equals == std::string_view::npos) {
+                    return std::unexpected(std::format(
+                        "Expected 'key = value' in config file '{}' at line {}", config.m_path, lineNumber));
+                }
+                const std::string_view key = trim_whitespace(line.substr(0, equals));
+                std::string_view value = trim_whitespace(line.substr(equals + 1));
+                if (value.size() >= 2 && value.starts_with('"') && value.ends_with('"')) {
+                    value = value.substr(1, value.size() - 2);
+                }
+                if (key.empty()) {
+                    return std::unexpected(std::format(
+                        "Missing key in config file '{}' at line {}", config.m_path, lineNumber));
+                }
+                config.m_sections[section].emplace_back(key, value, lineNumber);
             }
+            return config;
+        }
 
-            // Calculate the column for the description
-            const size_t maxOptionUsageLen = optionUsageMessages.empty() ? 0 :
-                std::ranges::max(optionUsageMessages | std::views::transform([](const auto& str) { return str.size(); }));
-            const size_t maxPositionalUsageLen = positionalUsageMessages.empty() ? 0 :
-                std::ranges::max(positionalUsageMessages | std::views::transform([](const auto& str) { return str.size(); }));
-            const size_t maxUsageLen = std::max(maxOptionUsageLen, maxPositionalUsageLen);
+        [[nodiscard]] auto get_section(const std::string_view name) const -> std::optional<ConfigSection> {
+            const auto it = m_sections.find(name);
+            if (it == m_sections.end()) return std::nullopt;
+            return ConfigSection{ .path = m_path, .entries = it->second };
+        }
+    };
 
-            const size_t descCol = std::min(maxDescriptionColumn, usageColumn + maxUsageLen + bufferBetweenUsageAndDesc);
-            const size_t descriptionWrapWidth = maxLineWidth - descCol;
+    class ConfigFileApplier {
+        [[nodiscard]] static auto find_option(const Context& context, const std::string_view key)
+            -> std::optional<FlagOrderEntry> {
+            if (key.starts_with('-')) return context.find_named_option(key);
+            if (auto option = context.find_named_option(std::format("--{}", key))) return option;
+            return context.find_named_option(std::format("-{}", key));
+        }
 
-            const auto optionDescriptions = get_option_descriptions(context, descriptionWrapWidth);
-            const auto positionalDescriptions = get_positional_descriptions(context, descriptionWrapWidth);
+    public:
+        // Applies the entries of a section to the options that were not already set by a higher precedence source.
+        // Stops once maxErrors errors are found.
+        [[nodiscard]] static auto apply(Context& context, const ConfigSection& section, const size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> {
+            struct OptionValues {
+                FlagOrderEntry option;
+                size_t line;
+                std::vector<std::string_view> values;
+            };
+            std::vector<OptionValues> grouped;
+            std::vector<Error> errors;
+
+            for (const auto& [key, value, line] : section.entries) {
+                const auto option = find_option(context, key);
+                if (!option.has_value()) {
+                    errors.emplace_back(ErrorCode::Source, std::format(
+                        "Unknown option '{}' in config file '{}' at line {}", key, section.path, line));
+                    if (errors.size() >= maxErrors) return std::unexpected(std::move(errors));
+                    continue;
+                }
+                if (context.is_option_set(option.value())) continue;
 
-            // All non-positional usage and description messages
-            if (!optionOrders.empty()) {
-                if (prevSectionSet) {
-                    msg << "\n";
+                const auto it = std::ranges::find_if(grouped, [&option](const OptionValues& group) {
+                    return group.option.id == option->id;
+                });
+                if (it == grouped.end()) {
+                    grouped.emplace_back(option.value(), line, std::vector{value});
+                } else {
+                    it->values.push_back(value);
                 }
+            }
 
-                msg << "Options:\n";
-                for (size_t i = 0; i < optionOrders.size(); i++) {
-                    const auto& usage = optionUsageMessages[i];
-                    const auto& desc = optionDescriptions[i];
-                    concat_name_and_desc(msg, usage, desc, descCol);
+            for (const auto& [option, line, values] : grouped) {
+                if (errors.size() >= maxErrors) break;
+                if (auto success = context.set_option_values(option, values, maxErrors - errors.size()); !success) {
+                    for (Error& error : success.error()) {
+                        errors.emplace_back(std::move(error)
+                            .with_position(std::nullopt)
+                            .with_note(std::format("config file '{}', line {}", section.path, line)));
+                    }
                 }
-                prevSectionSet = true;
             }
 
-            // Positional usage and description messages
-            if (!positionalUsageMessages.empty()) {
-                if (prevSectionSet) {
-                    msg << "\n";
+            if (!errors.empty()) return std::unexpected(std::move(errors));
+            return {};
+        }
+    };
+} // namespace argon::detail
+
+
+namespace argon::detail {
+    [[nodiscard]] inline auto get_environment() -> char ** {
+#if defined(_WIN32)
+        return _environ;
+#elif defined(__APPLE__)
+        return *_NSGetEnviron();
+#elif defined(__unix__)
+        return environ;
+#else
+        return nullptr;
+#endif
+    }
+
+    // Name to value index over the process environment, built once per parse instead of calling getenv per option.
+    // Names and values are views into the environment block.
+    class EnvironmentIndex {
+        std::unordered_map<std::string_view, std::string_view> m_variables;
+
+    public:
+        EnvironmentIndex() {
+            for (char **env = get_environment(); env != nullptr && *env != nullptr; ++env) {
+                const std::string_view entry = *env;
+                // Windows stores per-drive directories as '=C:=C:\path', so the name starts after the first character
+                const size_t equals = entry.find('=', 1);
+                if (equals == std::string_view::npos) continue;
+                m_variables.try_emplace(entry.substr(0, equals), entry.substr(equals + 1));
+            }
+        }
+
+        [[nodiscard]] auto find(const std::string_view name) const -> std::optional<std::string_view> {
+            const auto it = m_variables.find(name);
+            if (it == m_variables.end()) return std::nullopt;
+            return it->second;
+        }
+    };
+
+    class EnvironmentApplier {
+    public:
+        // Applies bound environment variables to the options that were not already set by a higher precedence source.
+        // Multi-value options are given the comma separated values of the variable. Stops once maxErrors errors are
+        // found.
+        [[nodiscard]] static auto apply(Context& context, const size_t maxErrors)
+            -> std::expected<void, std::vector<Error>> {
+            const auto bindings = context.get_environment_bindings();
+            if (bindings.empty()) return {};
+
+            const EnvironmentIndex environment;
+            std::vector<Error> errors;
+            for (const auto& [option, variable] : bindings) {
+                if (errors.size() >= maxErrors) break;
+                if (context.is_option_set(option)) continue;
+                const auto value = environment.find(variable);
+                if (!value.has_value()) continue;
+
+                std::vector<std::string_view> values;
+                if (option.kind != FlagKind::MultiFlag) {
+                    values.push_back(value.value());
+                } else if (!value->empty()) {
+                    // An empty variable gives no values, so the implicit value is used
+                    for (const auto part : value.value() | std::views::split(',')) {
+                        values.emplace_back(trim_whitespace(std::string_view(part.begin(), part.end())));
+                    }
                 }
 
-                msg << "Positionals:\n";
-                for (size_t i = 0; i < positionalUsageMessages.size(); i++) {
-                    const auto& usage = positionalUsageMessages[i];
-                    const auto& desc = positionalDescriptions[i];
-                    concat_name_and_desc(msg, usage, desc, descCol);
+                if (auto success = context.set_option_values(option, values, maxErrors - errors.size()); !success) {
+                    for (Error& error : success.error()) {
+                        errors.emplace_back(std::move(error)
+                            .with_position(std::nullopt)
+                            .with_note(std::format("environment variable '{}'", variable)));
+                    }
                 }
             }
-            return msg.str();
+
+            if (!errors.empty()) return std::unexpected(std::move(errors));
+            return {};
         }
     };
 } // namespace argon::detail
@@ -1860,29 +5089,64 @@ namespace argon::detail {
 namespace argon::detail {
     class ArgvView {
         size_t m_pos = 0;
-        std::span<const char * const> m_argv;
+        // Shared with streamed multi-positionals, which read their values from it after the parse
+        std::shared_ptr<std::vector<std::string_view>> m_argv;
+        std::optional<size_t> m_removed;
 
     public:
-        ArgvView(const int argc, const char * const * argv) : m_argv(argv, argc) {}
+        ArgvView(const int argc, const char * const * argv)
+            : m_argv(std::make_shared<std::vector<std::string_view>>(argv, argv + argc)) {}
+
+        explicit ArgvView(std::vector<std::string_view> argv)
+            : m_argv(std::make_shared<std::vector<std::string_view>>(std::move(argv))) {}
+
+        [[nodiscard]] auto get_shared() const -> std::shared_ptr<const std::vector<std::string_view>> {
+            return m_argv;
+        }
 
         [[nodiscard]] auto get_pos() const -> size_t {
             return m_pos;
         }
 
         [[nodiscard]] auto size() const -> size_t {
-            return m_argv.size();
+            return m_argv->size();
         }
 
         [[nodiscard]] auto peek() const -> std::string_view {
-            return m_argv[m_pos];
+            return (*m_argv)[m_pos];
         }
 
         auto next() -> std::string_view {
-            return m_argv[m_pos++];
+            return (*m_argv)[m_pos++];
         }
 
         auto operator[](const size_t i) const -> std::string_view {
-            return m_argv[i];
+            return (*m_argv)[i];
+        }
+
+        // Removes the first argument equal to name before the end of options, keeping the positions of the others.
+        // Returns whether one was found.
+        auto remove_option(const std::string_view name) -> bool {
+            for (size_t i = m_pos; i < m_argv->size() && (*m_argv)[i] != "--"; ++i) {
+                if ((*m_argv)[i] != name) continue;
+                m_removed = i;
+                return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] auto is_removed(const size_t i) const -> bool {
+            return m_removed == i;
+        }
+
+        // Appends arguments that are always treated as positional values
+        auto append_positionals(const std::span<const std::string_view> args) -> void {
+            if (args.empty()) return;
+            if (m_argv.use_count() > 1) m_argv = std::make_shared<std::vector<std::string_view>>(*m_argv);
+            if (std::ranges::find(*m_argv | std::views::drop(m_pos), std::string_view("--")) == m_argv->end()) {
+                m_argv->emplace_back("--");
+            }
+            m_argv->insert(m_argv->end(), args.begin(), args.end());
         }
     };
 
@@ -1893,7 +5157,7 @@ namespace argon::detail {
 
     struct Token {
         TokenKind kind;
-        std::string image;
+        std::string_view image;
         size_t argvPosition;
     };
 
@@ -1902,40 +5166,54 @@ namespace argon::detail {
         return TokenKind::STRING;
     }
 
+    // Tokens are produced on demand from argv rather than materialized up front
     class Tokenizer {
-        std::vector<Token> m_tokens;
-        size_t m_pos = 0;
+        const ArgvView& m_argv;
+        size_t m_pos;
+        std::optional<std::pair<size_t, std::string_view>> m_resolved;
+
+        [[nodiscard]] auto make_token(const size_t i) const -> Token {
+            const std::string_view image = m_resolved.has_value() && m_resolved->first == i ? m_resolved->second : m_argv[i];
+            return Token {
+                .kind = token_kind_from_string(image),
+                .image = image,
+                .argvPosition = i,
+            };
+        }
+
+        auto skip_removed() -> void {
+            while (m_pos < m_argv.size() && m_argv.is_removed(m_pos)) ++m_pos;
+        }
 
     public:
-        explicit Tokenizer(const ArgvView& argv) {
-            for (size_t i = argv.get_pos(); i < argv.size(); i++) {
-                std::string image(argv[i]);
-                Token token {
-                    .kind = token_kind_from_string(image),
-                    .image = image,
-                    .argvPosition = i,
-                };
-                m_tokens.push_back(token);
-            }
+        explicit Tokenizer(const ArgvView& argv) : m_argv(argv), m_pos(argv.get_pos()) {
+            skip_removed();
         }
 
         [[nodiscard]] auto has_tokens() const -> bool {
-            return m_pos < m_tokens.size();
+            return m_pos < m_argv.size();
         }
 
         [[nodiscard]] auto peek_token() const -> std::optional<Token> {
             if (has_tokens()) {
-                return m_tokens[m_pos];
+                return make_token(m_pos);
             }
             return std::nullopt;
         }
 
         auto next_token() -> std::optional<Token> {
             if (has_tokens()) {
-                return m_tokens[m_pos++];
+                const Token token = make_token(m_pos++);
+                skip_removed();
+                return token;
             }
             return std::nullopt;
         }
+
+        // Reads the next token as image instead, such as the full name of an abbreviated flag
+        auto resolve_next_token(const std::string_view image) -> void {
+            m_resolved = std::pair{m_pos, image};
+        }
     };
 } // namespace argon::detail
 
@@ -1943,18 +5221,19 @@ namespace argon::detail {
 namespace argon::detail {
     struct AstContext;
 
+    // Tokens and AST values are views into argv, which outlives the parse
     struct AstValue {
-        std::string value;
+        std::string_view value;
         size_t argvPosition;
     };
 
     struct FlagAst {
-        std::string name;
+        std::string_view name;
         std::optional<AstValue> value;
     };
 
     struct MultiFlagAst {
-        std::string name;
+        std::string_view name;
         std::vector<AstValue> values;
     };
 
@@ -1964,15 +5243,19 @@ namespace argon::detail {
 
     struct MultiPositionalAst {
         std::vector<AstValue> values;
+        // The values of a streamed multi-positional are kept as runs of argv instead
+        std::vector<ArgvRun> streamedRuns;
+        size_t numStreamed = 0;
+        std::shared_ptr<const std::vector<std::string_view>> argv;
     };
 
     struct ChoiceAst {
-        std::string name;
+        std::string_view name;
         std::optional<AstValue> value;
     };
 
     struct MultiChoiceAst {
-        std::string name;
+        std::string_view name;
         std::vector<AstValue> values;
     };
 
@@ -1998,18 +5281,12 @@ namespace argon::detail {
             Tokenizer& tokenizer,
             const Context& context,
             bool (Context::*contains_flag_fn)(std::string_view) const
-        ) -> std::expected<Token, std::string> {
+        ) -> std::expected<Token, Error> {
             const auto flagName = tokenizer.peek_token();
-            if (!flagName) {
-                return std::unexpected(std::format("Expected flag name, however reached end of arguments"));
-            }
-            if (flagName->kind != TokenKind::STRING) {
-                return std::unexpected(
-                    std::format("Expected flag name at position {}, got '{}'", flagName->argvPosition, flagName->image));
-            }
-            if (!(context.*contains_flag_fn)(flagName->image)) {
-                return std::unexpected(
-                    std::format(R"(Unknown flag '{}' at position {})", flagName->image, flagName->argvPosition));
+            if (!flagName) return std::unexpected(Error(ErrorCode::UnknownFlag));
+            if (flagName->kind != TokenKind::STRING || !(context.*contains_flag_fn)(flagName->image)) {
+                return std::unexpected(Error(ErrorCode::UnknownFlag)
+                    .with_option(flagName->image).with_position(flagName->argvPosition));
             }
             tokenizer.next_token();
             return flagName.value();
@@ -2026,7 +5303,7 @@ namespace argon::detail {
             Tokenizer& tokenizer,
             const Context& context,
             AstContext& astContext
-        ) -> std::expected<void, std::string> {
+        ) -> std::expected<void, Error> {
             auto flagName = expect_flag_token(tokenizer, context, &Context::contains_flag);
             if (!flagName) return std::unexpected(std::move(flagName.error()));
             const auto flag = context.get_flag(flagName->image);
@@ -2041,8 +5318,8 @@ namespace argon::detail {
                     astContext.flags.emplace_back(std::move(flagAst));
                     return {};
                 }
-                return std::unexpected(
-                    std::format("Flag '{}' does not have an implicit value and no value was given", flagName->image));
+                return std::unexpected(Error(ErrorCode::MissingValue)
+                    .with_option(flagName->image).with_position(flagName->argvPosition));
             }
 
             FlagAst flagAst{
@@ -2060,7 +5337,7 @@ namespace argon::detail {
             Tokenizer& tokenizer,
             const Context& context,
             AstContext& astContext
-        ) -> std::expected<void, std::string> {
+        ) -> std::expected<void, Error> {
             auto flagName = expect_flag_token(tokenizer, context, &Context::contains_multi_flag);
             if (!flagName) return std::unexpected(std::move(flagName.error()));
 
@@ -2074,8 +5351,8 @@ namespace argon::detail {
 
             if (const auto flag = context.get_multi_flag(flagName->image);
                 flagAst.values.empty() && !flag->is_implicit_set()) {
-                return std::unexpected(
-                    std::format("Flag '{}' does not have an implicit value and no value was given", flagName->image));
+                return std::unexpected(Error(ErrorCode::MissingValue)
+                    .with_option(flagName->image).with_position(flagName->argvPosition));
             }
             astContext.multiFlags.push_back(std::move(flagAst));
             return {};
@@ -2085,11 +5362,9 @@ namespace argon::detail {
             Tokenizer& tokenizer,
             const Context& context,
             AstContext& astContext
-        ) -> std::expected<void, std::string> {
+        ) -> std::expected<void, Error> {
             const auto value = tokenizer.peek_token();
-            if (!value) {
-                return std::unexpected(std::format("Expected positional argument, however reached end of arguments"));
-            }
+            if (!value) return {};
 
             PositionalAst positionalAst{ .value = AstValue {
                 .value = value->image,
@@ -2099,15 +5374,23 @@ namespace argon::detail {
             if (astContext.positionals.size() >= context.get_num_positionals()) {
                 if (context.contains_multi_positional()) {
                     tokenizer.next_token();
+                    if (context.get_multi_positional_ptr()->is_streamed()) {
+                        MultiPositionalAst& multiPositional = astContext.multiPositional;
+                        const size_t count = multiPositional.numStreamed++;
+                        const auto& runs = multiPositional.streamedRuns;
+                        if (runs.empty() || runs.back().argvBegin + (count - runs.back().valuesBegin) != value->argvPosition) {
+                            multiPositional.streamedRuns.push_back({.argvBegin = value->argvPosition, .valuesBegin = count});
+                        }
+                        return {};
+                    }
                     astContext.multiPositional.values.emplace_back(AstValue {
                         .value = value->image,
                         .argvPosition = value->argvPosition
                     });
                     return {};
                 }
-                return std::unexpected(std::format(
-                        "Unexpected token '{}' found at position {}, too many positional arguments specified",
-                        value->image, value->argvPosition));
+                return std::unexpected(Error(ErrorCode::TooManyPositionals)
+                    .with_value(value->image).with_position(value->argvPosition));
             }
             tokenizer.next_token();
 
@@ -2122,7 +5405,7 @@ namespace argon::detail {
             Tokenizer& tokenizer,
             const Context& context,
             AstContext& astContext
-        ) -> std::expected<void, std::string> {
+        ) -> std::expected<void, Error> {
             auto choiceName = expect_flag_token(tokenizer, context, &Context::contains_choice);
             if (!choiceName) return std::unexpected(std::move(choiceName.error()));
             const auto choice = context.get_choice(choiceName->image);
@@ -2137,8 +5420,8 @@ namespace argon::detail {
                     astContext.choices.emplace_back(std::move(choiceAst));
                     return {};
                 }
-                return std::unexpected(
-                    std::format("Flag '{}' does not have an implicit value and no value was given", choiceName->image));
+                return std::unexpected(Error(ErrorCode::MissingValue)
+                    .with_option(choiceName->image).with_position(choiceName->argvPosition));
             }
 
             ChoiceAst choiceAst{
@@ -2156,7 +5439,7 @@ namespace argon::detail {
             Tokenizer& tokenizer,
             const Context& context,
             AstContext& astContext
-        ) -> std::expected<void, std::string> {
+        ) -> std::expected<void, Error> {
             auto flagName = expect_flag_token(tokenizer, context, &Context::contains_multi_choice);
             if (!flagName) return std::unexpected(std::move(flagName.error()));
 
@@ -2170,14 +5453,14 @@ namespace argon::detail {
 
             if (const auto flag = context.get_multi_choice(flagName->image);
                 multiChoiceAst.values.empty() && !flag->is_implicit_set()) {
-                return std::unexpected(
-                    std::format("Flag '{}' does not have an implicit value and no value was given", flagName->image));
+                return std::unexpected(Error(ErrorCode::MissingValue)
+                    .with_option(flagName->image).with_position(flagName->argvPosition));
             }
             astContext.multiChoices.push_back(std::move(multiChoiceAst));
             return {};
         }
 
-        [[nodiscard]] static auto parse_root(Tokenizer& tokenizer, const Context& context) -> std::expected<AstContext, std::string> {
+        [[nodiscard]] static auto parse_root(Tokenizer& tokenizer, const Context& context) -> std::expected<AstContext, Error> {
             AstContext astContext;
             while (const auto optToken = tokenizer.peek_token()) {
                 if (optToken->kind == TokenKind::DOUBLE_DASH) {
@@ -2202,9 +5485,15 @@ namespace argon::detail {
                         return std::unexpected(std::move(success.error()));
                 }
                 else if (looks_like_flag(optToken->image)) {
-                    return std::unexpected(std::format(
-                        "Unknown flag '{}' at position",
-                        optToken->image, optToken->argvPosition));
+                    if (const auto matches = context.find_abbreviation(optToken->image); matches.size() == 1) {
+                        tokenizer.resolve_next_token(matches.front());
+                        continue;
+                    } else if (matches.size() > 1) {
+                        return std::unexpected(Error(ErrorCode::AmbiguousFlag, quote_names(matches))
+                            .with_option(optToken->image).with_position(optToken->argvPosition));
+                    }
+                    return std::unexpected(Error(ErrorCode::UnknownFlag).with_candidates(context.get_option_names())
+                        .with_option(optToken->image).with_position(optToken->argvPosition));
                 } else {
                     if (auto success = parse_positional_ast(tokenizer, context, astContext); !success)
                         return std::unexpected(std::move(success.error()));
@@ -2214,52 +5503,84 @@ namespace argon::detail {
         }
 
     public:
+        // Finds a built-in option before the end of options without parsing anything else, so that it is recognized
+        // even if the rest of the command line is invalid. Values never look like flags, so any matching token is one.
+        [[nodiscard]] static auto find_builtin_flag(const ArgvView& argv, const Context& context)
+            -> std::optional<BuiltinFlag> {
+            if (!context.has_builtin_flags()) return std::nullopt;
+            Tokenizer tokenizer{argv};
+            while (const auto token = tokenizer.next_token()) {
+                if (token->kind == TokenKind::DOUBLE_DASH) break;
+                if (const auto builtin = context.find_builtin_flag(token->image)) return builtin;
+            }
+            return std::nullopt;
+        }
+
         [[nodiscard]] static auto build(
             const ArgvView& argv,
             const Context& context
-        ) -> std::expected<AstContext, std::string> {
+        ) -> std::expected<AstContext, Error> {
             Tokenizer tokenizer{argv};
-            return parse_root(tokenizer, context);
+            auto ast = parse_root(tokenizer, context);
+            if (ast.has_value() && ast->multiPositional.numStreamed != 0) ast->multiPositional.argv = argv.get_shared();
+            return ast;
         }
     };
 } // namespace argon::detail
 
 
 namespace argon::detail {
-    struct AnalysisError_UnknownFlag {
-        std::string name;
-    };
+    // What an incremental parse remembers between runs of one command, so that an option given the same words again
+    // keeps its values and errors instead of being converted again
+    struct ParseMemo {
+        struct CachedError {
+            Error error;
+            size_t occurrence;
+            // The index of the word the error is about, whose position in argv can change between runs
+            std::optional<size_t> word;
+        };
 
-    struct AnalysisError_Conversion {
-        std::string errorMsg;
-    };
+        struct OptionEntry {
+            // The values refer to these words, so they must not move while the entry is kept
+            std::vector<std::string> words;
+            // Where the words of each occurrence of the option end
+            std::vector<size_t> occurrenceEnds;
+            std::vector<CachedError> errors;
+        };
+
+        std::optional<UniqueId> command;
+        std::unordered_map<UniqueId, OptionEntry> options;
+        // Which options were set when the constraints were last evaluated, and the errors of each constraint
+        std::vector<bool> presence;
+        std::vector<std::vector<Error>> constraintErrors;
 
-    struct AnalysisError_TooManyPositionals {
-        size_t max;
-        size_t actual;
+        auto reset(const UniqueId& commandId) -> void {
+            command = commandId;
+            options.clear();
+            presence.clear();
+            constraintErrors.clear();
+        }
     };
 
-    using AnalysisError = std::variant<
-        AnalysisError_UnknownFlag,
-        AnalysisError_Conversion,
-        AnalysisError_TooManyPositionals
-    >;
+    class AstAnalyzer {
+        // The category of an AST entry and its index, which order errors the same way analyze does
+        using OccurrenceKey = std::pair<size_t, size_t>;
 
-    [[nodiscard]] inline auto format_analysis_error(const AnalysisError& error) -> std::string {
-        return std::visit([]<typename T>(const T& err) -> std::string{
-            if constexpr (std::is_same_v<T, AnalysisError_UnknownFlag>) {
-                return std::format("Unknown flag '{}'", err.name);
-            } else if constexpr (std::is_same_v<T, AnalysisError_Conversion>) {
-                return err.errorMsg;
-            } else if constexpr (std::is_same_v<T, AnalysisError_TooManyPositionals>) {
-                return std::format("Max of {} positional arguments, however {} encountered", err.max, err.actual);
-            } else {
-                throw std::invalid_argument("Unadded type to format_analysis_error");
-            }
-        }, error);
-    }
+        struct KeyedError {
+            OccurrenceKey key;
+            Error error;
+        };
+
+        // The words given to one option by each of its occurrences. setValue sets the words of one occurrence and
+        // gives errors about a single word the index of that word as their position.
+        struct OptionInput {
+            UniqueId id;
+            std::function<std::vector<Error>(std::span<const std::string_view> words)> setValue;
+            std::vector<AstValue> values;
+            std::vector<size_t> occurrenceEnds;
+            std::vector<OccurrenceKey> keys;
+        };
 
-    class AstAnalyzer {
         static auto to_string_views(const std::vector<AstValue>& values) -> std::vector<std::string_view> {
             return values
                 | std::views::transform([](const AstValue& value) -> std::string_view
@@ -2267,30 +5588,32 @@ namespace argon::detail {
                 | std::ranges::to<std::vector<std::string_view>>();
         }
 
-        static auto append_conversion_errors(
-            std::vector<std::string> errorMsgs,
-            std::vector<AnalysisError>& errors
+        // Errors about a single value hold its index in values, which is replaced by its position in argv
+        static auto append_value_errors(
+            std::vector<Error> valueErrors,
+            const std::vector<AstValue>& values,
+            std::vector<Error>& errors
         ) -> void {
-            const auto conversionErrors =
-                errorMsgs
-                | std::views::transform([] (std::string& error) -> AnalysisError_Conversion {
-                    return { .errorMsg = std::move(error) };
-                })
-                | std::ranges::to<std::vector<AnalysisError_Conversion>>();
-
-            errors.insert(errors.end(), conversionErrors.begin(), conversionErrors.end());
+            for (Error& error : valueErrors) {
+                if (const auto index = error.position(); index.has_value() && index.value() < values.size()) {
+                    error.with_position(values[index.value()].argvPosition);
+                }
+                errors.emplace_back(std::move(error));
+            }
         }
 
         template <typename AstVec, typename GetOption>
         static auto process_single_value_option(
             const AstVec& asts,
-            std::vector<AnalysisError>& analysisErrors,
+            std::vector<Error>& errors,
+            const size_t maxErrors,
             GetOption getOption
         ) -> void {
             for (const auto& [name, value] : asts) {
+                if (errors.size() >= maxErrors) return;
                 const auto opt = getOption(name);
                 if (!opt) {
-                    analysisErrors.emplace_back(AnalysisError_UnknownFlag { .name = name });
+                    errors.emplace_back(Error(ErrorCode::UnknownFlag).with_option(name));
                     continue;
                 }
 
@@ -2298,7 +5621,8 @@ namespace argon::detail {
                     std::optional<std::string_view>{value->value} :
                     std::optional<std::string_view>{std::nullopt});
                 if (!setValue) {
-                    analysisErrors.emplace_back(AnalysisError_Conversion{ .errorMsg = std::move(setValue.error()) });
+                    if (value.has_value()) setValue.error().with_position(value->argvPosition);
+                    errors.emplace_back(std::move(setValue.error()));
                 }
             }
         }
@@ -2306,82 +5630,256 @@ namespace argon::detail {
         template <typename AstVec, typename GetOption>
         static auto process_multi_value_option(
             const AstVec& asts,
-            std::vector<AnalysisError>& errors,
+            std::vector<Error>& errors,
+            const size_t maxErrors,
             GetOption getOption
         ) -> void{
             for (const auto& [name, values] : asts) {
+                if (errors.size() >= maxErrors) return;
                 const auto opt = getOption(name);
                 if (!opt) {
-                    errors.emplace_back(AnalysisError_UnknownFlag { .name = name });
+                    errors.emplace_back(Error(ErrorCode::UnknownFlag).with_option(name));
                     continue;
                 }
 
                 const auto valueViews = to_string_views(values);
-                if (auto success = opt->set_value(valueViews); !success) {
-                    append_conversion_errors(std::move(success.error()), errors);
+                if (auto success = opt->set_value(valueViews, maxErrors - errors.size()); !success) {
+                    append_value_errors(std::move(success.error()), values, errors);
                 }
             }
         }
 
         static auto process_positionals(
             const std::vector<PositionalAst>& positionals,
-            std::vector<AnalysisError>& errors,
+            std::vector<Error>& errors,
+            const size_t maxErrors,
             Context& context
         ) -> void {
             for (size_t i = 0; i < positionals.size() && i < context.get_num_positionals(); ++i) {
+                if (errors.size() >= maxErrors) return;
                 const auto opt = context.get_positional(i);
                 if (!opt) continue;
                 if (auto success = opt->set_value(positionals[i].value.value); !success) {
-                    errors.emplace_back(AnalysisError_Conversion{ .errorMsg = std::move(success.error()) });
+                    errors.emplace_back(std::move(success.error()).with_position(positionals[i].value.argvPosition));
                 }
             }
-            if (positionals.size() > context.get_num_positionals()) {
-                errors.emplace_back(AnalysisError_TooManyPositionals{
-                    .max = context.get_num_positionals(),
-                    .actual = positionals.size()
-                });
+            if (positionals.size() > context.get_num_positionals() && errors.size() < maxErrors) {
+                const AstValue& extra = positionals[context.get_num_positionals()].value;
+                errors.emplace_back(Error(ErrorCode::TooManyPositionals)
+                    .with_value(extra.value).with_position(extra.argvPosition));
             }
         }
 
+        static auto set_streamed_runs(const MultiPositionalAst& multiPositional, Context& context) -> void {
+            if (multiPositional.numStreamed == 0) return;
+            context.get_multi_positional_ptr()->set_streamed_runs(
+                multiPositional.argv, multiPositional.streamedRuns, multiPositional.numStreamed);
+        }
+
         static auto process_multi_positionals(
             const MultiPositionalAst& multiPositional,
-            std::vector<AnalysisError>& errors,
+            std::vector<Error>& errors,
+            const size_t maxErrors,
             Context& context
         ) -> void {
-            if (multiPositional.values.empty()) return;
+            set_streamed_runs(multiPositional, context);
+            if (multiPositional.values.empty() || errors.size() >= maxErrors) return;
             const auto multiPos = context.get_multi_positional_ptr();
             if (!multiPos) return;
             const auto values = to_string_views(multiPositional.values);
-            if (auto success = multiPos->set_value(values); !success) {
-                append_conversion_errors(std::move(success.error()), errors);
+            if (auto success = multiPos->set_value(values, maxErrors - errors.size()); !success) {
+                append_value_errors(std::move(success.error()), multiPositional.values, errors);
+            }
+        }
+
+        template <typename Option>
+        static auto single_value_setter(Option *opt) {
+            return [opt](const std::span<const std::string_view> words) -> std::vector<Error> {
+                auto success = opt->set_value(words.empty()
+                    ? std::optional<const std::string_view>{std::nullopt}
+                    : std::optional<const std::string_view>{words.front()});
+                if (success.has_value()) return {};
+                if (!words.empty()) success.error().with_position(0);
+                return std::vector{std::move(success.error())};
+            };
+        }
+
+        template <typename Option>
+        static auto multi_value_setter(Option *opt, const size_t maxErrors) {
+            return [opt, maxErrors](const std::span<const std::string_view> words) -> std::vector<Error> {
+                auto success = opt->set_value(words, maxErrors);
+                if (success.has_value()) return {};
+                return std::move(success.error());
+            };
+        }
+
+        static auto add_occurrence(
+            std::vector<OptionInput>& inputs,
+            std::unordered_map<UniqueId, size_t>& indices,
+            const UniqueId& id,
+            const std::span<const AstValue> values,
+            const OccurrenceKey key,
+            std::function<std::vector<Error>(std::span<const std::string_view> words)> setValue
+        ) -> void {
+            const auto [it, inserted] = indices.try_emplace(id, inputs.size());
+            if (inserted) inputs.push_back(OptionInput{.id = id, .setValue = std::move(setValue)});
+            OptionInput& input = inputs[it->second];
+            input.values.insert(input.values.end(), values.begin(), values.end());
+            input.occurrenceEnds.push_back(input.values.size());
+            input.keys.push_back(key);
+        }
+
+        // Groups the entries of the AST by option. Entries that name no option become errors.
+        static auto collect_inputs(
+            const AstContext& ast,
+            Context& context,
+            const size_t maxErrors,
+            std::vector<KeyedError>& errors
+        ) -> std::vector<OptionInput> {
+            std::vector<OptionInput> inputs;
+            std::unordered_map<UniqueId, size_t> indices;
+
+            const auto addNamed = [&](const auto& asts, const size_t category, auto getOption, auto makeSetter) {
+                for (size_t i = 0; i < asts.size(); ++i) {
+                    const auto& entry = asts[i];
+                    const auto opt = getOption(entry.name);
+                    if (!opt) {
+                        errors.push_back({{category, i}, Error(ErrorCode::UnknownFlag).with_option(entry.name)});
+                        continue;
+                    }
+                    std::span<const AstValue> values;
+                    if constexpr (requires { entry.values; }) {
+                        values = entry.values;
+                    } else if (entry.value.has_value()) {
+                        values = std::span(&entry.value.value(), 1);
+                    }
+                    add_occurrence(inputs, indices, context.find_named_option(entry.name)->id, values, {category, i},
+                        makeSetter(opt));
+                }
+            };
+            const auto singleSetter = [](auto *opt) { return single_value_setter(opt); };
+            const auto multiSetter = [maxErrors](auto *opt) { return multi_value_setter(opt, maxErrors); };
+
+            addNamed(ast.flags, 0, [&context](const std::string_view name) { return context.get_flag(name); },
+                singleSetter);
+            addNamed(ast.multiFlags, 1,
+                [&context](const std::string_view name) { return context.get_multi_flag(name); }, multiSetter);
+
+            for (size_t i = 0; i < ast.positionals.size() && i < context.get_num_positionals(); ++i) {
+                const auto opt = context.get_positional(i);
+                if (!opt) continue;
+                add_occurrence(inputs, indices, context.get_positional_id(i), std::span(&ast.positionals[i].value, 1),
+                    {2, i}, single_value_setter(opt));
+            }
+            if (ast.positionals.size() > context.get_num_positionals()) {
+                const AstValue& extra = ast.positionals[context.get_num_positionals()].value;
+                errors.push_back({{2, context.get_num_positionals()}, Error(ErrorCode::TooManyPositionals)
+                    .with_value(extra.value).with_position(extra.argvPosition)});
+            }
+
+            const auto multiPos = context.get_multi_positional_ptr();
+            if (multiPos && !ast.multiPositional.values.empty()) {
+                add_occurrence(inputs, indices, context.get_multi_positional_with_id()->first,
+                    ast.multiPositional.values, {3, 0}, multi_value_setter(multiPos, maxErrors));
+            }
+
+            addNamed(ast.choices, 4, [&context](const std::string_view name) { return context.get_choice(name); },
+                singleSetter);
+            addNamed(ast.multiChoices, 5,
+                [&context](const std::string_view name) { return context.get_multi_choice(name); }, multiSetter);
+            return inputs;
+        }
+
+        // Copies the words of input into entry and sets the option from them, so that values which refer to the words
+        // stay valid for as long as the entry is kept
+        static auto convert_input(const OptionInput& input, ParseMemo::OptionEntry& entry, const size_t maxErrors)
+            -> void {
+            for (const AstValue& value : input.values) entry.words.emplace_back(value.value);
+            entry.occurrenceEnds = input.occurrenceEnds;
+            const std::vector<std::string_view> words(entry.words.begin(), entry.words.end());
+
+            size_t begin = 0;
+            for (size_t occurrence = 0; occurrence < entry.occurrenceEnds.size(); ++occurrence) {
+                if (entry.errors.size() >= maxErrors) break;
+                const size_t count = entry.occurrenceEnds[occurrence] - begin;
+                for (Error& error : input.setValue(std::span(words).subspan(begin, count))) {
+                    std::optional<size_t> word;
+                    if (const auto index = error.position(); index.has_value() && index.value() < count) {
+                        word = begin + index.value();
+                    }
+                    entry.errors.push_back({std::move(error), occurrence, word});
+                }
+                begin = entry.occurrenceEnds[occurrence];
             }
         }
 
     public:
+        // Converts the values of every option, stopping once maxErrors errors are found
         [[nodiscard]] static auto analyze(
             const AstContext& ast,
-            Context& context
-        ) -> std::expected<void, std::vector<std::string>> {
-            std::vector<AnalysisError> analysisErrors;
+            Context& context,
+            const size_t maxErrors
+        ) -> std::expected<void, std::vector<Error>> {
+            std::vector<Error> errors;
 
-            process_single_value_option(ast.flags, analysisErrors,
+            process_single_value_option(ast.flags, errors, maxErrors,
                 [&context](const std::string_view name) { return context.get_flag(name); });
-            process_multi_value_option(ast.multiFlags, analysisErrors,
+            process_multi_value_option(ast.multiFlags, errors, maxErrors,
                 [&context](const std::string_view name) { return context.get_multi_flag(name); });
-            process_positionals(ast.positionals, analysisErrors, context);
-            process_multi_positionals(ast.multiPositional, analysisErrors, context);
-            process_single_value_option(ast.choices, analysisErrors,
+            process_positionals(ast.positionals, errors, maxErrors, context);
+            process_multi_positionals(ast.multiPositional, errors, maxErrors, context);
+            process_single_value_option(ast.choices, errors, maxErrors,
                 [&context](const std::string_view name) { return context.get_choice(name); });
-            process_multi_value_option(ast.multiChoices, analysisErrors,
+            process_multi_value_option(ast.multiChoices, errors, maxErrors,
                 [&context](const std::string_view name) { return context.get_multi_choice(name); });
 
-            if (!analysisErrors.empty()) {
-                return std::unexpected(std::views::transform(analysisErrors, [](const AnalysisError& error) -> std::string
-                    { return format_analysis_error(error); })
-                | std::ranges::to<std::vector>());
-            }
+            if (!errors.empty()) return std::unexpected(std::move(errors));
             return {};
         }
+
+        // Like analyze, but options given the same words as in the run that memo remembers keep their values and
+        // errors, and only the others are converted. Options that are not given are unset.
+        [[nodiscard]] static auto analyze_incremental(
+            const AstContext& ast,
+            Context& context,
+            const size_t maxErrors,
+            ParseMemo& memo
+        ) -> std::expected<void, std::vector<Error>> {
+            std::vector<KeyedError> keyedErrors;
+            const std::vector<OptionInput> inputs = collect_inputs(ast, context, maxErrors, keyedErrors);
+
+            std::unordered_map<UniqueId, ParseMemo::OptionEntry> entries;
+            std::unordered_set<UniqueId> unchanged;
+            for (const OptionInput& input : inputs) {
+                const auto it = memo.options.find(input.id);
+                if (it == memo.options.end() || it->second.occurrenceEnds != input.occurrenceEnds
+                    || !std::ranges::equal(it->second.words, input.values, {}, {}, &AstValue::value)) {
+                    continue;
+                }
+                entries.insert(memo.options.extract(it));
+                unchanged.insert(input.id);
+            }
+            context.clear_values_except(unchanged);
+            set_streamed_runs(ast.multiPositional, context);
+
+            for (const OptionInput& input : inputs) {
+                const auto [it, inserted] = entries.try_emplace(input.id);
+                if (inserted) convert_input(input, it->second, maxErrors);
+                for (const auto& [error, occurrence, word] : it->second.errors) {
+                    Error& added = keyedErrors.emplace_back(input.keys[occurrence], error).error;
+                    if (word.has_value()) added.with_position(input.values[word.value()].argvPosition);
+                }
+            }
+            memo.options = std::move(entries);
+
+            if (keyedErrors.empty()) return {};
+            std::ranges::stable_sort(keyedErrors, {}, &KeyedError::key);
+            std::vector<Error> errors;
+            for (KeyedError& keyed : keyedErrors | std::views::take(std::min(keyedErrors.size(), maxErrors))) {
+                errors.emplace_back(std::move(keyed.error));
+            }
+            return std::unexpected(std::move(errors));
+        }
     };
 } // namespace argon::detail
 
@@ -2406,6 +5904,7 @@ namespace argon {
         std::unordered_map<detail::UniqueId, const detail::Polymorphic<detail::MultiPositionalBase>*> m_multiPositionals{};
         std::unordered_map<detail::UniqueId, const detail::Polymorphic<detail::ChoiceBase>*> m_choices{};
         std::unordered_map<detail::UniqueId, const detail::Polymorphic<detail::MultiChoiceBase>*> m_multiChoices{};
+        const detail::Context *m_context;
 
         friend class detail::ConstraintValidator;
         template <typename T> friend class Command;
@@ -2471,7 +5970,8 @@ namespace argon {
               m_positionals(init_positionals(context)),
               m_multiPositionals(init_multi_positionals(context)),
               m_choices(init_choices(context)),
-              m_multiChoices(init_multi_choices(context)) {}
+              m_multiChoices(init_multi_choices(context)),
+              m_context(&context) {}
 
         [[nodiscard]] auto get_flag_base(const detail::UniqueId id) const -> const detail::FlagBase * {
             const auto it = m_flags.find(id);
@@ -2521,7 +6021,25 @@ namespace argon {
             return it->second->get();
         }
 
+        template <typename T, typename HandleTag>
+        [[nodiscard]] auto has_default(const Handle<CommandTag, T, HandleTag>& handle) const -> bool {
+            if constexpr (std::is_same_v<HandleTag, FlagTag>) return get_flag_base(handle.get_id())->has_default();
+            else if constexpr (std::is_same_v<HandleTag, MultiFlagTag>) return get_multi_flag_base(handle.get_id())->has_default();
+            else if constexpr (std::is_same_v<HandleTag, PositionalTag>) return get_positional_base(handle.get_id())->has_default();
+            else if constexpr (std::is_same_v<HandleTag, MultiPositionalTag>) return get_multi_positional_base(handle.get_id())->has_default();
+            else if constexpr (std::is_same_v<HandleTag, ChoiceTag>) return get_choice_base(handle.get_id())->has_default();
+            else return get_multi_choice_base(handle.get_id())->has_default();
+        }
+
     public:
+        template <typename T, typename HandleTag> requires IsArgumentHandle<Handle<CommandTag, T, HandleTag>>
+        [[nodiscard]] auto get_source(const Handle<CommandTag, T, HandleTag>& handle) const -> ValueSource {
+            if (const auto source = m_context->get_value_source(handle.get_id()); source.has_value()) {
+                return source.value();
+            }
+            return has_default(handle) ? ValueSource::Default : ValueSource::None;
+        }
+
         template <typename T>
         [[nodiscard]] auto is_specified(const FlagHandle<CommandTag, T>& handle) const -> bool {
             const auto base = get_flag_base(handle.get_id());
@@ -2559,12 +6077,15 @@ namespace argon {
         }
 
         template <typename T>
-        [[nodiscard]] auto get(const FlagHandle<CommandTag, T>& handle) const -> std::optional<T> {
+        [[nodiscard]] auto try_get(const FlagHandle<CommandTag, T>& handle) const -> std::expected<std::optional<T>, Error> {
             const auto base = get_flag_base(handle.get_id());
             const auto value = dynamic_cast<const Flag<T>*>(base);
             if (!value) {
                 throw std::logic_error("Internal error: flag type mismatch");
             }
+            if (auto resolved = value->resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(std::move(resolved.error()));
+            }
             const auto& storedValue = value->get_value();
             const auto& defaultValue = value->get_default_value();
             if (storedValue != std::nullopt) {
@@ -2577,12 +6098,16 @@ namespace argon {
         }
 
         template <typename T>
-        [[nodiscard]] auto get(const MultiFlagHandle<CommandTag, T>& handle) const -> std::vector<T> {
+        [[nodiscard]] auto try_get(const MultiFlagHandle<CommandTag, T>& handle) const
+            -> std::expected<std::vector<T>, std::vector<Error>> {
             const auto base = get_multi_flag_base(handle.get_id());
             const auto value = dynamic_cast<const MultiFlag<T>*>(base);
             if (!value) {
                 throw std::logic_error("Internal error: multi-flag type mismatch");
             }
+            if (auto resolved = value->resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(std::move(resolved.error()));
+            }
             const auto& storedValue = value->get_value();
             const auto& defaultValue = value->get_default_value();
             if (!storedValue.empty()) {
@@ -2595,24 +6120,36 @@ namespace argon {
         }
 
         template <typename T>
-        [[nodiscard]] auto get(const PositionalHandle<CommandTag, T>& handle) const -> std::optional<T> {
+        [[nodiscard]] auto try_get(const PositionalHandle<CommandTag, T>& handle) const -> std::expected<std::optional<T>, Error> {
             const auto base = get_positional_base(handle.get_id());
             const auto value = dynamic_cast<const Positional<T>*>(base);
             if (!value) {
                 throw std::logic_error("Internal error: positional type mismatch");
             }
+            if (auto resolved = value->resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(std::move(resolved.error()));
+            }
             const auto& storedValue = value->get_value();
             const auto& defaultValue = value->get_default_value();
             return storedValue ? storedValue : defaultValue;
         }
 
         template <typename T>
-        [[nodiscard]] auto get(const MultiPositionalHandle<CommandTag, T>& handle) const -> std::vector<T> {
+        [[nodiscard]] auto try_get(const MultiPositionalHandle<CommandTag, T>& handle) const
+            -> std::expected<std::vector<T>, std::vector<Error>> {
             const auto base = get_multi_positional_base(handle.get_id());
             const auto value = dynamic_cast<const MultiPositional<T>*>(base);
             if (!value) {
                 throw std::logic_error("Internal error: multi-positional type mismatch");
             }
+            if (value->m_streaming) {
+                throw std::logic_error(std::format(
+                    "Multi-positional '{}' is streamed, its values must be accessed with Results::stream",
+                    value->get_name()));
+            }
+            if (auto resolved = value->resolve_deferred_value(); !resolved.has_value()) {
+                return std::unexpected(std::move(resolved.error()));
+            }
             const auto& storedValue = value->get_value();
             const auto& defaultValue = value->get_default_value();
             if (!storedValue.empty()) {
@@ -2624,6 +6161,49 @@ namespace argon {
             return std::vector<T>{};
         }
 
+        template <typename T>
+        [[nodiscard]] auto stream(const MultiPositionalHandle<CommandTag, T>& handle) const -> detail::ValueStream<T> {
+            const auto base = get_multi_positional_base(handle.get_id());
+            const auto value = dynamic_cast<const MultiPositional<T>*>(base);
+            if (!value) {
+                throw std::logic_error("Internal error: multi-positional type mismatch");
+            }
+            if (!value->m_streaming) {
+                throw std::logic_error(std::format(
+                    "Multi-positional '{}' is not streamed, enable it with MultiPositional::with_streaming",
+                    value->get_name()));
+            }
+            return detail::ValueStream<T>{value};
+        }
+
+        template <typename T>
+        [[nodiscard]] auto get(const FlagHandle<CommandTag, T>& handle) const -> std::optional<T> {
+            auto value = try_get(handle);
+            if (!value.has_value()) throw ConversionError(std::vector{std::move(value.error())});
+            return std::move(value.value());
+        }
+
+        template <typename T>
+        [[nodiscard]] auto get(const MultiFlagHandle<CommandTag, T>& handle) const -> std::vector<T> {
+            auto values = try_get(handle);
+            if (!values.has_value()) throw ConversionError(std::move(values.error()));
+            return std::move(values.value());
+        }
+
+        template <typename T>
+        [[nodiscard]] auto get(const PositionalHandle<CommandTag, T>& handle) const -> std::optional<T> {
+            auto value = try_get(handle);
+            if (!value.has_value()) throw ConversionError(std::vector{std::move(value.error())});
+            return std::move(value.value());
+        }
+
+        template <typename T>
+        [[nodiscard]] auto get(const MultiPositionalHandle<CommandTag, T>& handle) const -> std::vector<T> {
+            auto values = try_get(handle);
+            if (!values.has_value()) throw ConversionError(std::move(values.error()));
+            return std::move(values.value());
+        }
+
         template <typename T>
         [[nodiscard]] auto get(const ChoiceHandle<CommandTag, T>& handle) const -> std::optional<T> {
             const auto base = get_choice_base(handle.get_id());
@@ -2670,6 +6250,11 @@ namespace argon::detail {
         virtual ~ConditionNode() = default;
 
         [[nodiscard]] virtual auto evaluate(const Results<CommandTag>& results) const -> bool = 0;
+
+        // Whether evaluate can look at the values of options, and not only at which of them are set
+        [[nodiscard]] virtual auto depends_on_values() const -> bool {
+            return false;
+        }
     };
 
     template <typename CommandTag, IsArgumentHandle HandleT>
@@ -2760,6 +6345,10 @@ namespace argon::detail {
         [[nodiscard]] auto evaluate(const Results<CommandTag>& results) const -> bool override {
             return m_lhs->evaluate(results) && m_rhs->evaluate(results);
         }
+
+        [[nodiscard]] auto depends_on_values() const -> bool override {
+            return m_lhs->depends_on_values() || m_rhs->depends_on_values();
+        }
     };
 
     template <typename CommandTag>
@@ -2774,6 +6363,10 @@ namespace argon::detail {
         [[nodiscard]] auto evaluate(const Results<CommandTag>& results) const -> bool override {
             return m_lhs->evaluate(results) || m_rhs->evaluate(results);
         }
+
+        [[nodiscard]] auto depends_on_values() const -> bool override {
+            return m_lhs->depends_on_values() || m_rhs->depends_on_values();
+        }
     };
 
     template <typename CommandTag>
@@ -2787,6 +6380,10 @@ namespace argon::detail {
         [[nodiscard]] auto evaluate(const Results<CommandTag>& results) const -> bool override {
             return !m_operand->evaluate(results);
         }
+
+        [[nodiscard]] auto depends_on_values() const -> bool override {
+            return m_operand->depends_on_values();
+        }
     };
 
     template <typename CommandTag>
@@ -2800,6 +6397,10 @@ namespace argon::detail {
         [[nodiscard]] auto evaluate(const Results<CommandTag>& results) const -> bool override {
             return m_evaluateFn(results);
         }
+
+        [[nodiscard]] auto depends_on_values() const -> bool override {
+            return true;
+        }
     };
 } // namespace argon::detail
 
@@ -2822,6 +6423,10 @@ namespace argon {
             return m_condition->evaluate(results);
         }
 
+        [[nodiscard]] auto depends_on_values() const -> bool {
+            return m_condition->depends_on_values();
+        }
+
         template <IsArgumentHandle T>
         friend auto present(T&& handle) -> Condition<command_tag_of_t<T>>;
 
@@ -2941,18 +6546,26 @@ namespace argon {
         When(Condition<CommandTag> precondition, const std::string_view description)
             : m_precondition(std::move(precondition), description) {}
 
-        [[nodiscard]] auto validate(const Results<CommandTag>& results) const -> std::expected<void, std::vector<std::string>> {
+        [[nodiscard]] auto validate(const Results<CommandTag>& results, const size_t maxErrors) const
+            -> std::expected<void, std::vector<Error>> {
             if (!m_precondition.first.evaluate(results)) return {};
-            std::vector<std::string> errors;
+            std::vector<Error> errors;
             for (const auto& [condition, msg] : m_conditions) {
+                if (errors.size() >= maxErrors) break;
                 if (!condition.evaluate(results)) {
-                    errors.emplace_back(std::format("{}: {}", m_precondition.second, msg));
+                    errors.emplace_back(ErrorCode::ConstraintViolation, std::format("{}: {}", m_precondition.second, msg));
                 }
             }
             if (!errors.empty()) return std::unexpected(std::move(errors));
             return {};
         }
 
+        [[nodiscard]] auto depends_on_values() const -> bool {
+            return m_precondition.first.depends_on_values()
+                || std::ranges::any_of(m_conditions | std::views::keys,
+                    [](const Condition<CommandTag>& condition) { return condition.depends_on_values(); });
+        }
+
     public:
         auto require(const Condition<CommandTag>& condition, const std::string_view message) & -> When& {
             m_conditions.emplace_back(condition, message);
@@ -2986,56 +6599,318 @@ namespace argon {
             return m_whens.emplace_back(std::move(when));
         }
     };
-} // namespace argon
+} // namespace argon
+
+
+namespace argon::detail {
+    class ConstraintValidator {
+        // A condition that reads a lazily converted value converts it, and a failure is reported as the errors of that
+        // value rather than escaping the run
+        template <typename CommandTag>
+        [[nodiscard]] static auto evaluate(const Condition<CommandTag>& condition, const std::string& msg,
+                                           const Results<CommandTag>& results) -> std::vector<Error> {
+            try {
+                if (condition.evaluate(results)) return {};
+                return std::vector{Error(ErrorCode::ConstraintViolation, msg)};
+            } catch (const ConversionError& error) {
+                return error.errors();
+            }
+        }
+
+        template <typename CommandTag>
+        [[nodiscard]] static auto validate_when(const When<CommandTag>& when, const Results<CommandTag>& results,
+                                                const size_t maxErrors) -> std::vector<Error> {
+            try {
+                if (auto validate = when.validate(results, maxErrors); !validate.has_value()) {
+                    return std::move(validate.error());
+                }
+                return {};
+            } catch (const ConversionError& error) {
+                return error.errors();
+            }
+        }
+
+    public:
+        // Evaluates the constraints in the order they were added, stopping once maxErrors of them fail
+        template <typename CommandTag>
+        static auto validate(
+            const Constraints<CommandTag>& constraints,
+            const Results<CommandTag>& results,
+            const size_t maxErrors
+        ) -> std::expected<void, std::vector<Error>> {
+            std::vector<Error> errors;
+
+            for (const auto& [condition, msg] : constraints.m_conditions) {
+                if (errors.size() >= maxErrors) return std::unexpected(std::move(errors));
+                std::ranges::move(evaluate(condition, msg, results), std::back_inserter(errors));
+            }
+
+            for (const auto& when : constraints.m_whens) {
+                if (errors.size() >= maxErrors) break;
+                std::ranges::move(validate_when(when, results, maxErrors - errors.size()), std::back_inserter(errors));
+            }
+            if (errors.size() > maxErrors) {
+                errors.erase(errors.begin() + static_cast<std::ptrdiff_t>(maxErrors), errors.end());
+            }
+
+            if (!errors.empty()) return std::unexpected(std::move(errors));
+            return {};
+        }
+
+        // Like validate, but a constraint is only evaluated again if it depends on values or the options that are set
+        // changed since the run memo remembers. The errors of the others are taken from memo.
+        template <typename CommandTag>
+        static auto validate_incremental(
+            const Constraints<CommandTag>& constraints,
+            const Results<CommandTag>& results,
+            const size_t maxErrors,
+            std::vector<bool> presence,
+            ParseMemo& memo
+        ) -> std::expected<void, std::vector<Error>> {
+            const size_t numConditions = constraints.m_conditions.size();
+            const size_t numConstraints = numConditions + constraints.m_whens.size();
+            const bool presenceChanged = presence != memo.presence || memo.constraintErrors.size() != numConstraints;
+            memo.presence = std::move(presence);
+            memo.constraintErrors.resize(numConstraints);
+
+            // Constraints past the error limit are evaluated too, so that the errors remembered for each stay current
+            for (size_t i = 0; i < numConstraints; ++i) {
+                const bool dependsOnValues = i < numConditions
+                    ? constraints.m_conditions[i].first.depends_on_values()
+                    : constraints.m_whens[i - numConditions].depends_on_values();
+                if (!presenceChanged && !dependsOnValues) continue;
+
+                if (i < numConditions) {
+                    const auto& [condition, msg] = constraints.m_conditions[i];
+                    memo.constraintErrors[i] = evaluate(condition, msg, results);
+                } else {
+                    const auto& when = constraints.m_whens[i - numConditions];
+                    memo.constraintErrors[i] = validate_when(when, results, maxErrors);
+                }
+            }
+
+            std::vector<Error> errors;
+            for (const auto& constraintErrors : memo.constraintErrors) {
+                const size_t remaining = maxErrors - std::min(maxErrors, errors.size());
+                const size_t numErrors = std::min(constraintErrors.size(), remaining);
+                std::ranges::copy(constraintErrors | std::views::take(numErrors), std::back_inserter(errors));
+            }
+            if (!errors.empty()) return std::unexpected(std::move(errors));
+            return {};
+        }
+    };
+}
+
+
+namespace argon::detail {
+    class CommandBase {
+        friend class ::argon::Cli;
+        friend class LazyCommand;
+
+    protected:
+        std::string m_name;
+        std::string m_description;
+        Context m_context;
+        std::vector<std::pair<UniqueId, Polymorphic<CommandBase>>> m_subcommands;
+        std::optional<RadixTrie> m_subcommandAbbreviations;
+        // Shared with the errors of unknown subcommands, copied first if one still holds them
+        std::shared_ptr<std::vector<std::string>> m_subcommandNames = std::make_shared<std::vector<std::string>>();
+        std::shared_ptr<const std::string> m_version;
+
+        auto enable_subcommand_abbreviations() -> void {
+            if (m_subcommandAbbreviations.has_value()) return;
+            m_subcommandAbbreviations.emplace();
+            for (const auto& subcommand : m_subcommands | std::views::values) {
+                m_subcommandAbbreviations->insert(subcommand->m_name);
+            }
+        }
+
+        auto add_subcommand_entry(const UniqueId& id, Polymorphic<CommandBase> subcommand) -> void {
+            if (m_subcommandAbbreviations.has_value()) m_subcommandAbbreviations->insert(subcommand->m_name);
+            if (m_subcommandNames.use_count() > 1) {
+                m_subcommandNames = std::make_shared<std::vector<std::string>>(*m_subcommandNames);
+            }
+            m_subcommandNames->push_back(subcommand->m_name);
+            m_subcommands.emplace_back(id, std::move(subcommand));
+        }
+
+        // Subcommand names that start with name, or only name if it is one. Empty if abbreviations are not enabled.
+        [[nodiscard]] auto find_subcommand_abbreviation(const std::string_view name) const -> std::vector<std::string_view> {
+            if (!m_subcommandAbbreviations.has_value() || name.empty()) return {};
+            return m_subcommandAbbreviations->find_prefix(name);
+        }
+
+    public:
+        explicit CommandBase(const std::string_view name, const std::string_view description)
+            : m_name(name), m_description(description) {}
+        virtual ~CommandBase() = default;
+
+        // Parsing stops once maxErrors errors are found. With a memo, only what changed since the run it remembers is
+        // converted and validated again.
+        [[nodiscard]] virtual auto run(
+            const ArgvView& argv,
+            const std::optional<ConfigSection>& config,
+            size_t maxErrors,
+            ParseMemo *memo
+        ) -> std::expected<void, std::vector<Error>> = 0;
+    };
+
+    // Stands in for a subcommand until it is selected or its help is requested, when the factory builds the real
+    // command. The factory runs at most once for this stub and all of its copies, so the handles it creates stay valid
+    // in every Cli made from the same definition.
+    class LazyCommand final : public CommandBase {
+    public:
+        using Factory = std::function<std::expected<Polymorphic<CommandBase>, std::string>(const UniqueId& id)>;
+
+    private:
+        struct Build {
+            std::once_flag once;
+            std::expected<Polymorphic<CommandBase>, std::string> command;
+        };
+
+        // The copy of the built command that this stub runs. Lookups through a const Cli may build it from several
+        // threads, so it is published through its own once flag and the stub is never replaced.
+        struct Instance {
+            std::once_flag once;
+            std::atomic<bool> ready = false;
+            std::expected<Polymorphic<CommandBase>, std::string> command;
+        };
+
+        Factory m_factory;
+        std::shared_ptr<Build> m_build = std::make_shared<Build>();
+        std::unique_ptr<Instance> m_instance = std::make_unique<Instance>();
+
+        [[nodiscard]] auto run(const ArgvView&, const std::optional<ConfigSection>&, size_t, ParseMemo *)
+            -> std::expected<void, std::vector<Error>> override {
+            throw std::logic_error("A lazy subcommand must be built before it is run");
+        }
+
+    public:
+        LazyCommand(const std::string_view name, const std::string_view description, Factory factory)
+            : CommandBase(name, description), m_factory(std::move(factory)) {}
+
+        LazyCommand(const LazyCommand& other)
+            : CommandBase(other), m_factory(other.m_factory), m_build(other.m_build) {
+            if (!other.m_instance->ready.load(std::memory_order_acquire)) return;
+            std::call_once(m_instance->once, [&] { m_instance->command = other.m_instance->command; });
+            m_instance->ready.store(true, std::memory_order_release);
+        }
+
+        LazyCommand(LazyCommand&&) noexcept = default;
+        auto operator=(const LazyCommand&) -> LazyCommand& = delete;
+        auto operator=(LazyCommand&&) -> LazyCommand& = delete;
+
+        [[nodiscard]] auto build(const UniqueId& id) const -> std::expected<Polymorphic<CommandBase>, std::string> {
+            std::call_once(m_build->once, [&] { m_build->command = m_factory(id); });
+            return m_build->command;
+        }
+
+        // The command this stub stands for, built on the first call
+        [[nodiscard]] auto get_command(const UniqueId& id) const -> std::expected<CommandBase *, std::string> {
+            std::call_once(m_instance->once, [&] {
+                auto built = build(id);
+                if (built.has_value()) {
+                    built.value()->m_name = m_name;
+                    built.value()->m_description = m_description;
+                }
+                m_instance->command = std::move(built);
+                m_instance->ready.store(true, std::memory_order_release);
+            });
+            if (!m_instance->command.has_value()) return std::unexpected(m_instance->command.error());
+            return m_instance->command.value().get();
+        }
+
+        // The command this stub stands for if it was already built, otherwise null
+        [[nodiscard]] auto get_built_command() const -> CommandBase * {
+            if (!m_instance->ready.load(std::memory_order_acquire) || !m_instance->command.has_value()) return nullptr;
+            return m_instance->command.value().get();
+        }
+    };
 
+    template <typename T>
+    struct CommandTagOf {};
 
-namespace argon::detail {
-    class ConstraintValidator {
-    public:
-        template <typename CommandTag>
-        static auto validate(
-            const Constraints<CommandTag>& constraints,
-            const Results<CommandTag>& results
-        ) -> std::expected<void, std::vector<std::string>> {
-            std::vector<std::string> errors;
+    template <typename Tag>
+    struct CommandTagOf<Command<Tag>> {
+        using type = Tag;
+    };
+} // namespace argon::detail
 
-            for (const auto& [condition, msg] : constraints.m_conditions) {
-                if (!condition.evaluate(results)) {
-                    errors.emplace_back(msg);
-                }
-            }
 
-            for (const auto& when : constraints.m_whens) {
-                if (auto validate = when.validate(results); !validate.has_value()) {
-                    errors.insert(errors.end(), validate.error().begin(), validate.error().end());
-                }
-            }
+namespace argon {
+    // Given to the entry point of a plugin, which builds the plugin's command and passes it to set_command. Plugins
+    // must be compiled with the same version of this header as the program that loads them.
+    class PluginBuilder {
+        using EntryPoint = void (*)(PluginBuilder&);
 
-            if (!errors.empty()) return std::unexpected(std::move(errors));
-            return {};
-        }
-    };
-}
+        detail::UniqueId m_id;
+        std::atomic<size_t> *m_idCounter = detail::UniqueId::counter();
+        std::optional<detail::Polymorphic<detail::CommandBase>> m_command;
 
+        template <typename T> friend class Command;
 
-namespace argon::detail {
-    class CommandBase {
-        friend class ::argon::Cli;
+        explicit PluginBuilder(const detail::UniqueId& id) : m_id(id) {}
 
-    protected:
-        std::string m_name;
-        std::string m_description;
-        Context m_context;
-        std::vector<std::pair<UniqueId, Polymorphic<CommandBase>>> m_subcommands;
+        // Plugins are never unloaded, since the commands they build keep running their code
+        [[nodiscard]] static auto load(const std::filesystem::path& library, const detail::UniqueId& id)
+            -> std::expected<detail::Polymorphic<detail::CommandBase>, std::string> {
+#if defined(ARGON_HAS_DLOPEN)
+            void *handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (handle == nullptr) {
+                return std::unexpected(std::format("Unable to load plugin '{}': {}", library.string(), dlerror()));
+            }
+            const auto entry = reinterpret_cast<EntryPoint>(dlsym(handle, "argon_plugin_entry"));
+            if (entry == nullptr) {
+                return std::unexpected(std::format("Plugin '{}' does not define an entry point", library.string()));
+            }
+
+            PluginBuilder builder{id};
+            entry(builder);
+            if (!builder.m_command.has_value()) {
+                return std::unexpected(std::format("Plugin '{}' did not set a command", library.string()));
+            }
+            return std::move(builder.m_command.value());
+#else
+            (void) id;
+            return std::unexpected(std::format("Unable to load plugin '{}': plugins are not supported on this platform",
+                library.string()));
+#endif
+        }
 
     public:
-        explicit CommandBase(const std::string_view name, const std::string_view description)
-            : m_name(name), m_description(description) {}
-        virtual ~CommandBase() = default;
+        // Called by ARGON_PLUGIN before the plugin creates any options, so that its ids come from the program's counter
+        auto share_ids() const -> void {
+            detail::UniqueId::counter() = m_idCounter;
+        }
 
-        [[nodiscard]] virtual auto run(const ArgvView& argv) -> std::expected<void, std::vector<std::string>> = 0;
+        template <typename Tag>
+        auto set_command(Command<Tag> command) -> CommandHandle<Tag> {
+            m_command = detail::make_polymorphic<detail::CommandBase>(std::move(command));
+            return CommandHandle<Tag>{m_id};
+        }
     };
-} // namespace argon::detail
+} // namespace argon
+
+// Exports the entry point of a plugin from its shared object or DLL
+#if !defined(ARGON_PLUGIN_EXPORT)
+#if defined(_WIN32)
+#define ARGON_PLUGIN_EXPORT __declspec(dllexport)
+#elif defined(__GNUC__) || defined(__clang__)
+#define ARGON_PLUGIN_EXPORT __attribute__((visibility("default")))
+#else
+#define ARGON_PLUGIN_EXPORT
+#endif
+#endif
+
+// Defines the entry point of a plugin shared object. The body that follows builds the plugin's command and passes it
+// to builder.set_command.
+#define ARGON_PLUGIN(builder) \
+    static auto argon_plugin_build(argon::PluginBuilder& builder) -> void; \
+    extern "C" ARGON_PLUGIN_EXPORT auto argon_plugin_entry(argon::PluginBuilder& builder) -> void { \
+        builder.share_ids(); \
+        argon_plugin_build(builder); \
+    } \
+    static auto argon_plugin_build(argon::PluginBuilder& builder) -> void
 
 
 namespace argon {
@@ -3047,16 +6922,44 @@ namespace argon {
         Constraints<Tag> constraints;
 
     private:
-        [[nodiscard]] auto run(const detail::ArgvView& argv) -> std::expected<void, std::vector<std::string>> override {
+        [[nodiscard]] auto run(
+            const detail::ArgvView& argv,
+            const std::optional<detail::ConfigSection>& config,
+            const size_t maxErrors,
+            detail::ParseMemo *memo
+        ) -> std::expected<void, std::vector<Error>> override {
+            m_context.clear_value_sources();
+            // Tokenization always stops at its first error
             auto ast = detail::AstBuilder::build(argv, m_context);
             if (!ast.has_value()) return std::unexpected(std::vector{std::move(ast.error())});
 
-            if (auto analysisSuccess = detail::AstAnalyzer::analyze(ast.value(), m_context); !analysisSuccess.has_value()) {
+            auto analysisSuccess = memo == nullptr
+                ? detail::AstAnalyzer::analyze(ast.value(), m_context, maxErrors)
+                : detail::AstAnalyzer::analyze_incremental(ast.value(), m_context, maxErrors, *memo);
+            if (!analysisSuccess.has_value()) {
                 return std::unexpected(std::move(analysisSuccess.error()));
             }
+            m_context.record_value_sources(ValueSource::CommandLine);
+
+            if (auto envSuccess = detail::EnvironmentApplier::apply(m_context, maxErrors); !envSuccess) {
+                return std::unexpected(std::move(envSuccess.error()));
+            }
+            m_context.record_value_sources(ValueSource::Environment);
+
+            if (config.has_value()) {
+                auto configSuccess = detail::ConfigFileApplier::apply(m_context, config.value(), maxErrors);
+                if (!configSuccess) {
+                    return std::unexpected(std::move(configSuccess.error()));
+                }
+                m_context.record_value_sources(ValueSource::ConfigFile);
+            }
 
             Results<Tag> results{m_context};
-            if (auto constraintSuccess = detail::ConstraintValidator::validate(constraints, results); !constraintSuccess) {
+            auto constraintSuccess = memo == nullptr
+                ? detail::ConstraintValidator::validate(constraints, results, maxErrors)
+                : detail::ConstraintValidator::validate_incremental(
+                    constraints, results, maxErrors, m_context.get_presence(), *memo);
+            if (!constraintSuccess) {
                 return std::unexpected(std::move(constraintSuccess.error()));
             }
 
@@ -3067,6 +6970,29 @@ namespace argon {
         explicit Command(const std::string_view name, const std::string_view description)
             : CommandBase(name, description) {}
 
+        auto enable_lazy_conversion() -> void {
+            m_context.enable_lazy_conversion();
+        }
+
+        // Adds options that ask for the help message of this command. When one is given before '--', the rest of the
+        // command line is not parsed, and Cli::get_builtin_output returns the help message.
+        auto enable_help(std::vector<std::string> names = {"--help", "-h"}) -> void {
+            m_context.enable_help_flags(std::move(names));
+        }
+
+        // Adds options that ask for the version, which are handled like the help options
+        auto enable_version(std::string version, std::vector<std::string> names = {"--version"}) -> void {
+            m_context.enable_version_flags(std::move(names));
+            m_version = std::make_shared<const std::string>(std::move(version));
+        }
+
+        // Lets long options and subcommands of this command be given by any prefix that matches only one name, such as
+        // '--verb' for '--verbose' or 'dep' for 'deploy'. A prefix of several names is reported as ambiguous.
+        auto enable_abbreviations() -> void {
+            m_context.enable_abbreviations();
+            enable_subcommand_abbreviations();
+        }
+
         template <typename T>
         [[nodiscard]] auto add_flag(Flag<T> flag) -> FlagHandle<Tag, T> {
             const detail::UniqueId id = m_context.add_flag(std::move(flag));
@@ -3106,20 +7032,112 @@ namespace argon {
         template <typename T>
         [[nodiscard]] auto add_subcommand(Command<T> subcommand) -> CommandHandle<T> {
             const detail::UniqueId id{};
-            m_subcommands.emplace_back(id, detail::make_polymorphic<CommandBase>(std::move(subcommand)));
+            add_subcommand_entry(id, detail::make_polymorphic<CommandBase>(std::move(subcommand)));
+            return CommandHandle<T>{id};
+        }
+
+        // The factory returns the Command for this subcommand, and is only called when the subcommand is selected or its
+        // help is requested. The built command takes the name and description given here.
+        template <typename Factory, typename T = typename detail::CommandTagOf<std::invoke_result_t<Factory&>>::type>
+        [[nodiscard]] auto add_subcommand_lazy(
+            const std::string_view name, const std::string_view description, Factory factory
+        ) -> CommandHandle<T> {
+            const detail::UniqueId id{};
+            add_subcommand_entry(id, detail::make_polymorphic<CommandBase>(detail::LazyCommand{
+                name, description, [factory = std::move(factory)](const detail::UniqueId&) mutable
+                    -> std::expected<detail::Polymorphic<CommandBase>, std::string> {
+                    return detail::make_polymorphic<CommandBase>(factory());
+                }
+            }));
             return CommandHandle<T>{id};
         }
+
+        // The shared object at library is only loaded, and its command built, when this subcommand is selected or its
+        // help is requested. The built command takes the name and description given here.
+        [[nodiscard]] auto add_plugin_subcommand(
+            const std::string_view name, const std::string_view description, std::filesystem::path library
+        ) -> AnyCommandHandle {
+            const detail::UniqueId id{};
+            add_subcommand_entry(id, detail::make_polymorphic<CommandBase>(detail::LazyCommand{
+                name, description, [library = std::move(library)](const detail::UniqueId& commandId) {
+                    return PluginBuilder::load(library, commandId);
+                }
+            }));
+            return AnyCommandHandle{id};
+        }
     };
 
+    // Each error converts to its message, so messages can be used as strings
     struct CliRunError {
         AnyCommandHandle handle;
-        std::vector<std::string> messages;
+        std::vector<Error> messages;
+    };
+
+    // The options whose value or value source differ between two parses. Streamed multi-positionals are never reported
+    // as changed.
+    class ResultsDiff {
+        bool m_commandChanged = false;
+        std::unordered_set<detail::UniqueId> m_changed;
+
+        friend class ReloadableCli;
+
+    public:
+        // Whether a different command was selected, in which case every option counts as changed
+        [[nodiscard]] auto command_changed() const -> bool {
+            return m_commandChanged;
+        }
+
+        [[nodiscard]] auto empty() const -> bool {
+            return !m_commandChanged && m_changed.empty();
+        }
+
+        template <typename CmdTag, typename T, typename HandleTag> requires IsArgumentHandle<Handle<CmdTag, T, HandleTag>>
+        [[nodiscard]] auto is_changed(const Handle<CmdTag, T, HandleTag>& handle) const -> bool {
+            return m_commandChanged || m_changed.contains(handle.get_id());
+        }
     };
 
     class Cli {
+        friend class ReloadableCli;
+        friend class ParseSession;
+
         Command<> m_root;
         detail::UniqueId m_rootId;
         std::optional<detail::UniqueId> m_successfulCommandId;
+        std::shared_ptr<const std::string> m_builtinOutput;
+        std::optional<ResponseFileConfig> m_responseFileConfig;
+        std::vector<std::shared_ptr<const detail::MappedFile>> m_responseFiles;
+        std::optional<std::filesystem::path> m_configFilePath;
+        ConfigFilePresence m_configFilePresence = ConfigFilePresence::Optional;
+        std::optional<detail::ConfigFile> m_configFile;
+        std::optional<DescriptorSourceConfig> m_descriptorSourceConfig;
+        std::shared_ptr<const std::string> m_descriptorArguments;
+        std::string m_lineBuffer;
+        std::string m_snapshotBuffer;
+        std::string m_processArguments;
+        size_t m_errorLimit = std::numeric_limits<size_t>::max();
+        mutable detail::HelpCache m_helpCache;
+
+        constexpr static std::string_view snapshotMagic = "ARGONSNAPSHOT1";
+
+        // The command a subcommand entry stands for. A lazy subcommand is built by its stub on first use and stays in
+        // the entry, so lookups through a const Cli never write to the command tree.
+        template <typename Entry>
+        [[nodiscard]] static auto resolve_subcommand(Entry& subcommand)
+            -> std::expected<decltype(subcommand.second.get()), std::string> {
+            const auto *lazy = dynamic_cast<const detail::LazyCommand *>(subcommand.second.get());
+            if (lazy == nullptr) return subcommand.second.get();
+            return lazy->get_command(subcommand.first);
+        }
+
+        // The command a subcommand entry stands for if it is not a lazy subcommand that is yet to be built
+        [[nodiscard]] static auto resolve_built_subcommand(const detail::Polymorphic<detail::CommandBase>& subcommand)
+            -> const detail::CommandBase * {
+            const auto *lazy = dynamic_cast<const detail::LazyCommand *>(subcommand.get());
+            if (lazy == nullptr) return subcommand.get();
+            if (const auto *built = lazy->get_built_command()) return built;
+            return lazy;
+        }
 
         [[nodiscard]] auto search_subcommand(
             const detail::UniqueId& searchId
@@ -3147,9 +7165,12 @@ namespace argon {
                 nodesToVisit.pop();
 
                 for (const auto& [parentIndex, cmd] = cmdList.at(currentIndex);
-                    const auto& [subId, subCmd] : cmd->m_subcommands) {
+                    auto& subcommand : cmd->m_subcommands) {
+                    const auto& [subId, subCmd] = subcommand;
                     if (subId == searchId) {
-                        std::vector path = {subCmd.get()};
+                        const auto built = resolve_subcommand(subcommand);
+                        if (!built.has_value()) throw std::runtime_error(built.error());
+                        std::vector<const detail::CommandBase *> path = {built.value()};
 
                         int32_t index = currentIndex;
                         while (index != -1) {
@@ -3164,7 +7185,7 @@ namespace argon {
                     const auto childIndex = static_cast<int32_t>(cmdList.size());
                     cmdList.emplace_back(SearchNode{
                         .parentIndex = currentIndex,
-                        .cmd = subCmd.get()}
+                        .cmd = resolve_built_subcommand(subCmd)}
                     );
                     nodesToVisit.push(childIndex);
                 }
@@ -3173,7 +7194,8 @@ namespace argon {
             throw std::runtime_error("No subcommand with this ID exists");
         }
 
-        [[nodiscard]] auto get_help_message(const detail::UniqueId& id) const -> std::string {
+        template <std::output_iterator<char> Out>
+        auto render_help_message_to(Out out, const detail::UniqueId& id, const size_t width) const -> Out {
             const std::vector<const detail::CommandBase *> path = search_subcommand(id);
 
             const auto subcommands = path.back()->m_subcommands
@@ -3192,39 +7214,145 @@ namespace argon {
                 }
             );
 
-            return detail::HelpMessageBuilder::build(path.back()->m_context, subcommands, name, path.back()->m_description);
+            return detail::HelpMessageBuilder::build_to(
+                out, path.back()->m_context, subcommands, name, path.back()->m_description, width);
         }
 
-    public:
-        explicit Cli(Command<> root_) : m_root(std::move(root_)) {}
+        [[nodiscard]] auto get_shared_help_message(const detail::UniqueId& id, const size_t width) const
+            -> std::shared_ptr<const std::string> {
+            return m_helpCache.get(id, width, [&] {
+                std::string message;
+                render_help_message_to(std::back_inserter(message), id, width);
+                return message;
+            });
+        }
 
-        [[nodiscard]] auto get_help_message(const AnyCommandHandle& handle) const -> std::string {
-            return get_help_message(handle.get_id());
+        [[nodiscard]] static auto describe_command(const detail::CommandBase& cmd) -> CommandInfo {
+            CommandInfo info{.name = cmd.m_name, .description = cmd.m_description,
+                             .options = cmd.m_context.describe_options(), .subcommands = {}};
+            info.subcommands.reserve(cmd.m_subcommands.size());
+            for (const auto& subcommand : cmd.m_subcommands) {
+                const auto built = resolve_subcommand(subcommand);
+                if (!built.has_value()) throw std::runtime_error(built.error());
+                info.subcommands.push_back(describe_command(*built.value()));
+            }
+            return info;
         }
 
-        template <typename T>
-        [[nodiscard]] auto get_help_message(const CommandHandle<T>& handle) const -> std::string {
-            return get_help_message(handle.get_id());
+        // Help messages of the root command include the program name, so they are rendered again when it changes
+        auto set_program_name(std::string name) -> void {
+            if (name == m_root.m_name) return;
+            m_root.m_name = std::move(name);
+            m_helpCache.clear();
         }
 
-        [[nodiscard]] auto run(const int argc, const char * const *argv) -> std::expected<void, CliRunError> {
-            detail::ArgvView view{argc, argv};
-            m_root.m_name = std::filesystem::path(view.next()).filename().string();
+        // A Cli with the same commands and reloadable sources, without the state of any run. The descriptor source is
+        // not included, since it cannot be read again.
+        [[nodiscard]] auto clone_definition() const -> Cli {
+            Cli cli{m_root};
+            cli.m_rootId = m_rootId;
+            cli.m_responseFileConfig = m_responseFileConfig;
+            cli.m_configFilePath = m_configFilePath;
+            cli.m_configFilePresence = m_configFilePresence;
+            cli.m_errorLimit = m_errorLimit;
+            return cli;
+        }
+
+        [[nodiscard]] auto get_successful_context() const -> const detail::Context& {
+            return search_subcommand(m_successfulCommandId.value()).back()->m_context;
+        }
+
+        [[nodiscard]] auto make_argv_view(const int argc, const char * const *argv)
+            -> std::expected<detail::ArgvView, std::string> {
+            m_responseFiles.clear();
+            if (!m_responseFileConfig.has_value()) return detail::ArgvView{argc, argv};
+
+            detail::ResponseFileExpander expander{m_responseFileConfig.value(), m_responseFiles};
+            auto expanded = expander.expand(argc, argv);
+            if (!expanded.has_value()) return std::unexpected(std::move(expanded.error()));
+            return detail::ArgvView{std::move(expanded.value())};
+        }
+
+        // Only runs given the option of the source read the descriptor. A streamed multi-positional reads it while its
+        // results are iterated, after the first argument is read here to tell whether it is set. Otherwise, the
+        // descriptor is read to the end and its arguments are parsed as positional values after the command line.
+        [[nodiscard]] auto apply_descriptor_source(detail::CommandBase& cmd, detail::ArgvView& view)
+            -> std::expected<void, std::string> {
+            m_descriptorArguments.reset();
+            if (!m_descriptorSourceConfig.has_value()) return {};
+            if (!view.remove_option(m_descriptorSourceConfig->option)) return {};
+
+            auto reader = std::make_shared<detail::DescriptorReader>(m_descriptorSourceConfig.value());
+            if (cmd.m_context.set_stream_source(reader)) return {};
+
+            auto arguments = reader->read_all();
+            if (!arguments.has_value()) return std::unexpected(std::move(arguments.error()));
+            m_descriptorArguments = std::move(arguments->first);
+            view.append_positionals(arguments->second);
+            return {};
+        }
+
+        [[nodiscard]] auto run_words(std::vector<std::string_view> words, detail::ParseMemo *memo = nullptr)
+            -> std::expected<void, CliRunError> {
+            m_responseFiles.clear();
+            if (m_responseFileConfig.has_value()) {
+                detail::ResponseFileExpander expander{m_responseFileConfig.value(), m_responseFiles};
+                auto expanded = expander.expand(words);
+                if (!expanded.has_value()) {
+                    return std::unexpected(CliRunError{
+                        .handle = AnyCommandHandle{m_rootId},
+                        .messages = std::vector{Error(ErrorCode::Source, std::move(expanded.error()))}
+                    });
+                }
+                words = std::move(expanded.value());
+            }
+
+            detail::ArgvView view{std::move(words)};
+            return run_view(view, memo);
+        }
+
+        // Runs the arguments after the program name, which view has already consumed. A memo keeps the values of the
+        // selected command between runs, so they are only cleared when another command is selected.
+        [[nodiscard]] auto run_view(detail::ArgvView& view, detail::ParseMemo *memo = nullptr)
+            -> std::expected<void, CliRunError> {
+            m_successfulCommandId.reset();
+            m_builtinOutput.reset();
+            m_configFile.reset();
 
             detail::CommandBase *selectedCmd = &m_root;
             detail::UniqueId selectedId = m_rootId;
+            std::string sectionName;
             while (true) {
                 if (selectedCmd->m_subcommands.empty() || view.get_pos() >= view.size()) {
                     break;
                 }
 
-                const std::string_view token = view.peek();
+                std::string_view token = view.peek();
+                if (const auto matches = selectedCmd->find_subcommand_abbreviation(token); matches.size() == 1) {
+                    token = matches.front();
+                } else if (matches.size() > 1) {
+                    return std::unexpected(CliRunError{
+                        .handle = AnyCommandHandle{selectedId},
+                        .messages = std::vector{Error(ErrorCode::AmbiguousSubcommand, detail::quote_names(matches))
+                            .with_option(token).with_position(view.get_pos())}
+                    });
+                }
                 bool subcommandFound = false;
-                for (auto& [id, subcommand] : selectedCmd->m_subcommands) {
+                for (auto& entry : selectedCmd->m_subcommands) {
+                    auto& [id, subcommand] = entry;
                     if (token == subcommand->m_name) {
+                        auto built = resolve_subcommand(entry);
+                        if (!built.has_value()) {
+                            return std::unexpected(CliRunError{
+                                .handle = AnyCommandHandle{id},
+                                .messages = std::vector{Error(ErrorCode::SubcommandUnavailable, std::move(built.error()))}
+                            });
+                        }
                         subcommandFound = true;
                         selectedId = id;
-                        selectedCmd = subcommand.get();
+                        selectedCmd = built.value();
+                        if (!sectionName.empty()) sectionName += '.';
+                        sectionName += selectedCmd->m_name;
                         view.next();
                         break;
                     }
@@ -3235,21 +7363,51 @@ namespace argon {
                     break;
                 }
 
-                std::string subcommands = std::ranges::fold_left(
-                    selectedCmd->m_subcommands | std::views::values | std::views::drop(1), selectedCmd->m_subcommands[0].second->m_name,
-                    [](const std::string& acc, const detail::Polymorphic<detail::CommandBase>& subcommand) -> std::string {
-                        return acc + ", " + subcommand->m_name;
-                    }
-                );
                 return std::unexpected(CliRunError{
                     .handle = AnyCommandHandle{selectedId},
-                    .messages = std::vector{std::format(
-                        "Unknown subcommand '{}'. Valid subcommands are: {}",
-                        token, subcommands)}
+                    .messages = std::vector{Error(ErrorCode::UnknownSubcommand)
+                        .with_candidates(selectedCmd->m_subcommandNames)
+                        .with_option(token).with_position(view.get_pos())}
+                });
+            }
+
+            if (memo == nullptr || memo->command != selectedId) {
+                selectedCmd->m_context.clear_values();
+                if (memo != nullptr) memo->reset(selectedId);
+            }
+            // Built-in options skip the sources and the parse, which could fail because of the options they are about
+            if (const auto builtin = detail::AstBuilder::find_builtin_flag(view, selectedCmd->m_context)) {
+                selectedCmd->m_context.clear_value_sources();
+                m_builtinOutput = builtin.value() == detail::BuiltinFlag::Help
+                    ? get_shared_help_message(selectedId, detail::HelpMessageBuilder::defaultLineWidth)
+                    : selectedCmd->m_version;
+                return {};
+            }
+
+            std::error_code missingError;
+            if (m_configFilePath.has_value() && (m_configFilePresence == ConfigFilePresence::Required
+                || std::filesystem::exists(m_configFilePath.value(), missingError) || missingError)) {
+                auto configFile = detail::ConfigFile::parse(m_configFilePath.value());
+                if (!configFile.has_value()) {
+                    return std::unexpected(CliRunError{
+                        .handle = AnyCommandHandle{m_rootId},
+                        .messages = std::vector{Error(ErrorCode::Source, std::move(configFile.error()))}
+                    });
+                }
+                m_configFile = std::move(configFile.value());
+            }
+
+            if (auto descriptorSuccess = apply_descriptor_source(*selectedCmd, view); !descriptorSuccess.has_value()) {
+                return std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{selectedId},
+                    .messages = std::vector{Error(ErrorCode::Source, std::move(descriptorSuccess.error()))}
                 });
             }
 
-            if (auto runSuccess = selectedCmd->run(view); !runSuccess.has_value()) {
+            std::optional<detail::ConfigSection> configSection;
+            if (m_configFile.has_value()) configSection = m_configFile->get_section(sectionName);
+
+            if (auto runSuccess = selectedCmd->run(view, configSection, m_errorLimit, memo); !runSuccess.has_value()) {
                 return std::unexpected(CliRunError{
                     .handle = AnyCommandHandle{selectedId},
                     .messages = std::move(runSuccess.error())
@@ -3260,6 +7418,410 @@ namespace argon {
             return {};
         }
 
+    public:
+        explicit Cli(Command<> root_) : m_root(std::move(root_)) {}
+
+        [[nodiscard]] auto get_help_message(
+            const AnyCommandHandle& handle, const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> std::string {
+            return *get_shared_help_message(handle.get_id(), width);
+        }
+
+        template <typename T>
+        [[nodiscard]] auto get_help_message(
+            const CommandHandle<T>& handle, const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> std::string {
+            return *get_shared_help_message(handle.get_id(), width);
+        }
+
+        // Help messages are rendered once for each command and width, and shared until the program name changes. The
+        // returned message stays valid for as long as it is held, and may be read from any thread.
+        [[nodiscard]] auto get_shared_help_message(
+            const AnyCommandHandle& handle, const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> std::shared_ptr<const std::string> {
+            return get_shared_help_message(handle.get_id(), width);
+        }
+
+        template <typename T>
+        [[nodiscard]] auto get_shared_help_message(
+            const CommandHandle<T>& handle, const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> std::shared_ptr<const std::string> {
+            return get_shared_help_message(handle.get_id(), width);
+        }
+
+        // Candidates for words[cword] of a command line whose first word is the program, for shell completion.
+        // Subcommand names, flags, aliases and choice keys are completed from the words before it, without converting
+        // or validating any values. Lazy subcommands are built when a word selects them.
+        [[nodiscard]] auto complete(const std::span<const std::string_view> words, const size_t cword)
+            -> std::vector<std::string> {
+            const auto split = detail::split_completion_words(words, cword);
+            if (!split.has_value()) return {};
+            const auto [before, prefix] = split.value();
+
+            detail::CommandBase *cmd = &m_root;
+            size_t selected = 0;
+            while (selected < before.size()) {
+                const auto it = std::ranges::find_if(cmd->m_subcommands, [&](const auto& subcommand) {
+                    return subcommand.second->m_name == before[selected];
+                });
+                if (it == cmd->m_subcommands.end()) break;
+                const auto built = resolve_subcommand(*it);
+                if (!built.has_value()) return {};
+                cmd = built.value();
+                ++selected;
+            }
+
+            std::vector<std::string_view> names;
+            for (const auto& subcommand : cmd->m_subcommands | std::views::values) {
+                names.emplace_back(subcommand->m_name);
+            }
+            return detail::complete_word(cmd->m_context.describe_options(), std::move(names), before.subspan(selected),
+                                         prefix);
+        }
+
+        // Answers 'program __complete <cword> <words...>', the hidden entry point used by the scripts from
+        // get_completion_script, with the candidates to print one per line. Returns std::nullopt if argv is not a
+        // completion request, in which case it should be run as usual.
+        [[nodiscard]] auto try_complete(const int argc, const char * const *argv)
+            -> std::optional<std::vector<std::string>> {
+            if (argc < 2 || argv[1] != detail::completeCommand) return std::nullopt;
+            if (argc < 3) return std::vector<std::string>{};
+
+            const std::string_view cwordArg = argv[2];
+            size_t cword = 0;
+            if (const auto [end, ec] = std::from_chars(cwordArg.data(), cwordArg.data() + cwordArg.size(), cword);
+                ec != std::errc{} || end != cwordArg.data() + cwordArg.size()) {
+                return std::vector<std::string>{};
+            }
+            const std::vector<std::string_view> words(argv + 3, argv + argc);
+            return complete(words, cword);
+        }
+
+        // The command tree with every option, building lazy subcommands. Throws std::runtime_error if one cannot be built.
+        [[nodiscard]] auto describe() const -> CommandInfo {
+            return describe_command(m_root);
+        }
+
+        // Encodes the command tree for shells and tools that complete without running the program. JsonLines is read by
+        // the script from get_completion_data_script, Binary by read_completion_data.
+        [[nodiscard]] auto export_completion_data(const CompletionDataFormat format) const -> std::string {
+            const CommandInfo root = describe();
+            if (format == CompletionDataFormat::Binary) {
+                detail::SnapshotWriter out;
+                out.write_string(detail::completionDataMagic);
+                detail::write_completion_binary(out, root);
+                return std::move(out).take();
+            }
+            std::string out;
+            detail::write_completion_json_lines(out, root, "");
+            return out;
+        }
+
+        // A bash script that completes program from dataFile, written by export_completion_data in the JsonLines
+        // format, with shell builtins only
+        [[nodiscard]] static auto get_completion_data_script(const std::string_view program,
+                                                             const std::filesystem::path& dataFile) -> std::string {
+            std::string quotedPath = "'";
+            for (const char c : dataFile.string()) {
+                if (c == '\'') quotedPath += R"('\'')";
+                else quotedPath += c;
+            }
+            quotedPath += '\'';
+            return detail::replace_script_markers(detail::bashCompletionDataScript, program, quotedPath);
+        }
+
+        // A script that registers completion for program with the shell, for example by evaluating the output of
+        // 'program completion bash' from a startup file
+        [[nodiscard]] static auto get_completion_script(const CompletionShell shell, const std::string_view program)
+            -> std::string {
+            return detail::get_completion_script(shell, program);
+        }
+
+        // Renders the help message through out, such as a std::back_insert_iterator, without using the cache or
+        // building an intermediate string
+        template <std::output_iterator<char> Out, IsCommandHandle HandleT>
+        auto format_help_message_to(
+            Out out, const HandleT& handle, const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> Out {
+            return render_help_message_to(std::move(out), handle.get_id(), width);
+        }
+
+        // Writes as much of the help message as fits in buffer and returns the size of the whole message, so the
+        // message was truncated if that is larger than the buffer. The message is not null terminated.
+        template <IsCommandHandle HandleT>
+        [[nodiscard]] auto write_help_message(
+            const std::span<char> buffer, const HandleT& handle,
+            const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> size_t {
+            return render_help_message_to(detail::BoundedBufferIterator{buffer}, handle.get_id(), width).get_count();
+        }
+
+        // Writes the cached help message to a file descriptor, such as STDOUT_FILENO
+        template <IsCommandHandle HandleT>
+        [[nodiscard]] auto write_help_message(
+            const int fd, const HandleT& handle, const size_t width = detail::HelpMessageBuilder::defaultLineWidth
+        ) const -> std::expected<void, std::string> {
+            const auto message = get_shared_help_message(handle.get_id(), width);
+            std::string_view remaining = *message;
+            while (!remaining.empty()) {
+                const auto count = detail::write_descriptor(fd, remaining.data(), remaining.size());
+                if (count < 0 && errno == EINTR) continue;
+                if (count <= 0) {
+                    return std::unexpected(std::format("Unable to write help message to file descriptor {}", fd));
+                }
+                remaining.remove_prefix(static_cast<size_t>(count));
+            }
+            return {};
+        }
+
+        // Tokens of the form '@path' are replaced by the arguments listed in that file. The files stay mapped until the
+        // next call to run, since parsed values may refer to them.
+        auto enable_response_files(const ResponseFileConfig config = {}) -> void {
+            m_responseFileConfig = config;
+        }
+
+        // Options that are not given on the command line are read from this file. The file is read again on every
+        // call to run, and an optional file that does not exist is skipped.
+        auto enable_config_file(std::filesystem::path path,
+                                const ConfigFilePresence presence = ConfigFilePresence::Optional) -> void {
+            m_configFilePath = std::move(path);
+            m_configFilePresence = presence;
+        }
+
+        // Arguments separated by NUL or newline characters are read from a file descriptor, such as the output of
+        // 'find -print0' piped to stdin, and given to the positional options after those on the command line. The
+        // descriptor is only read when the command line contains config.option.
+        auto enable_descriptor_source(DescriptorSourceConfig config = {}) -> void {
+            if (config.option.empty()) throw std::invalid_argument("Descriptor source option must not be empty");
+            m_descriptorSourceConfig = std::move(config);
+        }
+
+        // Stops parsing once this many errors are found, in argv, the environment, the config file or the constraints.
+        // A limit of 1 fails fast on the first error. By default every error is reported.
+        auto set_error_limit(const size_t limit) -> void {
+            if (limit == 0) throw std::invalid_argument("Error limit must be at least 1");
+            m_errorLimit = limit;
+        }
+
+        [[nodiscard]] auto run(const int argc, const char * const *argv) -> std::expected<void, CliRunError> {
+            auto argvView = make_argv_view(argc, argv);
+            if (!argvView.has_value()) {
+                return std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{m_rootId},
+                    .messages = std::vector{Error(ErrorCode::Source, std::move(argvView.error()))}
+                });
+            }
+
+            detail::ArgvView& view = argvView.value();
+            set_program_name(std::filesystem::path(view.next()).filename().string());
+            return run_view(view);
+        }
+
+        // Parses the command line of the current process from /proc/self/cmdline, for libraries loaded into a host
+        // process that cannot see argc and argv. With a marker, only the arguments after its first occurrence are
+        // parsed, and none are if it is missing. The file is read once per call into a buffer that the arguments
+        // refer to, so they do not depend on the host's argv.
+        [[nodiscard]] auto run_process_cmdline(const std::optional<std::string_view> marker = std::nullopt)
+            -> std::expected<void, CliRunError> {
+            m_successfulCommandId.reset();
+            const auto error = [this](std::string message) {
+                return std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{m_rootId},
+                    .messages = std::vector{Error(ErrorCode::Source, std::move(message))}
+                });
+            };
+#if defined(__linux__)
+            // procfs reports a size of zero, so the file is read rather than mapped
+            const int fd = ::open("/proc/self/cmdline", O_RDONLY);
+            if (fd == -1) return error("Unable to read /proc/self/cmdline");
+            m_processArguments.clear();
+            const bool read = detail::read_all_descriptor(fd, m_processArguments);
+            ::close(fd);
+            if (!read) return error("Unable to read /proc/self/cmdline");
+            return run_cmdline(m_processArguments, marker);
+#else
+            (void) marker;
+            return error("Reading the process command line is only supported on Linux");
+#endif
+        }
+
+        // Parses a command line in the format of /proc/<pid>/cmdline: the program name and arguments, each followed by a
+        // NUL. Markers work as in run_process_cmdline. Arguments are views into contents, which must outlive any
+        // std::string_view results.
+        [[nodiscard]] auto run_cmdline(
+            std::string_view contents,
+            const std::optional<std::string_view> marker = std::nullopt
+        ) -> std::expected<void, CliRunError> {
+            m_successfulCommandId.reset();
+            if (contents.ends_with('\0')) contents.remove_suffix(1);
+            if (contents.empty()) {
+                return std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{m_rootId},
+                    .messages = std::vector{Error(ErrorCode::Source, "The command line is empty")}
+                });
+            }
+            std::vector<std::string_view> args;
+            for (const auto arg : contents | std::views::split('\0')) {
+                args.emplace_back(arg.begin(), arg.end());
+            }
+
+            set_program_name(std::filesystem::path(args.front()).filename().string());
+            auto first = args.begin() + 1;
+            if (marker.has_value()) {
+                first = std::ranges::find(first, args.end(), marker.value());
+                if (first != args.end()) ++first;
+            }
+            return run_words(std::vector(first, args.end()));
+        }
+
+        // Splits line like a POSIX shell, with quotes and backslash escapes but no expansions, and runs the words as
+        // the arguments after the program name. Words refer to line unless they had to be unescaped, so line must
+        // outlive any std::string_view results. Those copies are kept until the next call to run_line.
+        [[nodiscard]] auto run_line(const std::string_view line) -> std::expected<void, CliRunError> {
+            m_successfulCommandId.reset();
+            auto words = detail::CommandLineSplitter{line, m_lineBuffer}.split();
+            if (!words.has_value()) {
+                return std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{m_rootId},
+                    .messages = std::vector{
+                        Error(ErrorCode::Source, std::string(detail::get_split_error_message(words.error())))}
+                });
+            }
+
+            return run_words(std::move(words.value()));
+        }
+
+        // Reads command lines from nextLine until it returns false or handler returns false, running each like run_line
+        // and passing the outcome to handler. nextLine stores the next line, without its newline, in the string it is
+        // given. Lines ending inside quotes or after a backslash continue on the next line, and blank or comment lines
+        // are skipped. Results of a line are only valid while handler runs.
+        template <typename LineSource, typename Handler>
+            requires std::is_invocable_r_v<bool, LineSource&, std::string&>
+                && std::is_invocable_r_v<bool, Handler&, const std::expected<void, CliRunError>&>
+        auto run_repl(LineSource nextLine, Handler handler) -> void {
+            std::string line;
+            std::string next;
+            while (std::invoke(nextLine, next)) {
+                if (!line.empty()) line += '\n';
+                line += next;
+
+                auto words = detail::CommandLineSplitter{line, m_lineBuffer}.split();
+                if (!words.has_value()) continue;
+                if (words->empty()) {
+                    line.clear();
+                    continue;
+                }
+
+                const std::expected<void, CliRunError> result = run_words(std::move(words.value()));
+                if (!std::invoke(handler, result)) return;
+                line.clear();
+            }
+            if (line.empty()) return;
+
+            // The input ended inside quotes or after a backslash
+            const auto words = detail::CommandLineSplitter{line, m_lineBuffer}.split();
+            m_successfulCommandId.reset();
+            const std::expected<void, CliRunError> result = std::unexpected(CliRunError{
+                .handle = AnyCommandHandle{m_rootId},
+                .messages = std::vector{
+                    Error(ErrorCode::Source, std::string(detail::get_split_error_message(words.error())))}
+            });
+            std::invoke(handler, result);
+        }
+
+        // Reads command lines from an input stream, such as std::cin, which is only used through std::getline
+        template <typename Input, typename Handler>
+            requires requires(Input& input, std::string& line) { std::getline(input, line); }
+                && std::is_invocable_r_v<bool, Handler&, const std::expected<void, CliRunError>&>
+        auto run_repl(Input& input, Handler handler) -> void {
+            run_repl([&input](std::string& line) -> bool { return static_cast<bool>(std::getline(input, line)); },
+                std::move(handler));
+        }
+
+        // Encodes the results of the last successful run: the selected command path, and the value source and values of
+        // each of its options. Only builtin value types, including enums, can be written.
+        [[nodiscard]] auto write_snapshot() const -> std::expected<std::string, std::string> {
+            if (!m_successfulCommandId.has_value()) {
+                return std::unexpected(std::string("A snapshot can only be written after a successful run"));
+            }
+
+            detail::SnapshotWriter out;
+            out.write_string(snapshotMagic);
+            const std::vector<const detail::CommandBase *> path = search_subcommand(m_successfulCommandId.value());
+            out.write_raw(static_cast<uint32_t>(path.size() - 1));
+            for (const detail::CommandBase *cmd : path | std::views::drop(1)) {
+                out.write_string(cmd->m_name);
+            }
+            if (auto success = path.back()->m_context.write_snapshot(out); !success.has_value()) {
+                return std::unexpected(std::move(success.error()));
+            }
+            return std::move(out).take();
+        }
+
+        [[nodiscard]] auto write_snapshot(const int fd) const -> std::expected<void, std::string> {
+            auto snapshot = write_snapshot();
+            if (!snapshot.has_value()) return std::unexpected(std::move(snapshot.error()));
+
+            std::string_view remaining = snapshot.value();
+            while (!remaining.empty()) {
+                const auto count = detail::write_descriptor(fd, remaining.data(), remaining.size());
+                if (count < 0 && errno == EINTR) continue;
+                if (count <= 0) return std::unexpected(std::format("Unable to write snapshot to file descriptor {}", fd));
+                remaining.remove_prefix(static_cast<size_t>(count));
+            }
+            return {};
+        }
+
+        // Restores the results written by write_snapshot in a Cli with the same commands and options, as if it had run
+        // successfully. Values are read in place, so std::string_view values refer to the snapshot, which must outlive
+        // them.
+        [[nodiscard]] auto load_snapshot(const std::string_view snapshot) -> std::expected<void, std::string> {
+            m_successfulCommandId.reset();
+            const auto malformed = std::unexpected(std::string("Snapshot is truncated or malformed"));
+
+            detail::SnapshotReader in{snapshot};
+            if (in.read_string() != snapshotMagic) return malformed;
+            const auto depth = in.read_raw<uint32_t>();
+            if (!depth.has_value()) return malformed;
+
+            detail::CommandBase *selectedCmd = &m_root;
+            detail::UniqueId selectedId = m_rootId;
+            for (uint32_t i = 0; i < depth.value(); i++) {
+                const auto name = in.read_string();
+                if (!name.has_value()) return malformed;
+                const auto it = std::ranges::find_if(selectedCmd->m_subcommands, [&](const auto& subcommand) {
+                    return subcommand.second->m_name == name.value();
+                });
+                if (it == selectedCmd->m_subcommands.end()) {
+                    return std::unexpected(std::format("Subcommand '{}' in the snapshot does not exist", name.value()));
+                }
+                auto built = resolve_subcommand(*it);
+                if (!built.has_value()) return std::unexpected(std::move(built.error()));
+                selectedId = it->first;
+                selectedCmd = built.value();
+            }
+
+            if (auto success = selectedCmd->m_context.read_snapshot(in); !success.has_value()) return success;
+            if (!in.empty()) return malformed;
+            m_successfulCommandId = selectedId;
+            return {};
+        }
+
+        // Reads a snapshot from a file descriptor until it ends. The snapshot is kept until the next call.
+        [[nodiscard]] auto load_snapshot(const int fd) -> std::expected<void, std::string> {
+            m_snapshotBuffer.clear();
+            if (!detail::read_all_descriptor(fd, m_snapshotBuffer)) {
+                return std::unexpected(std::format("Unable to read snapshot from file descriptor {}", fd));
+            }
+            return load_snapshot(std::string_view(m_snapshotBuffer));
+        }
+
+        // The help message or version asked for by a built-in option in the last run, or null if none was given. Such a
+        // run succeeds without results, since the rest of the command line is not parsed.
+        [[nodiscard]] auto get_builtin_output() const -> std::shared_ptr<const std::string> {
+            return m_builtinOutput;
+        }
+
         [[nodiscard]] auto get_root_handle() const -> CommandHandle<RootCommandTag> {
             const CommandHandle<RootCommandTag> handle{m_rootId};
             return handle;
@@ -3276,4 +7838,150 @@ namespace argon {
             return Results<CmdTag>{subCmd.back()->m_context};
         }
     };
+} // namespace argon
+
+
+namespace argon {
+    // Parses the same arguments again on demand, so that options read from configuration files, response files and
+    // the environment can change while a program runs. Each successful parse is published as a new immutable Cli, and
+    // readers keep the one they loaded for as long as they need it.
+    class ReloadableCli {
+        struct Parse {
+            std::shared_ptr<const std::vector<std::string>> args;
+            Cli cli;
+            std::unordered_map<detail::UniqueId, std::optional<std::string>> encodedOptions;
+        };
+
+        Cli m_prototype;
+        std::shared_ptr<const std::vector<std::string>> m_args;
+        std::atomic<std::shared_ptr<const Parse>> m_current;
+        std::mutex m_reloadMutex;
+
+        [[nodiscard]] auto parse() const -> std::expected<std::shared_ptr<const Parse>, CliRunError> {
+            std::vector<const char *> argv;
+            argv.reserve(m_args->size());
+            for (const std::string& arg : *m_args) {
+                argv.push_back(arg.c_str());
+            }
+
+            Cli cli = m_prototype.clone_definition();
+            if (auto success = cli.run(static_cast<int>(argv.size()), argv.data()); !success.has_value()) {
+                return std::unexpected(std::move(success.error()));
+            }
+            // Lazily converted values are converted before publishing, so that a published Cli is fully validated and
+            // readers never write to it
+            const detail::Context& context = cli.get_successful_context();
+            if (auto errors = context.convert_deferred_values(); !errors.empty()) {
+                return std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{cli.m_successfulCommandId.value()},
+                    .messages = std::move(errors)
+                });
+            }
+            auto encodedOptions = context.encode_options();
+            return std::make_shared<const Parse>(Parse{
+                .args = m_args,
+                .cli = std::move(cli),
+                .encodedOptions = std::move(encodedOptions)
+            });
+        }
+
+        [[nodiscard]] static auto diff(const Parse& before, const Parse& after) -> ResultsDiff {
+            ResultsDiff diff;
+            if (before.cli.m_successfulCommandId != after.cli.m_successfulCommandId) {
+                diff.m_commandChanged = true;
+                return diff;
+            }
+            for (const auto& [id, encoded] : after.encodedOptions) {
+                const auto& previous = before.encodedOptions.at(id);
+                if (!encoded.has_value() || !previous.has_value() || encoded != previous) {
+                    diff.m_changed.insert(id);
+                }
+            }
+            return diff;
+        }
+
+    public:
+        explicit ReloadableCli(Cli cli) : m_prototype(std::move(cli)) {}
+
+        // Parses argv for the first time and publishes the results. argv is copied, so that reloads can use it.
+        [[nodiscard]] auto run(const int argc, const char * const *argv) -> std::expected<void, CliRunError> {
+            const std::scoped_lock lock(m_reloadMutex);
+            m_args = std::make_shared<const std::vector<std::string>>(argv, argv + argc);
+            auto parsed = parse();
+            if (!parsed.has_value()) return std::unexpected(std::move(parsed.error()));
+            m_current.store(std::move(parsed.value()));
+            return {};
+        }
+
+        // Parses the arguments from run again, reading every source again, and publishes the results if they pass all
+        // validators and constraints. Lazily converted values are converted and validated before that too. On failure,
+        // the current results stay published.
+        [[nodiscard]] auto reload() -> std::expected<ResultsDiff, CliRunError> {
+            const std::scoped_lock lock(m_reloadMutex);
+            const auto previous = m_current.load();
+            if (previous == nullptr) throw std::logic_error("ReloadableCli::reload called before a successful run");
+
+            auto parsed = parse();
+            if (!parsed.has_value()) return std::unexpected(std::move(parsed.error()));
+            ResultsDiff changes = diff(*previous, *parsed.value());
+            m_current.store(std::move(parsed.value()));
+            return changes;
+        }
+
+        // The most recently published results, or nullptr before a successful run. Safe to call from any thread.
+        [[nodiscard]] auto current() const -> std::shared_ptr<const Cli> {
+            std::shared_ptr<const Parse> parse = m_current.load();
+            if (parse == nullptr) return nullptr;
+            return std::shared_ptr<const Cli>(parse, &parse->cli);
+        }
+    };
+} // namespace argon
+
+
+namespace argon {
+    // Parses a command line again each time it is edited, for interactive programs that validate it as it is typed.
+    // Each update gives the same results and errors as running a Cli on the words, but options given the same words as
+    // in the last update keep their converted values, and constraints that only check which options are set are only
+    // evaluated again when that changes. An update with the words of the last one returns the last outcome.
+    class ParseSession {
+        Cli m_cli;
+        detail::ParseMemo m_memo;
+        std::optional<std::vector<std::string>> m_words;
+        std::expected<void, CliRunError> m_outcome;
+        std::string m_lineBuffer;
+
+    public:
+        // The session parses with a copy of the commands and the sources of cli
+        explicit ParseSession(const Cli& cli) : m_cli(cli.clone_definition()) {}
+
+        // Parses words, which do not include the program name, like Cli::run_line parses the words of a line
+        [[nodiscard]] auto update(const std::span<const std::string_view> words)
+            -> const std::expected<void, CliRunError>& {
+            if (m_words.has_value() && std::ranges::equal(m_words.value(), words)) return m_outcome;
+            // The values of options refer to the copied words
+            m_words.emplace(words.begin(), words.end());
+            m_outcome = m_cli.run_words(std::vector<std::string_view>(m_words->begin(), m_words->end()), &m_memo);
+            return m_outcome;
+        }
+
+        [[nodiscard]] auto update_line(const std::string_view line) -> const std::expected<void, CliRunError>& {
+            const auto words = detail::CommandLineSplitter{line, m_lineBuffer}.split();
+            if (!words.has_value()) {
+                m_words.reset();
+                m_cli.m_successfulCommandId.reset();
+                m_outcome = std::unexpected(CliRunError{
+                    .handle = AnyCommandHandle{m_cli.m_rootId},
+                    .messages = std::vector{
+                        Error(ErrorCode::Source, std::string(detail::get_split_error_message(words.error())))}
+                });
+                return m_outcome;
+            }
+            return update(words.value());
+        }
+
+        // The Cli that holds the results of the last update
+        [[nodiscard]] auto get_cli() const -> const Cli& {
+            return m_cli;
+        }
+    };
 } // namespace argon
\ No newline at end of file
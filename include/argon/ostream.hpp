@@ -0,0 +1,15 @@
+#pragma once
+
+#include <iterator>
+#include <ostream>
+
+#include "argon.hpp"
+
+namespace argon {
+    // Writes the message of an error. Kept out of argon.hpp so that programs which do not use streams do not include
+    // them.
+    inline auto operator<<(std::ostream& out, const Error& error) -> std::ostream& {
+        error.format_to(std::ostreambuf_iterator<char>(out));
+        return out;
+    }
+} // namespace argon
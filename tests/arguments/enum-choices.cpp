@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <helpers/cli.hpp>
+
+#include "catch2/matchers/catch_matchers.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+
+enum class Mode {
+    Fast,
+    Balanced,
+    Thorough,
+};
+
+enum class Level : int8_t {
+    Low = -4,
+    Medium = 0,
+    High = 100,
+};
+
+enum class Port : uint16_t {
+    Http = 80,
+    Https = 443,
+};
+
+template <>
+struct argon::EnumRange<Port> {
+    constexpr static int min = 0;
+    constexpr static int max = 500;
+};
+
+TEST_CASE("enum reflection", "[argon][arguments][choice][enum]") {
+    STATIC_REQUIRE(argon::enum_name(Mode::Fast) == "Fast");
+    STATIC_REQUIRE(argon::enum_name(Mode::Thorough) == "Thorough");
+    STATIC_REQUIRE(argon::enum_name(Level::Low) == "Low");
+    STATIC_REQUIRE(argon::enum_name(Level::High) == "High");
+    STATIC_REQUIRE(argon::enum_name(Port::Https) == "Https");
+    STATIC_REQUIRE(argon::enum_name(static_cast<Mode>(5)).empty());
+
+    STATIC_REQUIRE(argon::detail::EnumReflection<Mode>::entries.size() == 3);
+    STATIC_REQUIRE(argon::detail::EnumReflection<Mode>::from_name("Balanced") == Mode::Balanced);
+    STATIC_REQUIRE(argon::detail::EnumReflection<Mode>::from_name("balanced") == std::nullopt);
+}
+
+TEST_CASE("basic enum choice test", "[argon][arguments][choice][enum]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto mode_handle = cmd.add_choice(argon::Choice<Mode>("--mode"));
+    const auto level_handle = cmd.add_choice(argon::Choice<Level>("--level").with_default(Level::Medium));
+    argon::Cli cli{cmd};
+
+    SECTION("valid values") {
+        const Argv argv{"--mode", "Thorough", "--level", "Low"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, mode_handle, Mode::Thorough);
+        CHECK_SINGLE_RESULT(results, level_handle, Level::Low);
+    }
+
+    SECTION("default value") {
+        const Argv argv{"--mode", "Fast"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, mode_handle, Mode::Fast);
+        CHECK_SINGLE_RESULT(results, level_handle, Level::Medium);
+    }
+
+    SECTION("invalid value") {
+        const Argv argv{"--mode", "Slow"};
+        const auto [handle, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(
+            messages[0],
+            Catch::Matchers::ContainsSubstring("Invalid value 'Slow'") &&
+            Catch::Matchers::ContainsSubstring("Fast | Balanced | Thorough")
+        );
+    }
+
+    SECTION("help message lists enumerators in declaration order") {
+        const auto help = cli.get_help_message(cli.get_root_handle());
+        CHECK_THAT(help, Catch::Matchers::ContainsSubstring("--mode <Fast|Balanced|Thorough>"));
+        CHECK_THAT(help, Catch::Matchers::ContainsSubstring("--level <Low|Medium|High>"));
+    }
+}
+
+TEST_CASE("basic enum multi-choice test", "[argon][arguments][multi-choice][enum]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto ports_handle = cmd.add_multi_choice(argon::MultiChoice<Port>("--ports"));
+    argon::Cli cli{cmd};
+
+    SECTION("valid values") {
+        const Argv argv{"--ports", "Https", "Http", "--ports", "Https"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, ports_handle, {Port::Https, Port::Http, Port::Https});
+    }
+
+    SECTION("invalid value") {
+        const Argv argv{"--ports", "Http", "Ftp"};
+        const auto [handle, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(
+            messages[0],
+            Catch::Matchers::ContainsSubstring("Invalid value 'Ftp'") &&
+            Catch::Matchers::ContainsSubstring("Http | Https")
+        );
+    }
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+
+TEST_CASE("abbreviated flags", "[argon][configuration][with-abbreviations][flag]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto verbose_handle = cmd.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    const auto version_handle = cmd.add_flag(argon::Flag<bool>("--version").with_implicit(true));
+    const auto tags_handle = cmd.add_multi_flag(argon::MultiFlag<std::string>("--tags").with_alias("--labels"));
+    const auto mode_handle = cmd.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}));
+    cmd.enable_abbreviations();
+    const auto out_handle = cmd.add_flag(argon::Flag<std::string>("--out"));
+    const auto output_handle = cmd.add_flag(argon::Flag<std::string>("--output").with_alias("-o"));
+    argon::Cli cli{cmd};
+
+    SECTION("unique prefixes") {
+        REQUIRE_RUN_CLI(cli, {"--verb", "--ta", "a", "b", "--lab", "c", "--mo", "slow", "--outp", "file"});
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, verbose_handle, true);
+        CHECK_FALSE(results.is_specified(version_handle));
+        CHECK_MULTI_RESULT(results, tags_handle, std::vector<std::string>{"a", "b", "c"});
+        CHECK_SINGLE_RESULT(results, mode_handle, 2);
+        CHECK_SINGLE_RESULT(results, output_handle, std::string("file"));
+    }
+
+    SECTION("exact names win over longer ones") {
+        REQUIRE_RUN_CLI(cli, {"--out", "a"});
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, out_handle, std::string("a"));
+        CHECK_FALSE(results.is_specified(output_handle));
+    }
+
+    SECTION("ambiguous prefixes") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, {"--ver"});
+        REQUIRE(messages.size() == 1);
+        CHECK(messages[0].message() == "Ambiguous flag '--ver' at position 1 could be '--verbose' or '--version'");
+
+        const auto [__, outputs] = REQUIRE_ERROR_ON_RUN(cli, {"--mode", "fast", "--o", "x"});
+        REQUIRE(outputs.size() == 1);
+        CHECK(outputs[0].message() == "Ambiguous flag '--o' at position 3 could be '--out' or '--output'");
+    }
+
+    SECTION("short options and unknown names are not abbreviated") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, {"-"});
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unknown flag '-'"));
+
+        const auto [__, unknown] = REQUIRE_ERROR_ON_RUN(cli, {"--verbosity"});
+        REQUIRE(unknown.size() == 1);
+        CHECK_THAT(unknown[0], Catch::Matchers::ContainsSubstring("Unknown flag '--verbosity'"));
+    }
+}
+
+TEST_CASE("abbreviations are opt-in", "[argon][configuration][with-abbreviations][flag]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    std::ignore = cmd.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    std::ignore = cmd.add_subcommand(argon::Command<struct Deploy>{"deploy", ""});
+    argon::Cli cli{cmd};
+
+    const auto [_, flags] = REQUIRE_ERROR_ON_RUN(cli, {"--verb"});
+    REQUIRE(flags.size() == 1);
+    CHECK_THAT(flags[0], Catch::Matchers::ContainsSubstring("Unknown flag '--verb'"));
+
+    const auto [__, subcommands] = REQUIRE_ERROR_ON_RUN(cli, {"dep"});
+    REQUIRE(subcommands.size() == 1);
+    CHECK_THAT(subcommands[0], Catch::Matchers::ContainsSubstring("Unknown subcommand 'dep'"));
+}
+
+TEST_CASE("abbreviated subcommands", "[argon][configuration][with-abbreviations][subcommand]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    cmd.enable_abbreviations();
+    argon::Command<struct Deploy> deploy{"deploy", ""};
+    deploy.enable_abbreviations();
+    const auto count_handle = deploy.add_flag(argon::Flag<int>("--count"));
+    const auto deploy_handle = cmd.add_subcommand(std::move(deploy));
+    const auto delete_handle = cmd.add_subcommand(argon::Command<struct Delete>{"delete", ""});
+    const auto builds = std::make_shared<int>(0);
+    const auto status_handle = cmd.add_subcommand_lazy("status", "", [=] {
+        ++*builds;
+        return argon::Command<struct Status>{"status", ""};
+    });
+    argon::Cli cli{cmd};
+
+    SECTION("unique prefixes") {
+        REQUIRE_RUN_CLI(cli, {"dep", "--cou", "3"});
+        const auto results = REQUIRE_COMMAND(cli, deploy_handle);
+        CHECK_SINGLE_RESULT(results, count_handle, 3);
+
+        REQUIRE_RUN_CLI(cli, {"dele"});
+        CHECK(cli.try_get_results(delete_handle).has_value());
+    }
+
+    SECTION("lazy subcommands") {
+        REQUIRE_RUN_CLI(cli, {"st"});
+        CHECK(cli.try_get_results(status_handle).has_value());
+        CHECK(*builds == 1);
+    }
+
+    SECTION("ambiguous prefixes") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, {"de"});
+        REQUIRE(messages.size() == 1);
+        CHECK(messages[0].message() == "Ambiguous subcommand 'de' could be 'delete' or 'deploy'");
+    }
+}
+
+TEST_CASE("radix trie prefix lookup", "[argon][configuration][with-abbreviations]") {
+    argon::detail::RadixTrie trie;
+    for (const std::string_view name : {"--verbose", "--version", "--verb", "--values", "--x", "--verbose"}) {
+        trie.insert(name);
+    }
+
+    using Names = std::vector<std::string_view>;
+    CHECK(trie.find_prefix("--verb") == Names{"--verb"});
+    CHECK(trie.find_prefix("--verbo") == Names{"--verbose"});
+    CHECK(trie.find_prefix("--ver") == Names{"--verb", "--verbose", "--version"});
+    CHECK(trie.find_prefix("--v") == Names{"--values", "--verb", "--verbose", "--version"});
+    CHECK(trie.find_prefix("--") == Names{"--values", "--verb", "--verbose", "--version", "--x"});
+    CHECK(trie.find_prefix("--verbosely").empty());
+    CHECK(trie.find_prefix("--y").empty());
+}
@@ -0,0 +1,195 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+
+namespace {
+    auto counting_int_conversion(const std::shared_ptr<int>& calls) -> argon::detail::ConversionFn<int> {
+        return [calls](const std::string_view arg) -> std::optional<int> {
+            ++*calls;
+            if (arg.empty() || !std::ranges::all_of(arg, [](const char c) { return std::isdigit(c); })) {
+                return std::nullopt;
+            }
+            return std::stoi(std::string(arg));
+        };
+    }
+}
+
+TEST_CASE("lazy flags", "[argon][configuration][with-lazy-conversion][flag]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto calls = std::make_shared<int>(0);
+    const auto int_handle = cmd.add_flag(
+        argon::Flag<int>("--int")
+            .with_conversion_fn(counting_int_conversion(calls), "expected digits")
+            .with_value_validator([](const int x) { return x < 100; }, "must be less than 100")
+            .with_lazy_conversion()
+    );
+    const auto def_handle = cmd.add_flag(
+        argon::Flag<int>("--def")
+            .with_conversion_fn(counting_int_conversion(calls), "expected digits")
+            .with_default(7)
+            .with_lazy_conversion()
+    );
+    argon::Cli cli{cmd};
+
+    SECTION("conversion is deferred and memoized") {
+        const Argv argv{"--int", "42"};
+        REQUIRE_RUN_CLI(cli, argv);
+        CHECK(*calls == 0);
+
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.is_specified(int_handle));
+        CHECK(*calls == 0);
+
+        CHECK_SINGLE_RESULT(results, int_handle, 42);
+        CHECK_SINGLE_RESULT(results, int_handle, 42);
+        CHECK(*calls == 1);
+
+        CHECK_FALSE(results.is_specified(def_handle));
+        CHECK_SINGLE_RESULT(results, def_handle, 7);
+        CHECK(*calls == 1);
+    }
+
+    SECTION("conversion failure is reported on access") {
+        const Argv argv{"--int", "abc"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+
+        const auto value = results.try_get(int_handle);
+        REQUIRE_FALSE(value.has_value());
+        CHECK_THAT(value.error(), Catch::Matchers::ContainsSubstring("Invalid value 'abc' for flag '--int'"));
+        CHECK_THROWS_WITH(std::ignore = results.get(int_handle), Catch::Matchers::ContainsSubstring("expected digits"));
+        CHECK_THROWS_AS(std::ignore = results.get(int_handle), argon::ConversionError);
+        CHECK(*calls == 1);
+    }
+
+    SECTION("validation failure is reported on access") {
+        const Argv argv{"--int", "500"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+
+        const auto value = results.try_get(int_handle);
+        REQUIRE_FALSE(value.has_value());
+        CHECK_THAT(value.error(), Catch::Matchers::ContainsSubstring("must be less than 100"));
+    }
+}
+
+TEST_CASE("lazy multi-value options", "[argon][configuration][with-lazy-conversion][multi-flag][multi-positional]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto calls = std::make_shared<int>(0);
+    const auto ints_handle = cmd.add_multi_flag(
+        argon::MultiFlag<int>("--ints")
+            .with_conversion_fn(counting_int_conversion(calls), "expected digits")
+            .with_group_validator([](const std::vector<int>& xs) { return xs.size() >= 3; }, "at least three values")
+            .with_lazy_conversion()
+    );
+    const auto pos_handle = cmd.add_multi_positional(
+        argon::MultiPositional<int>("values")
+            .with_conversion_fn(counting_int_conversion(calls), "expected digits")
+            .with_lazy_conversion()
+    );
+    argon::Cli cli{cmd};
+
+    SECTION("values accumulate across occurrences") {
+        const Argv argv{"5", "6", "--ints", "1", "2", "--ints", "3"};
+        REQUIRE_RUN_CLI(cli, argv);
+        CHECK(*calls == 0);
+
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, ints_handle, {1, 2, 3});
+        CHECK(*calls == 3);
+        CHECK_MULTI_RESULT(results, pos_handle, {5, 6});
+        CHECK(*calls == 5);
+    }
+
+    SECTION("group validation is deferred") {
+        const Argv argv{"--ints", "1", "--ints", "2"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+
+        const auto values = results.try_get(ints_handle);
+        REQUIRE_FALSE(values.has_value());
+        REQUIRE(values.error().size() == 1);
+        CHECK_THAT(values.error()[0], Catch::Matchers::ContainsSubstring("at least three values"));
+    }
+}
+
+TEST_CASE("lazy command", "[argon][configuration][with-lazy-conversion][command]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto calls = std::make_shared<int>(0);
+    const auto before_handle = cmd.add_flag(
+        argon::Flag<int>("--before").with_conversion_fn(counting_int_conversion(calls), "expected digits"));
+    cmd.enable_lazy_conversion();
+    const auto after_handle = cmd.add_positional(
+        argon::Positional<int>("after").with_conversion_fn(counting_int_conversion(calls), "expected digits"));
+
+    const std::string msg = "--before requires the positional";
+    cmd.constraints.when(argon::present(before_handle), msg)
+        .require(argon::present(after_handle), "missing positional");
+    argon::Cli cli{cmd};
+
+    SECTION("constraints are evaluated from presence alone") {
+        const Argv argv{"--before", "x"};
+        const auto [handle, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring(msg));
+        CHECK(*calls == 0);
+    }
+
+    SECTION("all options of the command are deferred") {
+        const Argv argv{"--before", "1", "2"};
+        REQUIRE_RUN_CLI(cli, argv);
+        CHECK(*calls == 0);
+
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, after_handle, 2);
+        CHECK(*calls == 1);
+        CHECK_SINGLE_RESULT(results, before_handle, 1);
+        CHECK(*calls == 2);
+    }
+}
+
+TEST_CASE("lazy values read by conditions", "[argon][configuration][with-lazy-conversion][constraints]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto calls = std::make_shared<int>(0);
+    const auto count_handle = cmd.add_flag(argon::Flag<int>("--count")
+        .with_conversion_fn(counting_int_conversion(calls), "expected digits").with_lazy_conversion());
+    const auto ints_handle = cmd.add_multi_flag(argon::MultiFlag<int>("--ints")
+        .with_conversion_fn(counting_int_conversion(calls), "expected digits").with_lazy_conversion());
+    cmd.constraints.require(argon::condition<argon::RootCommandTag>([count_handle](const argon::Results<>& results) {
+        return results.get(count_handle).value_or(1) > 0;
+    }), "--count must be positive");
+    cmd.constraints.when(argon::present(ints_handle), "")
+        .require(argon::condition<argon::RootCommandTag>([ints_handle](const argon::Results<>& results) {
+            return results.get(ints_handle).size() < 3;
+        }), "at most two --ints");
+    argon::Cli cli{cmd};
+
+    SECTION("conversion failures are reported as errors of the run") {
+        const Argv argv{"--count", "x", "--ints", "1", "y"};
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(errors.size() == 2);
+        CHECK(errors[0].code() == argon::ErrorCode::InvalidValue);
+        CHECK(errors[0].option() == "--count");
+        CHECK(errors[0].value() == "x");
+        CHECK(errors[1].code() == argon::ErrorCode::InvalidValue);
+        CHECK(errors[1].option() == "--ints");
+        CHECK(errors[1].value() == "y");
+    }
+
+    SECTION("converted values are checked") {
+        REQUIRE_RUN_CLI(cli, Argv{"--count", "2", "--ints", "1"});
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, Argv{"--count", "0"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].message() == "--count must be positive");
+    }
+
+    SECTION("parse sessions") {
+        argon::ParseSession session{cli};
+        const auto& outcome = session.update_line("--count x");
+        REQUIRE_FALSE(outcome.has_value());
+        REQUIRE(outcome.error().messages.size() == 1);
+        CHECK(outcome.error().messages[0].code() == argon::ErrorCode::InvalidValue);
+    }
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+
+namespace {
+    constexpr int num_values = 5000;
+
+    auto make_argv(const std::string_view flag) -> Argv {
+        Argv argv{};
+        if (!flag.empty()) argv.append(flag);
+        for (int i = 0; i < num_values; i++) {
+            argv.append(i % 1000 == 999 ? std::format("bad{}", i) : std::to_string(i));
+        }
+        return argv;
+    }
+}
+
+TEST_CASE("parallel multi-positional conversion", "[argon][configuration][with-parallel-conversion][multi-positional]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto handle = cmd.add_multi_positional(
+        argon::MultiPositional<int>("ints")
+            .with_value_validator([](const int x) { return x % 1000 != 500; }, "must not end in 500")
+            .with_parallel_conversion(100, 4)
+    );
+    argon::Cli cli{cmd};
+
+    SECTION("values keep their input order") {
+        Argv argv{};
+        for (int i = 0; i < num_values; i++) {
+            argv.append(std::to_string(i % 1000 == 500 ? 0 : i));
+        }
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        const auto& ints = results.get(handle);
+        REQUIRE(ints.size() == num_values);
+        for (int i = 0; i < num_values; i++) {
+            CHECK(ints[i] == (i % 1000 == 500 ? 0 : i));
+        }
+    }
+
+    SECTION("errors are reported in input order") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, make_argv(""));
+        REQUIRE(messages.size() == 10);
+        for (int i = 0; i < 5; i++) {
+            CHECK_THAT(messages[i * 2], Catch::Matchers::ContainsSubstring(std::format("'{}'", i * 1000 + 500)));
+            CHECK_THAT(messages[i * 2 + 1], Catch::Matchers::ContainsSubstring(std::format("'bad{}'", i * 1000 + 999)));
+        }
+    }
+
+    SECTION("below the threshold the serial path is used") {
+        const Argv argv{"1", "2", "3"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.get(handle) == std::vector{1, 2, 3});
+    }
+}
+
+TEST_CASE("parallel conversion with few values per thread", "[argon][configuration][with-parallel-conversion]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto handle = cmd.add_multi_positional(argon::MultiPositional<int>("ints").with_parallel_conversion(10, 8));
+    argon::Cli cli{cmd};
+
+    // Chunks of two values only cover ten values with five of the eight threads
+    Argv argv{};
+    for (int i = 0; i < 10; i++) {
+        argv.append(std::to_string(i));
+    }
+    REQUIRE_RUN_CLI(cli, argv);
+    CHECK(REQUIRE_ROOT_CMD(cli).get(handle) == std::vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+}
+
+TEST_CASE("parallel multi-flag conversion", "[argon][configuration][with-parallel-conversion][multi-flag]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    [[maybe_unused]] const auto handle = cmd.add_multi_flag(
+        argon::MultiFlag<int>("--ints")
+            .with_group_validator([](const std::vector<int>& xs) { return xs.size() < num_values; }, "too many values")
+            .with_parallel_conversion(100)
+    );
+    argon::Cli cli{cmd};
+
+    SECTION("conversion errors are merged deterministically") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, make_argv("--ints"));
+        REQUIRE(messages.size() == 5);
+        for (int i = 0; i < 5; i++) {
+            CHECK_THAT(messages[i], Catch::Matchers::ContainsSubstring(std::format("'bad{}'", i * 1000 + 999)));
+        }
+    }
+
+    SECTION("group validator sees the merged values") {
+        Argv argv{"--ints"};
+        for (int i = 0; i < num_values; i++) {
+            argv.append(std::to_string(i));
+        }
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("too many values"));
+    }
+}
+
+TEST_CASE("parallel conversion propagates exceptions", "[argon][configuration][with-parallel-conversion]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    [[maybe_unused]] const auto handle = cmd.add_multi_positional(
+        argon::MultiPositional<int>("ints")
+            .with_conversion_fn([](const std::string_view arg) -> std::optional<int> {
+                if (arg == "4321") throw std::runtime_error("conversion failed");
+                return 0;
+            }, "expected an integer")
+            .with_parallel_conversion(10, 8)
+    );
+    argon::Cli cli{cmd};
+
+    Argv argv{};
+    for (int i = 0; i < num_values; i++) {
+        argv.append(std::to_string(i));
+    }
+    CHECK_THROWS_AS(cli.run(argv.argc(), argv.argv().data()), std::runtime_error);
+}
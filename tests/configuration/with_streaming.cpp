@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+
+TEST_CASE("streamed multi-positional", "[argon][configuration][with-streaming][multi-positional]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto calls = std::make_shared<int>(0);
+    const auto flag_handle = cmd.add_flag(argon::Flag<int>("--flag"));
+    const auto ints_handle = cmd.add_multi_positional(
+        argon::MultiPositional<int>("ints")
+            .with_conversion_fn([calls](const std::string_view arg) -> std::optional<int> {
+                ++*calls;
+                if (arg.empty() || !std::ranges::all_of(arg, [](const char c) { return std::isdigit(c); })) {
+                    return std::nullopt;
+                }
+                return std::stoi(std::string(arg));
+            }, "expected digits")
+            .with_value_validator([](const int x) { return x < 100; }, "must be less than 100")
+            .with_streaming()
+    );
+    argon::Cli cli{cmd};
+
+    SECTION("values are converted while iterating") {
+        const Argv argv{"1", "--flag", "10", "2", "3"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(*calls == 0);
+        CHECK(results.is_specified(ints_handle));
+        CHECK(results.get(flag_handle) == 10);
+
+        const auto stream = results.stream(ints_handle);
+        REQUIRE_FALSE(stream.empty());
+        std::vector<int> ints;
+        for (const auto& value : stream) {
+            REQUIRE(value.has_value());
+            ints.push_back(value.value());
+            CHECK(*calls == static_cast<int>(ints.size()));
+        }
+        REQUIRE(ints.size() == 3);
+        CHECK(ints == std::vector{1, 2, 3});
+    }
+
+    SECTION("errors are reported per element") {
+        const Argv argv{"1", "abc", "200", "4"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+
+        const auto values = results.stream(ints_handle) | std::ranges::to<std::vector>();
+        REQUIRE(values.size() == 4);
+        CHECK(values[0] == 1);
+        REQUIRE_FALSE(values[1].has_value());
+        CHECK_THAT(values[1].error(), Catch::Matchers::ContainsSubstring("Invalid value 'abc' for 'ints': expected digits"));
+        REQUIRE_FALSE(values[2].has_value());
+        CHECK_THAT(values[2].error(), Catch::Matchers::ContainsSubstring("must be less than 100"));
+        CHECK(values[3] == 4);
+    }
+
+    SECTION("values around flags and after the end of options") {
+        const Argv argv{"1", "--flag", "2", "3", "--", "4", "--flag"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto values = REQUIRE_ROOT_CMD(cli).stream(ints_handle) | std::ranges::to<std::vector>();
+        REQUIRE(values.size() == 4);
+        CHECK(values[0] == 1);
+        CHECK(values[1] == 3);
+        CHECK(values[2] == 4);
+        REQUIRE_FALSE(values[3].has_value());
+        CHECK_THAT(values[3].error(), Catch::Matchers::ContainsSubstring("Invalid value '--flag'"));
+    }
+
+    SECTION("parse sessions") {
+        argon::ParseSession session{cli};
+        REQUIRE(session.update_line("1 --flag 2 3").has_value());
+        REQUIRE(session.update_line("1 --flag 2 3 4").has_value());
+        const auto values = REQUIRE_ROOT_CMD(session.get_cli()).stream(ints_handle) | std::ranges::to<std::vector>();
+        REQUIRE(values.size() == 3);
+        CHECK(values[0] == 1);
+        CHECK(values[2] == 4);
+    }
+
+    SECTION("not specified") {
+        const Argv argv{};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_FALSE(results.is_specified(ints_handle));
+        CHECK(results.stream(ints_handle).empty());
+    }
+
+    SECTION("get is not available") {
+        const Argv argv{"1"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_THROWS_AS(results.get(ints_handle), std::logic_error);
+    }
+}
+
+TEST_CASE("streamed multi-positional default values", "[argon][configuration][with-streaming][multi-positional]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto handle = cmd.add_multi_positional(
+        argon::MultiPositional<std::string>("files")
+            .with_default({"a.txt", "b.txt"})
+            .with_streaming()
+    );
+    argon::Cli cli{cmd};
+
+    const Argv argv{};
+    REQUIRE_RUN_CLI(cli, argv);
+    const auto results = REQUIRE_ROOT_CMD(cli);
+    const auto values = results.stream(handle)
+        | std::views::transform([](const auto& value) { return value.value(); })
+        | std::ranges::to<std::vector>();
+    CHECK(values == std::vector<std::string>{"a.txt", "b.txt"});
+}
+
+TEST_CASE("streaming misuse", "[argon][configuration][with-streaming][multi-positional]") {
+    SECTION("group validators cannot be streamed") {
+        const auto nonEmpty = [](const std::vector<int>& xs) { return !xs.empty(); };
+        CHECK_THROWS_AS(argon::MultiPositional<int>("ints")
+            .with_group_validator(nonEmpty, "must not be empty").with_streaming(), std::logic_error);
+
+        CREATE_DEFAULT_ROOT(cmd);
+        CHECK_THROWS_AS(cmd.add_multi_positional(argon::MultiPositional<int>("ints")
+            .with_streaming().with_group_validator(nonEmpty, "must not be empty")), std::logic_error);
+    }
+
+    SECTION("stream requires with_streaming") {
+        CREATE_DEFAULT_ROOT(other);
+        const auto handle = other.add_multi_positional(argon::MultiPositional<int>("ints"));
+        argon::Cli otherCli{other};
+        const Argv argv{"1"};
+        REQUIRE_RUN_CLI(otherCli, argv);
+        const auto results = REQUIRE_ROOT_CMD(otherCli);
+        CHECK_THROWS_AS(results.stream(handle), std::logic_error);
+    }
+}
@@ -49,4 +49,73 @@ TEST_CASE("missing flag values", "[argon][errors][analysis][missing-values]") {
         REQUIRE(messages.size() == 1);
         CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring(msg));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("unknown flag suggestions", "[argon][errors][analysis][suggestions]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    std::ignore = cmd.add_flag(argon::Flag<int>("--count").with_alias("-c"));
+    std::ignore = cmd.add_flag(argon::Flag<int>("--counter"));
+    std::ignore = cmd.add_multi_flag(argon::MultiFlag<int>("--output"));
+    std::ignore = cmd.add_choice(argon::Choice<int>("--mode", {{"fast", 1}}));
+    argon::Cli cli{cmd};
+
+    SECTION("closest names first") {
+        const auto [handle, messages] = REQUIRE_ERROR_ON_RUN(cli, {"--countr", "1"});
+        REQUIRE(messages.size() == 1);
+        CHECK(messages[0].message() == "Unknown flag '--countr' at position 1. Did you mean '--count' or '--counter'?");
+    }
+
+    SECTION("every kind of option") {
+        const auto [_, output] = REQUIRE_ERROR_ON_RUN(cli, {"--count", "1", "--outptu"});
+        REQUIRE(output.size() == 1);
+        CHECK(output[0].message() == "Unknown flag '--outptu' at position 3. Did you mean '--output'?");
+
+        const auto [__, mode] = REQUIRE_ERROR_ON_RUN(cli, {"--mdoe"});
+        REQUIRE(mode.size() == 1);
+        CHECK_THAT(mode[0], Catch::Matchers::EndsWith("Did you mean '--mode'?"));
+    }
+
+    SECTION("no close names") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, {"--verbose"});
+        REQUIRE(messages.size() == 1);
+        CHECK(messages[0].message() == "Unknown flag '--verbose' at position 1");
+    }
+}
+
+TEST_CASE("bounded edit distance", "[argon][errors][analysis][suggestions]") {
+    const auto reference = [](const std::string_view a, const std::string_view b) {
+        std::vector<std::vector<size_t>> d(a.size() + 1, std::vector<size_t>(b.size() + 1));
+        for (size_t i = 0; i <= a.size(); i++) d[i][0] = i;
+        for (size_t j = 0; j <= b.size(); j++) d[0][j] = j;
+        for (size_t i = 1; i <= a.size(); i++) {
+            for (size_t j = 1; j <= b.size(); j++) {
+                d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+            }
+        }
+        return d[a.size()][b.size()];
+    };
+
+    const std::vector<std::string> words{
+        "", "a", "ab", "ba", "abc", "kitten", "sitting", "--verbose", "--verb", "--version", "deploy", "delpoy",
+        std::string(63, 'x'), std::string(64, 'x'), std::string(64, 'x') + "y", std::string(70, 'x'),
+    };
+    for (const auto& pattern : words) {
+        for (const size_t maxDistance : {size_t{0}, size_t{1}, size_t{3}, size_t{100}}) {
+            const argon::detail::EditDistanceMatcher matcher{pattern, maxDistance};
+            for (const auto& text : words) {
+                const size_t expected = reference(pattern, text);
+                INFO(pattern << " -> " << text << " within " << maxDistance);
+                if (expected <= maxDistance) {
+                    CHECK(matcher.distance(text) == expected);
+                } else {
+                    CHECK_FALSE(matcher.distance(text).has_value());
+                }
+            }
+        }
+    }
+
+    std::vector<std::string> candidates;
+    for (size_t i = 0; i < 5000; i++) candidates.push_back(std::format("command-{}", i));
+    CHECK(argon::detail::find_suggestions("comand-4999", candidates)
+        == std::vector<std::string_view>{"command-4999", "command-1999", "command-2999"});
+}
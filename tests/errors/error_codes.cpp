@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include "catch2/matchers/catch_matchers.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+
+#include <sstream>
+
+#include <argon/ostream.hpp>
+
+#include <helpers/cli.hpp>
+#include <helpers/env.hpp>
+
+TEST_CASE("error codes and positions", "[argon][errors][error-codes]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    std::ignore = cmd.add_flag(argon::Flag<int>("--count"));
+    std::ignore = cmd.add_multi_flag(argon::MultiFlag<int>("--ints"));
+    std::ignore = cmd.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}));
+    std::ignore = cmd.add_positional(argon::Positional<int>("first"));
+    argon::Cli cli{cmd};
+
+    SECTION("unknown flag") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"1", "--cuont"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::UnknownFlag);
+        CHECK(errors[0].position() == 2);
+        CHECK(errors[0].option() == "--cuont");
+        CHECK(errors[0].reason() == "'--count'");
+    }
+
+    SECTION("missing value") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--count"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::MissingValue);
+        CHECK(errors[0].position() == 1);
+        CHECK(errors[0].option() == "--count");
+    }
+
+    SECTION("written to a stream") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--count"});
+        REQUIRE(errors.size() == 1);
+        std::ostringstream out;
+        out << errors[0];
+        CHECK(out.str() == errors[0].message());
+    }
+
+    SECTION("invalid values") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"x", "--count", "abc", "--ints", "1", "two", "--mode", "medium"});
+        REQUIRE(errors.size() == 4);
+        CHECK(errors[0].code() == argon::ErrorCode::InvalidValue);
+        CHECK(errors[0].option() == "--count");
+        CHECK(errors[0].value() == "abc");
+        CHECK(errors[0].position() == 3);
+        CHECK(errors[1].option() == "--ints");
+        CHECK(errors[1].value() == "two");
+        CHECK(errors[1].position() == 6);
+        CHECK(errors[2].option() == "first");
+        CHECK(errors[2].position() == 1);
+        CHECK(errors[2].message() == "Invalid value 'x' for 'first': expected a signed 32-bit integer");
+        CHECK(errors[3].code() == argon::ErrorCode::InvalidChoice);
+        CHECK(errors[3].value() == "medium");
+        CHECK(errors[3].position() == 8);
+        CHECK(errors[3].reason() == "fast | slow");
+    }
+
+    SECTION("reasons are built from the candidates") {
+        const auto names = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"--count", "--mode"});
+        const auto unknown = argon::Error(argon::ErrorCode::UnknownFlag).with_option("--mdoe").with_candidates(names);
+        CHECK(unknown.reason() == "'--mode'");
+        CHECK(unknown.message() == "Unknown flag '--mdoe'. Did you mean '--mode'?");
+        const auto far = argon::Error(argon::ErrorCode::UnknownFlag).with_option("--size").with_candidates(names);
+        CHECK(far.reason().empty());
+        CHECK(far.message() == "Unknown flag '--size'");
+        const auto choice = argon::Error(argon::ErrorCode::InvalidChoice).with_option("--mode").with_value("x")
+            .with_candidates(names);
+        CHECK(choice.message() == "Invalid value 'x' for flag '--mode'. Valid values are: --count | --mode");
+    }
+
+    SECTION("too many positionals") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"1", "2"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::TooManyPositionals);
+        CHECK(errors[0].value() == "2");
+        CHECK(errors[0].position() == 2);
+    }
+
+    SECTION("values are bounded") {
+        const std::string value(100'000, '9');
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--count", value});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].value().size() == argon::Error::maxValueSize);
+        CHECK(errors[0].is_value_truncated());
+        CHECK_THAT(errors[0].message(), Catch::Matchers::StartsWith(
+            std::format("Invalid value '{}...' for flag '--count'", std::string(argon::Error::maxValueSize, '9'))));
+    }
+}
+
+TEST_CASE("error codes of subcommands, sources and constraints", "[argon][errors][error-codes]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto threads = cmd.add_flag(argon::Flag<int>("--threads").with_env("ARGON_TEST_THREADS"));
+    std::ignore = cmd.add_subcommand(argon::Command<struct Build>{"build", ""});
+    cmd.constraints.require(argon::present(threads), "--threads is required");
+    argon::Cli cli{cmd};
+
+    SECTION("unknown subcommand") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"biuld"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::UnknownSubcommand);
+        CHECK(errors[0].option() == "biuld");
+        CHECK(errors[0].position() == 1);
+    }
+
+    SECTION("constraint") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::ConstraintViolation);
+        CHECK(errors[0].message() == "--threads is required");
+    }
+
+    SECTION("environment variable") {
+        const ScopedEnv env{"ARGON_TEST_THREADS", "many"};
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::InvalidValue);
+        CHECK_FALSE(errors[0].position().has_value());
+        CHECK(errors[0].note() == "environment variable 'ARGON_TEST_THREADS'");
+        CHECK_THAT(errors[0].message(), Catch::Matchers::EndsWith("(environment variable 'ARGON_TEST_THREADS')"));
+    }
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <helpers/cli.hpp>
+#include <helpers/env.hpp>
+
+TEST_CASE("error limit", "[argon][errors][error-limit]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    std::ignore = cmd.add_flag(argon::Flag<int>("--count").with_env("ARGON_TEST_COUNT"));
+    std::ignore = cmd.add_multi_flag(argon::MultiFlag<int>("--ints")
+        .with_group_validator([](const std::vector<int>& xs) { return xs.size() < 2; }, "must have fewer than 2 values"));
+    std::ignore = cmd.add_multi_choice(argon::MultiChoice<int>("--modes", {{"fast", 1}, {"slow", 2}}));
+    argon::Cli cli{cmd};
+
+    SECTION("every error is reported by default") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--count", "x", "--ints", "a", "b", "--modes", "c", "d"});
+        CHECK(errors.size() == 5);
+    }
+
+    SECTION("fail fast") {
+        cli.set_error_limit(1);
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--count", "x", "--ints", "a", "b", "--modes", "c", "d"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].option() == "--count");
+    }
+
+    SECTION("multi-value conversion stops at the limit") {
+        cli.set_error_limit(2);
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--ints", "a", "1", "b", "c", "d"});
+        REQUIRE(errors.size() == 2);
+        CHECK(errors[0].value() == "a");
+        CHECK(errors[1].value() == "b");
+        CHECK(errors[1].position() == 4);
+    }
+
+    SECTION("group validation is skipped at the limit") {
+        cli.set_error_limit(1);
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--ints", "1", "a", "2"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::InvalidValue);
+    }
+
+    SECTION("multi-choices stop at the limit") {
+        cli.set_error_limit(1);
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--modes", "c", "d"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].value() == "c");
+    }
+
+    SECTION("environment variables") {
+        cli.set_error_limit(1);
+        const ScopedEnv count{"ARGON_TEST_COUNT", "many"};
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].note() == "environment variable 'ARGON_TEST_COUNT'");
+    }
+
+    SECTION("the limit must be positive") {
+        CHECK_THROWS_AS(cli.set_error_limit(0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("error limit of constraints", "[argon][errors][error-limit]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto threads = cmd.add_flag(argon::Flag<int>("--threads"));
+    const auto level = cmd.add_flag(argon::Flag<int>("--level"));
+    cmd.constraints.require(argon::present(threads), "--threads is required");
+    cmd.constraints.require(argon::present(level), "--level is required");
+    cmd.constraints.when(argon::present(threads), "--threads is set")
+        .require(argon::present(level), "--level is required")
+        .require(argon::absent(level), "--level is forbidden");
+    argon::Cli cli{cmd};
+
+    SECTION("every constraint") {
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--threads", "1"});
+        CHECK(errors.size() == 2);
+    }
+
+    SECTION("first constraint") {
+        cli.set_error_limit(1);
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].message() == "--threads is required");
+    }
+
+    SECTION("conditional constraints") {
+        cli.set_error_limit(2);
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"--threads", "1"});
+        REQUIRE(errors.size() == 2);
+        CHECK(errors[1].message() == "--threads is set: --level is required");
+    }
+}
+
+TEST_CASE("error limit of parallel conversion", "[argon][errors][error-limit]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto calls = std::make_shared<std::atomic<int>>(0);
+    std::ignore = cmd.add_multi_positional(
+        argon::MultiPositional<int>("ints")
+            .with_conversion_fn([calls](const std::string_view arg) -> std::optional<int> {
+                ++*calls;
+                if (arg.empty() || !std::ranges::all_of(arg, [](const char c) { return std::isdigit(c); })) {
+                    return std::nullopt;
+                }
+                return std::stoi(std::string(arg));
+            }, "expected digits")
+            .with_parallel_conversion(10, 4)
+    );
+    argon::Cli cli{cmd};
+    cli.set_error_limit(3);
+
+    Argv argv{};
+    for (int i = 0; i < 1000; i++) {
+        argv.append(i % 2 == 0 ? std::to_string(i) : std::format("bad{}", i));
+    }
+    const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, argv);
+    REQUIRE(errors.size() == 3);
+    CHECK(errors[0].value() == "bad1");
+    CHECK(errors[1].value() == "bad3");
+    CHECK(errors[2].value() == "bad5");
+    CHECK(*calls <= 4 * 6);
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+
+TEST_CASE("built-in help and version options", "[argon][help][builtin-options]") {
+    CREATE_DEFAULT_ROOT(root);
+    const auto conversions = std::make_shared<int>(0);
+    const auto count = root.add_flag(argon::Flag<int>("--count")
+        .with_conversion_fn([conversions](const std::string_view arg) -> std::optional<int> {
+            ++*conversions;
+            if (arg.empty() || !std::ranges::all_of(arg, [](const char c) { return std::isdigit(c); })) {
+                return std::nullopt;
+            }
+            return std::stoi(std::string(arg));
+        }, "expected digits"));
+    const auto rest = root.add_multi_positional(argon::MultiPositional<std::string>("rest"));
+    root.constraints.require(argon::present(count), "--count is required");
+    root.enable_help();
+    root.enable_version("tool 1.2.3");
+
+    argon::Command<struct Deploy> deploy{"deploy", "Deploy a release"};
+    std::ignore = deploy.add_flag(argon::Flag<int>("--replicas"));
+    deploy.enable_help({"--help"});
+    const auto deploy_handle = root.add_subcommand(std::move(deploy));
+    argon::Cli cli{root};
+
+    SECTION("help skips the rest of the parse") {
+        REQUIRE_RUN_CLI(cli, Argv{"--count", "abc", "--help", "--unknown"});
+        const auto output = cli.get_builtin_output();
+        REQUIRE(output != nullptr);
+        CHECK(output == cli.get_shared_help_message(cli.get_root_handle()));
+        CHECK(*conversions == 0);
+        CHECK_FALSE(cli.try_get_results(cli.get_root_handle()).has_value());
+    }
+
+    SECTION("aliases") {
+        REQUIRE_RUN_CLI(cli, Argv{"-h"});
+        CHECK(cli.get_builtin_output() == cli.get_shared_help_message(cli.get_root_handle()));
+    }
+
+    SECTION("version") {
+        REQUIRE_RUN_CLI(cli, Argv{"--version"});
+        REQUIRE(cli.get_builtin_output() != nullptr);
+        CHECK(*cli.get_builtin_output() == "tool 1.2.3");
+    }
+
+    SECTION("subcommands have their own options") {
+        REQUIRE_RUN_CLI(cli, Argv{"deploy", "--replicas", "x", "--help"});
+        CHECK(cli.get_builtin_output() == cli.get_shared_help_message(deploy_handle));
+
+        const auto [_, errors] = REQUIRE_ERROR_ON_RUN(cli, {"deploy", "--version"});
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].code() == argon::ErrorCode::UnknownFlag);
+    }
+
+    SECTION("values after the end of options are not options") {
+        REQUIRE_RUN_CLI(cli, Argv{"--count", "1", "--", "--help"});
+        CHECK(cli.get_builtin_output() == nullptr);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.get(rest) == std::vector<std::string>{"--help"});
+    }
+
+    SECTION("output is reset by the next run") {
+        REQUIRE_RUN_CLI(cli, Argv{"--help"});
+        REQUIRE_RUN_CLI(cli, Argv{"--count", "1"});
+        CHECK(cli.get_builtin_output() == nullptr);
+    }
+
+    SECTION("sources are not read") {
+        cli.enable_config_file("/nonexistent/argon/config.ini");
+        REQUIRE_RUN_CLI(cli, Argv{"--help"});
+        CHECK(cli.get_builtin_output() != nullptr);
+    }
+
+    SECTION("help messages list the options") {
+        using Catch::Matchers::ContainsSubstring;
+        const auto help = cli.get_help_message(cli.get_root_handle());
+        CHECK_THAT(help, ContainsSubstring("    --help, -h     Show this help message\n"));
+        CHECK_THAT(help, ContainsSubstring("    --version      Show the version\n"));
+    }
+}
+
+TEST_CASE("built-in option names", "[argon][help][builtin-options]") {
+    CREATE_DEFAULT_ROOT(root);
+    std::ignore = root.add_flag(argon::Flag<bool>("--version"));
+    root.enable_help();
+
+    CHECK_THROWS_AS(root.add_flag(argon::Flag<bool>("-h")), std::invalid_argument);
+    CHECK_THROWS_AS(root.enable_version("1.0"), std::invalid_argument);
+    CHECK_THROWS_AS(root.enable_help({}), std::invalid_argument);
+    CHECK_NOTHROW(root.enable_help({"--help", "-?"}));
+}
@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+
+namespace {
+    auto complete(argon::Cli& cli, const std::initializer_list<std::string_view> words) -> std::vector<std::string> {
+        std::vector<std::string_view> line{"program.exe"};
+        line.insert(line.end(), words.begin(), words.end());
+        return cli.complete(line, line.size() - 1);
+    }
+
+    using Words = std::vector<std::string>;
+}
+
+TEST_CASE("shell completion", "[argon][help][completion]") {
+    CREATE_DEFAULT_ROOT(root);
+    [[maybe_unused]] const auto level = root.add_flag(argon::Flag<int>("--level").with_alias("-l"));
+    [[maybe_unused]] const auto verbose = root.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    [[maybe_unused]] const auto tags = root.add_multi_flag(argon::MultiFlag<std::string>("--tags"));
+    [[maybe_unused]] const auto mode = root.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}));
+    [[maybe_unused]] const auto colors = root.add_multi_choice(
+        argon::MultiChoice<int>("--colors", {{"red", 1}, {"green", 2}, {"grey", 3}}));
+
+    argon::Command<struct Remote> remote{"remote", "Manage remotes"};
+    argon::Command<struct Add> add{"add", "Add a remote"};
+    [[maybe_unused]] const auto url = add.add_flag(argon::Flag<std::string>("--url"));
+    [[maybe_unused]] const auto remote_add = remote.add_subcommand(std::move(add));
+    [[maybe_unused]] const auto remote_rename = remote.add_subcommand(argon::Command<struct Rename>{"rename", ""});
+    [[maybe_unused]] const auto remote_handle = root.add_subcommand(std::move(remote));
+    [[maybe_unused]] const auto run_handle = root.add_subcommand(argon::Command<struct Run>{"run", ""});
+    [[maybe_unused]] const auto reset_handle = root.add_subcommand(argon::Command<struct Reset>{"reset", ""});
+    argon::Cli cli{root};
+
+    SECTION("subcommands") {
+        CHECK(complete(cli, {""}) == Words{"remote", "reset", "run"});
+        CHECK(complete(cli, {"re"}) == Words{"remote", "reset"});
+        CHECK(complete(cli, {"x"}).empty());
+    }
+
+    SECTION("nested subcommands") {
+        CHECK(complete(cli, {"remote", ""}) == Words{"add", "rename"});
+        CHECK(complete(cli, {"remote", "ren"}) == Words{"rename"});
+        CHECK(complete(cli, {"remote", "add", "--"}) == Words{"--url"});
+    }
+
+    SECTION("flags and aliases") {
+        CHECK(complete(cli, {"-"}) == Words{"--colors", "--level", "--mode", "--tags", "--verbose", "-l"});
+        CHECK(complete(cli, {"--l"}) == Words{"--level"});
+        CHECK(complete(cli, {"--level", "2", "--m"}) == Words{"--mode"});
+    }
+
+    SECTION("choice values") {
+        CHECK(complete(cli, {"--mode", ""}) == Words{"fast", "slow"});
+        CHECK(complete(cli, {"--mode", "s"}) == Words{"slow"});
+        CHECK(complete(cli, {"--mode", "fast", ""}).empty());
+        CHECK(complete(cli, {"--colors", "red", "gr"}) == Words{"green", "grey"});
+    }
+
+    SECTION("free-form values are left to the shell") {
+        CHECK(complete(cli, {"--level", ""}).empty());
+        CHECK(complete(cli, {"--tags", "a", ""}).empty());
+        CHECK(complete(cli, {"--verbose", "re"}).empty());
+    }
+
+    SECTION("arguments after -- are not completed") {
+        CHECK(complete(cli, {"--", "-"}).empty());
+        CHECK(complete(cli, {"--", ""}).empty());
+    }
+
+    SECTION("word past the end of the line") {
+        const std::vector<std::string_view> line{"program.exe", "remote"};
+        CHECK(cli.complete(line, 2) == Words{"add", "rename"});
+        CHECK(cli.complete(line, 0).empty());
+    }
+
+    SECTION("completion requests from argv") {
+        CHECK_FALSE(cli.try_complete(2, Argv{"remote"}.argv().data()).has_value());
+
+        const Argv request{"__complete", "2", "program.exe", "remote", "a"};
+        const auto candidates = cli.try_complete(request.argc(), request.argv().data());
+        REQUIRE(candidates.has_value());
+        CHECK(candidates.value() == Words{"add"});
+
+        const Argv invalid{"__complete", "two", "program.exe", "remote"};
+        const auto none = cli.try_complete(invalid.argc(), invalid.argv().data());
+        REQUIRE(none.has_value());
+        CHECK(none->empty());
+    }
+}
+
+TEST_CASE("shell completion builds lazy subcommands", "[argon][help][completion]") {
+    CREATE_DEFAULT_ROOT(root);
+    const auto builds = std::make_shared<int>(0);
+    [[maybe_unused]] const auto deploy_handle = root.add_subcommand_lazy("deploy", "Deploy a release", [=] {
+        ++*builds;
+        argon::Command<struct Deploy> deploy{"deploy", "Deploy a release"};
+        [[maybe_unused]] const auto count = deploy.add_flag(argon::Flag<int>("--count"));
+        return deploy;
+    });
+    argon::Cli cli{root};
+
+    CHECK(complete(cli, {"de"}) == Words{"deploy"});
+    CHECK(*builds == 0);
+    CHECK(complete(cli, {"deploy", "--c"}) == Words{"--count"});
+    CHECK(*builds == 1);
+}
+
+TEST_CASE("shell completion scripts", "[argon][help][completion]") {
+    using Catch::Matchers::ContainsSubstring;
+
+    const auto bash = argon::Cli::get_completion_script(argon::CompletionShell::Bash, "my-tool");
+    CHECK_THAT(bash, ContainsSubstring("complete -o default -F _argon_complete_my_tool my-tool"));
+    CHECK_THAT(bash, ContainsSubstring("__complete \"$COMP_CWORD\" \"${COMP_WORDS[@]}\""));
+
+    const auto zsh = argon::Cli::get_completion_script(argon::CompletionShell::Zsh, "my-tool");
+    CHECK_THAT(zsh, ContainsSubstring("#compdef my-tool"));
+    CHECK_THAT(zsh, ContainsSubstring("compdef _argon_complete_my_tool my-tool"));
+
+    const auto fish = argon::Cli::get_completion_script(argon::CompletionShell::Fish, "my-tool");
+    CHECK_THAT(fish, ContainsSubstring("function _argon_complete_my_tool"));
+    CHECK_THAT(fish, ContainsSubstring("complete -c my-tool -a '(_argon_complete_my_tool)'"));
+}
+
+TEST_CASE("command tree description", "[argon][help][completion]") {
+    CREATE_DEFAULT_ROOT(root);
+    [[maybe_unused]] const auto level = root.add_flag(argon::Flag<int>("--level").with_alias("-l"));
+    [[maybe_unused]] const auto verbose = root.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    [[maybe_unused]] const auto mode = root.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}));
+    [[maybe_unused]] const auto tags = root.add_multi_flag(argon::MultiFlag<std::string>("--tags"));
+    const auto builds = std::make_shared<int>(0);
+    [[maybe_unused]] const auto deploy_handle = root.add_subcommand_lazy("deploy", "Deploy a \"release\"", [=] {
+        ++*builds;
+        argon::Command<struct Deploy> deploy{"deploy", ""};
+        [[maybe_unused]] const auto count = deploy.add_flag(argon::Flag<int>("--count"));
+        return deploy;
+    });
+    argon::Cli cli{root};
+
+    SECTION("options and subcommands") {
+        const argon::CommandInfo info = cli.describe();
+        CHECK(*builds == 1);
+        CHECK(info.name == "cmd");
+        REQUIRE(info.options.size() == 4);
+        CHECK(info.options[0] == argon::OptionInfo{.kind = argon::OptionKind::Flag, .flag = "--level", .aliases = {"-l"}});
+        CHECK(info.options[1].hasImplicit);
+        CHECK(info.options[2].kind == argon::OptionKind::Choice);
+        CHECK(info.options[2].choices == Words{"fast", "slow"});
+        CHECK(info.options[3].takes_multiple_values());
+        REQUIRE(info.subcommands.size() == 1);
+        CHECK(info.subcommands[0].name == "deploy");
+        CHECK(info.subcommands[0].description == "Deploy a \"release\"");
+        CHECK(info.subcommands[0].options[0].flag == "--count");
+    }
+
+    SECTION("JSON lines") {
+        const std::string data = cli.export_completion_data(argon::CompletionDataFormat::JsonLines);
+        CHECK(data ==
+            R"({"command":"","description":"desc","subcommands":["deploy"],"options":[)"
+            R"({"names":["--level","-l"],"kind":"flag","implicit":false,"choices":[]},)"
+            R"({"names":["--verbose"],"kind":"flag","implicit":true,"choices":[]},)"
+            R"({"names":["--mode"],"kind":"choice","implicit":false,"choices":["fast","slow"]},)"
+            R"({"names":["--tags"],"kind":"multi-flag","implicit":false,"choices":[]}]})" "\n"
+            R"({"command":"deploy","description":"Deploy a \"release\"","subcommands":[],"options":[)"
+            R"({"names":["--count"],"kind":"flag","implicit":false,"choices":[]}]})" "\n");
+    }
+
+    SECTION("binary") {
+        const std::string data = cli.export_completion_data(argon::CompletionDataFormat::Binary);
+        const auto info = argon::read_completion_data(data);
+        REQUIRE(info.has_value());
+        CHECK(info.value() == cli.describe());
+
+        const std::vector<std::string_view> line{"program.exe", "--mode", "f"};
+        CHECK(argon::complete_command_line(info.value(), line, 2) == cli.complete(line, 2));
+        const std::vector<std::string_view> nested{"program.exe", "deploy", "-"};
+        CHECK(argon::complete_command_line(info.value(), nested, 2) == Words{"--count"});
+
+        CHECK_FALSE(argon::read_completion_data(std::string_view(data).substr(0, data.size() - 1)).has_value());
+        CHECK_FALSE(argon::read_completion_data("not completion data").has_value());
+    }
+
+    SECTION("completion data script") {
+        using Catch::Matchers::ContainsSubstring;
+        const auto script = argon::Cli::get_completion_data_script("my-tool", "/usr/share/my-tool/it's.jsonl");
+        CHECK_THAT(script, ContainsSubstring(R"(mapfile -t lines < '/usr/share/my-tool/it'\''s.jsonl')"));
+        CHECK_THAT(script, ContainsSubstring("complete -o default -F _argon_complete_my_tool my-tool"));
+    }
+}
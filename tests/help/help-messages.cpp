@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <thread>
+
+#include <unistd.h>
+
+#include <helpers/cli.hpp>
+
+namespace {
+    struct BuildTag {};
+
+    auto make_help_cli() -> std::pair<argon::Cli, argon::CommandHandle<BuildTag>> {
+        argon::Command root{"tool", "A tool with a description that is long enough to be wrapped over more than one "
+            "line of the help message"};
+        std::ignore = root.add_flag(argon::Flag<int>("--threads").with_alias("-t").with_input_hint("count")
+            .with_description("Number of worker threads used while building the project, which defaults to the "
+                "number of processors"));
+        std::ignore = root.add_multi_flag(argon::MultiFlag<std::string>("--define").with_implicit({"x"}));
+        std::ignore = root.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}})
+            .with_description("Build mode"));
+        std::ignore = root.add_multi_choice(argon::MultiChoice<int>("--tags", {{"a", 1}, {"b", 2}}));
+        std::ignore = root.add_positional(argon::Positional<std::string>("input").with_description("Input file"));
+        std::ignore = root.add_multi_positional(argon::MultiPositional<std::string>("rest"));
+
+        argon::Command<BuildTag> build{"build", "Builds the project"};
+        std::ignore = build.add_flag(argon::Flag<bool>("--release"));
+        const auto build_handle = root.add_subcommand(std::move(build));
+        std::ignore = root.add_subcommand(argon::Command<struct CleanTag>{"a-subcommand-with-a-very-long-name",
+            "Removes every file produced by previous builds, including caches"});
+
+        return {argon::Cli{root}, build_handle};
+    }
+}
+
+TEST_CASE("help message layout", "[argon][help][layout]") {
+    const auto cli = make_help_cli().first;
+
+    CHECK(cli.get_help_message(cli.get_root_handle()) ==
+        "Usage:\n"
+        "    tool <command>\n"
+        "    tool [options] <input> <rest>...\n"
+        "\n"
+        "Description:\n"
+        "    A tool with a description that is long enough to be wrapped over more than\n"
+        "    one line of the help message\n"
+        "\n"
+        "Commands:\n"
+        "    build                       Builds the project\n"
+        "    a-subcommand-with-a-very-long-name  \n"
+        "                                Removes every file produced by previous builds,\n"
+        "                                including caches\n"
+        "\n"
+        "Options:\n"
+        "    --threads, -t <count>   Number of worker threads used while building the\n"
+        "                            project, which defaults to the number of processors\n"
+        "    --define [<string>...]  \n"
+        "    --mode <fast|slow>      Build mode\n"
+        "    --tags <a|b>...  \n"
+        "\n"
+        "Positionals:\n"
+        "    <input>                 Input file\n"
+        "    <rest>...  \n");
+}
+
+TEST_CASE("help message cache", "[argon][help][cache]") {
+    auto [cli, build_handle] = make_help_cli();
+
+    SECTION("messages are rendered once per command and width") {
+        const auto first = cli.get_shared_help_message(cli.get_root_handle());
+        const auto second = cli.get_shared_help_message(cli.get_root_handle());
+        CHECK(first == second);
+        CHECK(*first == cli.get_help_message(cli.get_root_handle()));
+
+        const auto build = cli.get_shared_help_message(build_handle);
+        CHECK(build != first);
+        CHECK_THAT(*build, Catch::Matchers::ContainsSubstring("--release"));
+        CHECK(build == cli.get_shared_help_message(build_handle));
+    }
+
+    SECTION("width") {
+        const auto narrow = cli.get_shared_help_message(cli.get_root_handle(), 50);
+        CHECK(narrow != cli.get_shared_help_message(cli.get_root_handle()));
+        CHECK(narrow == cli.get_shared_help_message(cli.get_root_handle(), 50));
+        for (const auto line : *narrow | std::views::split('\n')) {
+            const std::string_view text{line.begin(), line.end()};
+            if (text.contains("a-subcommand-with-a-very-long-name")) continue;
+            CHECK(text.size() <= 50);
+        }
+    }
+
+    SECTION("the program name invalidates root messages") {
+        const auto before = cli.get_shared_help_message(cli.get_root_handle());
+        CHECK_THAT(*before, Catch::Matchers::ContainsSubstring("tool [options]"));
+
+        REQUIRE_RUN_CLI(cli, {"build"});
+        const auto after = cli.get_shared_help_message(cli.get_root_handle());
+        CHECK(before != after);
+        CHECK_THAT(*after, Catch::Matchers::ContainsSubstring("program.exe [options]"));
+        CHECK_THAT(*before, Catch::Matchers::ContainsSubstring("tool [options]"));
+
+        REQUIRE_RUN_CLI(cli, {"build"});
+        CHECK(after == cli.get_shared_help_message(cli.get_root_handle()));
+    }
+
+    SECTION("threads share one message") {
+        std::vector<std::shared_ptr<const std::string>> messages(8);
+        std::vector<std::thread> threads;
+        for (auto& message : messages) {
+            threads.emplace_back([&cli, &message] {
+                message = cli.get_shared_help_message(cli.get_root_handle());
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        for (const auto& message : messages) {
+            CHECK(message == messages.front());
+        }
+    }
+}
+
+TEST_CASE("help message output", "[argon][help][output]") {
+    auto [cli, build_handle] = make_help_cli();
+    const std::string expected = cli.get_help_message(cli.get_root_handle());
+
+    SECTION("output iterator") {
+        std::string message = "> ";
+        cli.format_help_message_to(std::back_inserter(message), cli.get_root_handle());
+        CHECK(message == "> " + expected);
+
+        std::vector<char> chars;
+        cli.format_help_message_to(std::back_inserter(chars), build_handle, 50);
+        CHECK(std::string(chars.begin(), chars.end()) == cli.get_help_message(build_handle, 50));
+    }
+
+    SECTION("fixed buffer") {
+        std::array<char, 4096> large{};
+        const size_t size = cli.write_help_message(large, cli.get_root_handle());
+        REQUIRE(size == expected.size());
+        CHECK(std::string_view(large.data(), size) == expected);
+
+        std::array<char, 16> small{};
+        CHECK(cli.write_help_message(small, cli.get_root_handle()) == expected.size());
+        CHECK(std::string_view(small.data(), small.size()) == std::string_view(expected).substr(0, small.size()));
+    }
+
+    SECTION("file descriptor") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        const auto written = cli.write_help_message(fds[1], cli.get_root_handle());
+        close(fds[1]);
+        REQUIRE(written.has_value());
+
+        std::string message;
+        std::array<char, 256> chunk{};
+        ssize_t count = 0;
+        while ((count = read(fds[0], chunk.data(), chunk.size())) > 0) {
+            message.append(chunk.data(), static_cast<size_t>(count));
+        }
+        close(fds[0]);
+        CHECK(message == expected);
+
+        const auto failed = cli.write_help_message(-1, cli.get_root_handle());
+        REQUIRE_FALSE(failed.has_value());
+        CHECK_THAT(failed.error(), Catch::Matchers::ContainsSubstring("Unable to write help message"));
+    }
+}
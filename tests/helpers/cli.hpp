@@ -48,7 +48,7 @@ inline void REQUIRE_RUN_CLI(argon::Cli& cli, const Argv& args) {
     const auto run = cli.run(args.argc(), args.argv().data());
     if (!run.has_value()) {
         for (const auto& msg : run.error().messages) {
-            std::cout << msg << std::endl;
+            std::cout << msg.message() << std::endl;
         }
     }
     REQUIRE(run.has_value());
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+// Sets an environment variable for the lifetime of the object
+struct ScopedEnv {
+    std::string name;
+
+    ScopedEnv(const std::string_view name_, const std::string_view value) : name(name_) {
+#ifdef _WIN32
+        _putenv_s(name.c_str(), std::string(value).c_str());
+#else
+        setenv(name.c_str(), std::string(value).c_str(), 1);
+#endif
+    }
+
+    ScopedEnv(const ScopedEnv&) = delete;
+    auto operator=(const ScopedEnv&) -> ScopedEnv& = delete;
+
+    ~ScopedEnv() {
+#ifdef _WIN32
+        _putenv_s(name.c_str(), "");
+#else
+        unsetenv(name.c_str());
+#endif
+    }
+};
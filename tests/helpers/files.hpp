@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string_view>
+
+struct TempDir {
+    std::filesystem::path path;
+
+    TempDir() {
+        static std::atomic<int> counter{0};
+        path = std::filesystem::temp_directory_path() / std::format("argon-tests-{}-{}",
+            std::chrono::steady_clock::now().time_since_epoch().count(), counter.fetch_add(1));
+        std::filesystem::create_directories(path);
+    }
+
+    TempDir(const TempDir&) = delete;
+    auto operator=(const TempDir&) -> TempDir& = delete;
+
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    auto write(const std::string_view name, const std::string_view contents) const -> std::filesystem::path {
+        const auto file = path / name;
+        std::ofstream stream(file, std::ios::binary);
+        stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        return file;
+    }
+};
@@ -0,0 +1,33 @@
+#include <argon/argon.hpp>
+
+#include <optional>
+#include <string>
+
+namespace {
+    struct Greet {};
+
+    int builds = 0;
+    std::optional<argon::CommandHandle<Greet>> command;
+    std::optional<argon::FlagHandle<Greet, std::string>> name;
+    std::optional<argon::FlagHandle<Greet, int>> times;
+}
+
+ARGON_PLUGIN(builder) {
+    ++builds;
+    argon::Command<Greet> greet{"greet", "Prints a greeting"};
+    name = greet.add_flag(argon::Flag<std::string>("--name").with_default("world").with_description("Who to greet"));
+    times = greet.add_flag(argon::Flag<int>("--times").with_default(1));
+    command = builder.set_command(std::move(greet));
+}
+
+extern "C" auto argon_test_greet_builds() -> int {
+    return builds;
+}
+
+extern "C" auto argon_test_greet_results(const argon::Cli& cli, std::string& nameResult, int& timesResult) -> bool {
+    const auto results = cli.try_get_results(command.value());
+    if (!results.has_value()) return false;
+    nameResult = results->get(name.value()).value_or("");
+    timesResult = results->get(times.value()).value_or(0);
+    return true;
+}
@@ -0,0 +1,33 @@
+#include <argon/argon.hpp>
+
+#include <optional>
+#include <string>
+
+namespace {
+    struct Remote {};
+    struct Add {};
+
+    int builds = 0;
+    std::optional<argon::CommandHandle<Add>> add;
+    std::optional<argon::FlagHandle<Add, std::string>> url;
+}
+
+ARGON_PLUGIN(builder) {
+    ++builds;
+    argon::Command<Remote> remote{"remote", "Manages remotes"};
+    argon::Command<Add> addCmd{"add", "Adds a remote"};
+    url = addCmd.add_flag(argon::Flag<std::string>("--url"));
+    add = remote.add_subcommand(std::move(addCmd));
+    [[maybe_unused]] const auto handle = builder.set_command(std::move(remote));
+}
+
+extern "C" auto argon_test_remote_builds() -> int {
+    return builds;
+}
+
+extern "C" auto argon_test_remote_add_url(const argon::Cli& cli, std::string& urlResult) -> bool {
+    const auto results = cli.try_get_results(add.value());
+    if (!results.has_value()) return false;
+    urlResult = results->get(url.value()).value_or("");
+    return true;
+}
@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <sstream>
+
+#include <helpers/cli.hpp>
+
+TEST_CASE("command line splitting", "[argon][sources][command-lines]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto env_handle = cmd.add_flag(argon::Flag<std::string_view>("--env"));
+    const auto args_handle = cmd.add_multi_positional(argon::MultiPositional<std::string_view>("args"));
+    argon::Cli cli{cmd};
+
+    const auto check_split = [&](const std::string_view line, const std::vector<std::string_view>& expected) {
+        INFO(line);
+        const auto run = cli.run_line(line);
+        REQUIRE(run.has_value());
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.get(args_handle) == expected);
+    };
+
+    SECTION("whitespace") {
+        check_split("  a\tb \r\n c  ", {"a", "b", "c"});
+        check_split("", {});
+        check_split("   # a comment", {});
+        check_split("a#b # comment", {"a#b"});
+    }
+
+    SECTION("quotes") {
+        check_split(R"('single "quoted"' "double 'quoted'" "" '')", {R"(single "quoted")", "double 'quoted'", "", ""});
+        check_split(R"(pre"fix"'es' 'a\b')", {"prefixes", R"(a\b)"});
+        check_split(R"("a\"b\\c\$d\e")", {R"(a"b\c$d\e)"});
+    }
+
+    SECTION("escapes") {
+        check_split(R"(a\ b \'c\" d\\)", {"a b", R"('c")", R"(d\)"});
+        check_split("a\\\nb c \\\n d", {"ab", "c", "d"});
+        check_split("\"a\\\nb\"", {"ab"});
+    }
+
+    SECTION("long words cross SIMD blocks") {
+        const std::string longWord(100, 'x');
+        const std::string line = std::format("{} \"{} {}\"", longWord, longWord, longWord);
+        check_split(line, {longWord, longWord + " " + longWord});
+    }
+
+    SECTION("words are views into the line unless unescaped") {
+        const std::string line = R"(--env "prod eu" plain 'quoted' un\ escaped)";
+        REQUIRE(cli.run_line(line).has_value());
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        const auto in_line = [&](const std::string_view word) {
+            return word.data() >= line.data() && word.data() + word.size() <= line.data() + line.size();
+        };
+        CHECK(results.get(env_handle) == "prod eu");
+        CHECK(in_line(results.get(env_handle).value()));
+
+        const auto args = results.get(args_handle);
+        REQUIRE(args == std::vector<std::string_view>{"plain", "quoted", "un escaped"});
+        CHECK(in_line(args[0]));
+        CHECK(in_line(args[1]));
+        CHECK_FALSE(in_line(args[2]));
+    }
+
+    SECTION("errors") {
+        for (const auto& [line, message] : std::vector<std::pair<std::string_view, std::string_view>>{
+            {"'open", "Unterminated single quote"},
+            {"\"open", "Unterminated double quote"},
+            {"a\\", "Unexpected end of line after '\\'"},
+        }) {
+            INFO(line);
+            const auto run = cli.run_line(line);
+            REQUIRE_FALSE(run.has_value());
+            REQUIRE(run.error().messages.size() == 1);
+            CHECK(run.error().messages[0].message() == message);
+            CHECK_FALSE(cli.try_get_results(cli.get_root_handle()).has_value());
+        }
+    }
+}
+
+TEST_CASE("repeated runs start from a clean state", "[argon][sources][command-lines]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto count_handle = cmd.add_flag(argon::Flag<int>("--count").with_default(1));
+    const auto tags_handle = cmd.add_multi_flag(argon::MultiFlag<std::string>("--tags"));
+    argon::Cli cli{cmd};
+
+    REQUIRE(cli.run_line("--count 5 --tags a --tags b").has_value());
+    REQUIRE(cli.run_line("--tags c").has_value());
+    const auto results = REQUIRE_ROOT_CMD(cli);
+    CHECK_SINGLE_RESULT(results, count_handle, 1);
+    CHECK_FALSE(results.is_specified(count_handle));
+    CHECK_MULTI_RESULT(results, tags_handle, std::vector<std::string>{"c"});
+}
+
+TEST_CASE("REPL dispatch", "[argon][sources][command-lines]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    argon::Command<struct Deploy> deploy{"deploy", ""};
+    const auto env_handle = deploy.add_flag(argon::Flag<std::string>("--env"));
+    const auto dry_run_handle = deploy.add_flag(argon::Flag<bool>("--dry-run").with_implicit(true));
+    const auto deploy_handle = cmd.add_subcommand(std::move(deploy));
+    argon::Cli cli{cmd};
+
+    std::istringstream input(
+        "deploy --env \"prod eu\" --dry-run\n"
+        "\n"
+        "# comment\n"
+        "deploy --env 'multi\n"
+        "line' \\\n"
+        "  --dry-run\n"
+        "deploy --unknown\n"
+        "deploy --env last\n"
+        "deploy --env unreached\n");
+
+    std::vector<std::string> envs;
+    std::vector<std::string> errors;
+    cli.run_repl(input, [&](const std::expected<void, argon::CliRunError>& result) {
+        if (!result.has_value()) {
+            errors.insert(errors.end(), result.error().messages.begin(), result.error().messages.end());
+            return true;
+        }
+        const auto results = REQUIRE_COMMAND(cli, deploy_handle);
+        CHECK(results.get(dry_run_handle).value_or(false) == (envs.size() < 2));
+        envs.push_back(results.get(env_handle).value());
+        return envs.size() < 3;
+    });
+
+    CHECK(envs == std::vector<std::string>{"prod eu", "multi\nline", "last"});
+    REQUIRE(errors.size() == 1);
+    CHECK_THAT(errors[0], Catch::Matchers::ContainsSubstring("--unknown"));
+}
+
+TEST_CASE("REPL reports unterminated input at the end", "[argon][sources][command-lines]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    argon::Cli cli{cmd};
+
+    std::istringstream input("'never closed\nstill open");
+    std::vector<std::string> errors;
+    cli.run_repl(input, [&](const std::expected<void, argon::CliRunError>& result) {
+        REQUIRE_FALSE(result.has_value());
+        errors.push_back(result.error().messages.at(0));
+        return true;
+    });
+    CHECK(errors == std::vector<std::string>{"Unterminated single quote"});
+}
+
+TEST_CASE("REPL reads from a line source", "[argon][sources][command-lines]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto name_handle = cmd.add_flag(argon::Flag<std::string>("--name"));
+    argon::Cli cli{cmd};
+
+    const std::vector<std::string> lines{"--name 'first", "line'", "", "--name second"};
+    size_t next = 0;
+    std::vector<std::string> names;
+    cli.run_repl([&](std::string& line) {
+        if (next == lines.size()) return false;
+        line = lines[next++];
+        return true;
+    }, [&](const std::expected<void, argon::CliRunError>& result) {
+        REQUIRE(result.has_value());
+        names.push_back(REQUIRE_ROOT_CMD(cli).get(name_handle).value());
+        return true;
+    });
+    CHECK(names == std::vector<std::string>{"first\nline", "second"});
+}
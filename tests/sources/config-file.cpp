@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+#include <helpers/files.hpp>
+
+TEST_CASE("config file values", "[argon][sources][config-file]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto threads_handle = cmd.add_flag(argon::Flag<int>("--threads").with_default(1));
+    const auto name_handle = cmd.add_flag(argon::Flag<std::string>("--name").with_alias("-n"));
+    const auto verbose_handle = cmd.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    const auto tags_handle = cmd.add_multi_flag(argon::MultiFlag<std::string>("--tags"));
+    const auto mode_handle = cmd.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}));
+    const auto level_handle = cmd.add_flag(argon::Flag<int>("--level").with_default(3));
+    argon::Cli cli{cmd};
+
+    const auto path = dir.write("app.ini",
+        "# comment\n"
+        "; another comment\n"
+        "threads = 8\n"
+        "n = \"from file\"\n"
+        "verbose =\n"
+        "tags = a\n"
+        "tags = b\n"
+        "--mode = slow\n"
+        "\n"
+        "[sub]\n"
+        "threads = 100\n");
+    cli.enable_config_file(path);
+
+    SECTION("file fills options not given on the command line") {
+        const Argv argv{};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, threads_handle, 8);
+        CHECK_SINGLE_RESULT(results, name_handle, std::string("from file"));
+        CHECK_SINGLE_RESULT(results, verbose_handle, true);
+        CHECK_MULTI_RESULT(results, tags_handle, std::vector<std::string>{"a", "b"});
+        CHECK_SINGLE_RESULT(results, mode_handle, 2);
+        CHECK(results.is_specified(threads_handle));
+
+        CHECK(results.get_source(threads_handle) == argon::ValueSource::ConfigFile);
+        CHECK(results.get_source(tags_handle) == argon::ValueSource::ConfigFile);
+        CHECK(results.get_source(level_handle) == argon::ValueSource::Default);
+    }
+
+    SECTION("command line takes precedence") {
+        const Argv argv{"--threads", "2", "--tags", "c"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, threads_handle, 2);
+        CHECK_MULTI_RESULT(results, tags_handle, std::vector<std::string>{"c"});
+        CHECK_SINGLE_RESULT(results, name_handle, std::string("from file"));
+        CHECK(results.get_source(threads_handle) == argon::ValueSource::CommandLine);
+        CHECK(results.get_source(name_handle) == argon::ValueSource::ConfigFile);
+    }
+}
+
+TEST_CASE("config file sections", "[argon][sources][config-file]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto root_handle = cmd.add_flag(argon::Flag<int>("--x"));
+    argon::Command<struct Remote> remote{"remote", ""};
+    argon::Command<struct Add> add{"add", ""};
+    const auto add_handle = add.add_flag(argon::Flag<std::string>("--url"));
+    const auto remote_add = remote.add_subcommand(std::move(add));
+    [[maybe_unused]] const auto remote_handle = cmd.add_subcommand(std::move(remote));
+    argon::Cli cli{cmd};
+
+    cli.enable_config_file(dir.write("app.ini",
+        "x = 1\n"
+        "[remote.add]\n"
+        "url = https://example.com\n"));
+
+    SECTION("root") {
+        const Argv argv{};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, root_handle, 1);
+    }
+
+    SECTION("nested subcommand") {
+        const Argv argv{"remote", "add"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_COMMAND(cli, remote_add);
+        CHECK_SINGLE_RESULT(results, add_handle, std::string("https://example.com"));
+        CHECK(results.get_source(add_handle) == argon::ValueSource::ConfigFile);
+    }
+}
+
+TEST_CASE("config file errors", "[argon][sources][config-file]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    [[maybe_unused]] const auto handle = cmd.add_flag(argon::Flag<int>("--threads"));
+    argon::Cli cli{cmd};
+    const Argv argv{};
+
+    SECTION("unknown option") {
+        cli.enable_config_file(dir.write("app.ini", "\nunknown = 1\n"));
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unknown option 'unknown'"));
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("line 2"));
+    }
+
+    SECTION("invalid value") {
+        cli.enable_config_file(dir.write("app.ini", "threads = many\n"));
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Invalid value 'many' for flag '--threads'"));
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("line 1"));
+    }
+
+    SECTION("malformed line") {
+        cli.enable_config_file(dir.write("app.ini", "threads\n"));
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Expected 'key = value'"));
+    }
+
+    SECTION("missing required file") {
+        cli.enable_config_file(dir.path / "missing.ini", argon::ConfigFilePresence::Required);
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unable to read config file"));
+    }
+}
+
+TEST_CASE("optional config file", "[argon][sources][config-file]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto threads_handle = cmd.add_flag(argon::Flag<int>("--threads").with_default(1));
+    argon::Cli cli{cmd};
+    const auto path = dir.path / "app.ini";
+    cli.enable_config_file(path);
+
+    REQUIRE_RUN_CLI(cli, Argv{"--threads", "2"});
+    CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(cli), threads_handle, 2);
+    REQUIRE_RUN_CLI(cli, Argv{});
+    CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(cli), threads_handle, 1);
+    CHECK(REQUIRE_ROOT_CMD(cli).get_source(threads_handle) == argon::ValueSource::Default);
+
+    std::ignore = dir.write("app.ini", "threads = 8\n");
+    REQUIRE_RUN_CLI(cli, Argv{});
+    CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(cli), threads_handle, 8);
+
+    std::filesystem::remove(path);
+    REQUIRE_RUN_CLI(cli, Argv{});
+    CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(cli), threads_handle, 1);
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <unistd.h>
+
+#include <helpers/cli.hpp>
+
+// Read end of a pipe that has already been given its contents
+struct Pipe {
+    int fd = -1;
+
+    explicit Pipe(const std::string_view contents) {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        REQUIRE(write(fds[1], contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()));
+        close(fds[1]);
+        fd = fds[0];
+    }
+
+    Pipe(const Pipe&) = delete;
+    auto operator=(const Pipe&) -> Pipe& = delete;
+
+    ~Pipe() {
+        close(fd);
+    }
+};
+
+TEST_CASE("descriptor source", "[argon][sources][descriptor]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto count_handle = cmd.add_flag(argon::Flag<int>("--count"));
+    const auto files_handle = cmd.add_multi_positional(argon::MultiPositional<std::string>("files"));
+    argon::Cli cli{cmd};
+
+    SECTION("NUL separated arguments follow the command line") {
+        const Pipe pipe{std::string_view("b.txt\0--count\0\0with\nnewline\0", 28)};
+        cli.enable_descriptor_source({.fd = pipe.fd, .bufferSize = 4});
+        const Argv argv{"--count", "2", "--from-stdin0", "a.txt"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, count_handle, 2);
+        CHECK_MULTI_RESULT(results, files_handle,
+            std::vector<std::string>{"a.txt", "b.txt", "--count", "with\nnewline"});
+    }
+
+    SECTION("newline separated") {
+        const Pipe pipe{"a.txt\r\n\nb.txt"};
+        cli.enable_descriptor_source({.fd = pipe.fd, .format = argon::ResponseFileFormat::Newline, .option = "-"});
+        const Argv argv{"-"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, files_handle, std::vector<std::string>{"a.txt", "b.txt"});
+    }
+
+    SECTION("unreadable descriptor") {
+        cli.enable_descriptor_source({.fd = -1});
+        const Argv argv{"--from-stdin0"};
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unable to read arguments from file descriptor -1"));
+    }
+
+    SECTION("the descriptor is only read when asked for") {
+        // An unreadable descriptor would fail the run if it were read
+        cli.enable_descriptor_source({.fd = -1});
+        REQUIRE_RUN_CLI(cli, Argv{"--count", "1", "a.txt"});
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, files_handle, std::vector<std::string>{"a.txt"});
+
+        REQUIRE_RUN_CLI(cli, Argv{"--", "--from-stdin0"});
+        CHECK_MULTI_RESULT(REQUIRE_ROOT_CMD(cli), files_handle, std::vector<std::string>{"--from-stdin0"});
+    }
+
+    SECTION("positions after the option are kept") {
+        const Pipe pipe{""};
+        cli.enable_descriptor_source({.fd = pipe.fd});
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, {"--from-stdin0", "--count", "x"});
+        REQUIRE(messages.size() == 1);
+        CHECK(messages[0].position() == 3);
+    }
+
+    SECTION("the option must not be empty") {
+        CHECK_THROWS_AS(cli.enable_descriptor_source({.option = ""}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("descriptor source with a streamed multi-positional", "[argon][sources][descriptor]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto ints_handle = cmd.add_multi_positional(
+        argon::MultiPositional<int>("ints")
+            .with_value_validator([](const int x) { return x < 100; }, "must be less than 100")
+            .with_default({7})
+            .with_streaming()
+    );
+    argon::Cli cli{cmd};
+
+    SECTION("values are read while iterating") {
+        const Pipe pipe{std::string_view("2\0""300\0""4\0", 8)};
+        cli.enable_descriptor_source({.fd = pipe.fd, .bufferSize = 2});
+        const Argv argv{"1", "--from-stdin0"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.is_specified(ints_handle));
+
+        const auto values = results.stream(ints_handle) | std::ranges::to<std::vector>();
+        REQUIRE(values.size() == 4);
+        CHECK(values[0] == 1);
+        CHECK(values[1] == 2);
+        REQUIRE_FALSE(values[2].has_value());
+        CHECK_THAT(values[2].error(), Catch::Matchers::ContainsSubstring("must be less than 100"));
+        CHECK(values[3] == 4);
+    }
+
+    SECTION("empty descriptor uses the default") {
+        const Pipe pipe{""};
+        cli.enable_descriptor_source({.fd = pipe.fd});
+        const Argv argv{"--from-stdin0"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_FALSE(results.is_specified(ints_handle));
+        const auto values = results.stream(ints_handle) | std::ranges::to<std::vector>();
+        REQUIRE(values.size() == 1);
+        CHECK(values[0] == 7);
+    }
+
+    SECTION("checking whether the option is set does not read") {
+        const Pipe pipe{std::string_view("2\0""3\0", 4)};
+        cli.enable_descriptor_source({.fd = pipe.fd});
+        REQUIRE_RUN_CLI(cli, Argv{"--from-stdin0"});
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        const auto values = results.stream(ints_handle) | std::ranges::to<std::vector>();
+        REQUIRE(values.size() == 2);
+        // Reading again would find the end of the pipe, so the option would no longer look set
+        CHECK(results.is_specified(ints_handle));
+    }
+}
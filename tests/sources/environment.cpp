@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <helpers/cli.hpp>
+#include <helpers/env.hpp>
+#include <helpers/files.hpp>
+
+TEST_CASE("environment variables", "[argon][sources][environment]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto threads_handle = cmd.add_flag(
+        argon::Flag<int>("--threads")
+            .with_env("ARGON_TEST_THREADS")
+            .with_value_validator([](const int x) { return x > 0; }, "must be positive")
+    );
+    const auto tags_handle = cmd.add_multi_flag(argon::MultiFlag<std::string>("--tags").with_env("ARGON_TEST_TAGS"));
+    const auto mode_handle = cmd.add_choice(
+        argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}).with_env("ARGON_TEST_MODE"));
+    const auto unset_handle = cmd.add_flag(argon::Flag<int>("--unset").with_env("ARGON_TEST_UNSET"));
+    argon::Cli cli{cmd};
+
+    const ScopedEnv threads{"ARGON_TEST_THREADS", "4"};
+    const ScopedEnv tags{"ARGON_TEST_TAGS", "a, b,c"};
+    const ScopedEnv mode{"ARGON_TEST_MODE", "slow"};
+
+    SECTION("values are read from the environment") {
+        const Argv argv{};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, threads_handle, 4);
+        CHECK_MULTI_RESULT(results, tags_handle, std::vector<std::string>{"a", "b", "c"});
+        CHECK_SINGLE_RESULT(results, mode_handle, 2);
+        CHECK(results.get_source(threads_handle) == argon::ValueSource::Environment);
+        CHECK(results.get_source(unset_handle) == argon::ValueSource::None);
+        CHECK_FALSE(results.is_specified(unset_handle));
+    }
+
+    SECTION("command line takes precedence") {
+        const Argv argv{"--threads", "16"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, threads_handle, 16);
+        CHECK(results.get_source(threads_handle) == argon::ValueSource::CommandLine);
+    }
+
+    SECTION("environment takes precedence over the config file") {
+        const TempDir dir;
+        cli.enable_config_file(dir.write("app.ini", "threads = 2\nunset = 3\n"));
+        const Argv argv{};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, threads_handle, 4);
+        CHECK_SINGLE_RESULT(results, unset_handle, 3);
+        CHECK(results.get_source(threads_handle) == argon::ValueSource::Environment);
+        CHECK(results.get_source(unset_handle) == argon::ValueSource::ConfigFile);
+    }
+
+    SECTION("environment values take part in constraints") {
+        cmd.constraints.require(argon::present(threads_handle), "--threads is required");
+        argon::Cli constrained{cmd};
+        const Argv argv{};
+        REQUIRE_RUN_CLI(constrained, argv);
+    }
+}
+
+TEST_CASE("environment variable errors", "[argon][sources][environment]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    [[maybe_unused]] const auto handle = cmd.add_flag(
+        argon::Flag<int>("--threads")
+            .with_env("ARGON_TEST_THREADS")
+            .with_value_validator([](const int x) { return x > 0; }, "must be positive")
+    );
+    argon::Cli cli{cmd};
+
+    const ScopedEnv threads{"ARGON_TEST_THREADS", "-1"};
+    const Argv argv{};
+    const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+    REQUIRE(messages.size() == 1);
+    CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("must be positive"));
+    CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("environment variable 'ARGON_TEST_THREADS'"));
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <helpers/cli.hpp>
+
+namespace {
+    auto counted_int(const std::shared_ptr<int>& conversions) {
+        return [conversions](const std::string_view arg) -> std::optional<int> {
+            ++*conversions;
+            if (arg.empty() || !std::ranges::all_of(arg, [](const char c) { return std::isdigit(c); })) {
+                return std::nullopt;
+            }
+            return std::stoi(std::string(arg));
+        };
+    }
+}
+
+TEST_CASE("parse sessions", "[argon][sources][parse-session]") {
+    CREATE_DEFAULT_ROOT(root);
+    const auto conversions = std::make_shared<int>(0);
+    const auto count = root.add_flag(argon::Flag<int>("--count")
+        .with_conversion_fn(counted_int(conversions), "expected digits"));
+    const auto ints = root.add_multi_flag(argon::MultiFlag<int>("--ints")
+        .with_conversion_fn(counted_int(conversions), "expected digits"));
+    const auto name = root.add_flag(argon::Flag<std::string_view>("--name"));
+    const auto mode = root.add_choice(argon::Choice<int>("--mode", {{"fast", 1}, {"slow", 2}}));
+    const auto first = root.add_positional(argon::Positional<std::string>("first"));
+    root.constraints.require(argon::absent(name) | argon::present(count), "--name needs --count");
+    root.constraints.require(argon::condition<argon::RootCommandTag>([count](const argon::Results<>& results) {
+        return results.get(count).value_or(1) > 0;
+    }), "--count must be positive");
+
+    argon::Command<struct Deploy> deploy{"deploy", "Deploy a release"};
+    const auto replicas = deploy.add_flag(argon::Flag<int>("--replicas"));
+    const auto deploy_handle = root.add_subcommand(std::move(deploy));
+    argon::Cli cli{root};
+    argon::ParseSession session{cli};
+
+    SECTION("unchanged options are not converted again") {
+        REQUIRE(session.update_line("--count 1 --ints 2 3 --name a").has_value());
+        CHECK(*conversions == 3);
+
+        REQUIRE(session.update_line("--count 1 --ints 2 3 --name ab").has_value());
+        CHECK(*conversions == 3);
+        const auto results = REQUIRE_ROOT_CMD(session.get_cli());
+        CHECK_SINGLE_RESULT(results, count, 1);
+        CHECK(results.get(ints) == std::vector{2, 3});
+        CHECK_SINGLE_RESULT(results, name, std::string_view("ab"));
+        CHECK(results.get_source(count) == argon::ValueSource::CommandLine);
+
+        REQUIRE(session.update_line("--count 1 --ints 2 3 4 --name ab").has_value());
+        CHECK(*conversions == 6);
+        CHECK(REQUIRE_ROOT_CMD(session.get_cli()).get(ints) == std::vector{2, 3, 4});
+    }
+
+    SECTION("removed options are unset") {
+        REQUIRE(session.update_line("--count 1 first").has_value());
+        REQUIRE(session.update_line("--count 1").has_value());
+        const auto results = REQUIRE_ROOT_CMD(session.get_cli());
+        CHECK_SINGLE_RESULT(results, count, 1);
+        CHECK_FALSE(results.get(first).has_value());
+    }
+
+    SECTION("the same words return the last outcome") {
+        REQUIRE_FALSE(session.update_line("--count x").has_value());
+        const auto conversionsBefore = *conversions;
+        const auto& outcome = session.update_line("--count  x");
+        REQUIRE_FALSE(outcome.has_value());
+        CHECK(outcome.error().messages.size() == 1);
+        CHECK(*conversions == conversionsBefore);
+    }
+
+    SECTION("errors match a full parse") {
+        const std::vector<std::string_view> lines{
+            "--count", "--count x", "--count x --ints 1 y", "--ints 1 y --count x", "--ints 1 y --count x --mode",
+            "--ints 1 y --count x --mode medium a b", "--ints 1 y --cuont x --ints z", "--name a", "--name a --count 0",
+            "--name a --count 0 --count 2", "--mode fast first --name a --count 2", "deploy --replicas x",
+            "deploy --replicas 1", "--count 2 --ints 3", "--count 2 --ints 3 --ints 4 five --ints six",
+        };
+        for (const auto line : lines) {
+            INFO(line);
+            const auto expected = cli.run_line(line);
+            const auto& actual = session.update_line(line);
+            REQUIRE(actual.has_value() == expected.has_value());
+            if (expected.has_value()) continue;
+            CHECK(actual.error().handle.get_id() == expected.error().handle.get_id());
+            REQUIRE(actual.error().messages.size() == expected.error().messages.size());
+            for (size_t i = 0; i < expected.error().messages.size(); ++i) {
+                CHECK(actual.error().messages[i].message() == expected.error().messages[i].message());
+                CHECK(actual.error().messages[i].position() == expected.error().messages[i].position());
+            }
+        }
+    }
+
+    SECTION("errors of unchanged options follow their words") {
+        REQUIRE_FALSE(session.update_line("--count x").has_value());
+        const auto& outcome = session.update_line("--name a --count x");
+        REQUIRE_FALSE(outcome.has_value());
+        REQUIRE(outcome.error().messages.size() == 1);
+        CHECK(outcome.error().messages[0].position() == 3);
+    }
+
+    SECTION("constraints that read values are evaluated again") {
+        const auto& invalid = session.update_line("--count 0");
+        REQUIRE_FALSE(invalid.has_value());
+        REQUIRE(invalid.error().messages.size() == 1);
+        CHECK(invalid.error().messages[0].message() == "--count must be positive");
+        CHECK(session.update_line("--count 3").has_value());
+
+        REQUIRE_FALSE(session.update_line("--count 3 --name a --count 0").has_value());
+        CHECK(session.update_line("--count 3 --name a").has_value());
+        REQUIRE_FALSE(session.update_line("--name a").has_value());
+    }
+
+    SECTION("subcommands") {
+        REQUIRE(session.update_line("--count 1").has_value());
+        REQUIRE(session.update_line("deploy --replicas 2").has_value());
+        const auto deploy_results = session.get_cli().try_get_results(deploy_handle);
+        REQUIRE(deploy_results.has_value());
+        CHECK_SINGLE_RESULT(deploy_results.value(), replicas, 2);
+
+        REQUIRE(session.update_line("--name a --count 1").has_value());
+        CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(session.get_cli()), count, 1);
+        CHECK_FALSE(session.get_cli().try_get_results(deploy_handle).has_value());
+    }
+
+    SECTION("split errors") {
+        REQUIRE(session.update_line("--count 1").has_value());
+        const auto& outcome = session.update_line("--name 'a");
+        REQUIRE_FALSE(outcome.has_value());
+        CHECK(outcome.error().messages[0].code() == argon::ErrorCode::Source);
+        CHECK_FALSE(session.get_cli().try_get_results(session.get_cli().get_root_handle()).has_value());
+        CHECK(session.update_line("--count 1").has_value());
+    }
+
+    SECTION("words") {
+        const std::vector<std::string_view> words{"--count", "4", "--mode", "slow"};
+        REQUIRE(session.update(words).has_value());
+        const auto results = REQUIRE_ROOT_CMD(session.get_cli());
+        CHECK_SINGLE_RESULT(results, count, 4);
+        CHECK_SINGLE_RESULT(results, mode, 2);
+    }
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <fstream>
+
+#include <helpers/cli.hpp>
+
+using namespace std::string_view_literals;
+
+TEST_CASE("command lines in the cmdline format", "[argon][sources][process-cmdline]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto verbose_handle = cmd.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    const auto args_handle = cmd.add_multi_positional(argon::MultiPositional<std::string>("args"));
+    argon::Cli cli{cmd};
+
+    SECTION("all arguments after the program name") {
+        REQUIRE(cli.run_cmdline("/usr/bin/host\0a\0\0b c\0--verbose\0"sv).has_value());
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.get(args_handle) == std::vector<std::string>{"a", "", "b c"});
+        CHECK_SINGLE_RESULT(results, verbose_handle, true);
+        CHECK_THAT(cli.get_help_message(cli.get_root_handle()), Catch::Matchers::ContainsSubstring("host"));
+    }
+
+    SECTION("no trailing NUL") {
+        REQUIRE(cli.run_cmdline("host\0a"sv).has_value());
+        CHECK(REQUIRE_ROOT_CMD(cli).get(args_handle) == std::vector<std::string>{"a"});
+    }
+
+    SECTION("arguments after the marker") {
+        REQUIRE(cli.run_cmdline("host\0--host-flag\0--\0x\0--verbose\0"sv, "--").has_value());
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.get(args_handle) == std::vector<std::string>{"x"});
+        CHECK_SINGLE_RESULT(results, verbose_handle, true);
+    }
+
+    SECTION("missing marker") {
+        REQUIRE(cli.run_cmdline("host\0--host-flag\0"sv, "--argon").has_value());
+        CHECK_FALSE(REQUIRE_ROOT_CMD(cli).is_specified(args_handle));
+    }
+
+    SECTION("empty") {
+        const auto run = cli.run_cmdline(""sv);
+        REQUIRE_FALSE(run.has_value());
+        REQUIRE(run.error().messages.size() == 1);
+        CHECK(run.error().messages[0].code() == argon::ErrorCode::Source);
+    }
+}
+
+#if defined(__linux__)
+namespace {
+    auto read_own_program_name() -> std::string {
+        std::ifstream stream("/proc/self/cmdline", std::ios::binary);
+        std::string name;
+        std::getline(stream, name, '\0');
+        return std::filesystem::path(name).filename().string();
+    }
+}
+
+TEST_CASE("process command line", "[argon][sources][process-cmdline]") {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto args_handle = cmd.add_multi_positional(argon::MultiPositional<std::string>("args"));
+    argon::Cli cli{cmd};
+
+    // A marker that is never given skips the test runner's own arguments, which would be unknown to the CLI
+    REQUIRE(cli.run_process_cmdline("--argon-options-that-are-never-given").has_value());
+    CHECK_FALSE(REQUIRE_ROOT_CMD(cli).is_specified(args_handle));
+    CHECK_THAT(cli.get_help_message(cli.get_root_handle()), Catch::Matchers::ContainsSubstring(read_own_program_name()));
+}
+#endif
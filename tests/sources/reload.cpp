@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <helpers/cli.hpp>
+#include <helpers/files.hpp>
+
+TEST_CASE("reloading configuration", "[argon][sources][reload]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto threads_handle = cmd.add_flag(
+        argon::Flag<int>("--threads").with_value_validator([](const int x) { return x > 0; }, "must be positive"));
+    const auto name_handle = cmd.add_flag(argon::Flag<std::string>("--name"));
+    cmd.constraints.require(argon::present(threads_handle), "--threads is required");
+    argon::Cli cli{cmd};
+    const auto path = dir.write("app.ini", "threads = 2\n");
+    cli.enable_config_file(path);
+
+    argon::ReloadableCli reloadable{std::move(cli)};
+    CHECK(reloadable.current() == nullptr);
+    CHECK_THROWS_AS((void) reloadable.reload(), std::logic_error);
+
+    const Argv argv{"--name", "worker"};
+    REQUIRE(reloadable.run(argv.argc(), argv.argv().data()).has_value());
+    const auto first = reloadable.current();
+    REQUIRE(first != nullptr);
+    const auto first_results = REQUIRE_ROOT_CMD(*first);
+    CHECK_SINGLE_RESULT(first_results, threads_handle, 2);
+
+    SECTION("changed values are published") {
+        dir.write("app.ini", "threads = 4\n");
+        const auto diff = reloadable.reload();
+        REQUIRE(diff.has_value());
+        CHECK(diff->is_changed(threads_handle));
+        CHECK_FALSE(diff->is_changed(name_handle));
+        CHECK_FALSE(diff->command_changed());
+
+        const auto results = REQUIRE_ROOT_CMD(*reloadable.current());
+        CHECK_SINGLE_RESULT(results, threads_handle, 4);
+        CHECK_SINGLE_RESULT(results, name_handle, std::string("worker"));
+        CHECK_SINGLE_RESULT(first_results, threads_handle, 2);
+    }
+
+    SECTION("values overridden by the command line do not change") {
+        dir.write("app.ini", "threads = 2\nname = other\n");
+        const auto diff = reloadable.reload();
+        REQUIRE(diff.has_value());
+        CHECK(diff->empty());
+    }
+
+    SECTION("nothing changed") {
+        const auto diff = reloadable.reload();
+        REQUIRE(diff.has_value());
+        CHECK(diff->empty());
+        CHECK(reloadable.current() != first);
+    }
+
+    SECTION("invalid values keep the current results") {
+        dir.write("app.ini", "threads = -1\n");
+        const auto diff = reloadable.reload();
+        REQUIRE_FALSE(diff.has_value());
+        REQUIRE(diff.error().messages.size() == 1);
+        CHECK_THAT(diff.error().messages[0], Catch::Matchers::ContainsSubstring("must be positive"));
+        CHECK(reloadable.current() == first);
+    }
+
+    SECTION("constraints are checked") {
+        dir.write("app.ini", "\n");
+        const auto diff = reloadable.reload();
+        REQUIRE_FALSE(diff.has_value());
+        REQUIRE(diff.error().messages.size() == 1);
+        CHECK(diff.error().messages[0].message() == "--threads is required");
+        CHECK(reloadable.current() == first);
+    }
+
+    SECTION("readers see complete results while reloading") {
+        std::atomic<bool> done = false;
+        std::atomic<bool> inconsistent = false;
+        std::jthread reader([&] {
+            while (!done) {
+                const auto current = reloadable.current();
+                const auto results = current->try_get_results(current->get_root_handle());
+                const auto threads = results->get(threads_handle);
+                if (!threads.has_value() || *threads < 2 || *threads > 9) inconsistent = true;
+            }
+        });
+        for (int i = 3; i < 10; i++) {
+            dir.write("app.ini", std::format("threads = {}\n", i));
+            REQUIRE(reloadable.reload().has_value());
+        }
+        done = true;
+        reader.join();
+        CHECK_FALSE(inconsistent);
+        CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(*reloadable.current()), threads_handle, 9);
+    }
+}
+
+TEST_CASE("reloading lazily converted and streamed options", "[argon][sources][reload]") {
+    const TempDir dir;
+    const auto conversions = std::make_shared<int>(0);
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto port_handle = cmd.add_flag(argon::Flag<int>("--port")
+        .with_conversion_fn([conversions](const std::string_view arg) -> std::optional<int> {
+            ++*conversions;
+            if (arg.empty() || !std::ranges::all_of(arg, [](const char c) { return std::isdigit(c); })) {
+                return std::nullopt;
+            }
+            return std::stoi(std::string(arg));
+        }, "expected a port")
+        .with_lazy_conversion());
+    const auto files_handle = cmd.add_multi_positional(argon::MultiPositional<std::string>("files").with_streaming());
+    argon::Cli cli{cmd};
+    const auto path = dir.write("app.ini", "port = 80\n");
+    cli.enable_config_file(path);
+
+    argon::ReloadableCli reloadable{std::move(cli)};
+    const Argv argv{"a", "b"};
+    REQUIRE(reloadable.run(argv.argc(), argv.argv().data()).has_value());
+
+    SECTION("lazily converted values are converted before they are published") {
+        CHECK(*conversions == 1);
+        CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(*reloadable.current()), port_handle, 80);
+        CHECK(*conversions == 1);
+
+        dir.write("app.ini", "port = 8080\n");
+        const auto diff = reloadable.reload();
+        REQUIRE(diff.has_value());
+        CHECK(diff->is_changed(port_handle));
+        CHECK(*conversions == 2);
+        CHECK_SINGLE_RESULT(REQUIRE_ROOT_CMD(*reloadable.current()), port_handle, 8080);
+    }
+
+    SECTION("invalid lazily converted values keep the current results") {
+        const auto first = reloadable.current();
+        dir.write("app.ini", "port = eighty\n");
+        const auto diff = reloadable.reload();
+        REQUIRE_FALSE(diff.has_value());
+        REQUIRE(diff.error().messages.size() == 1);
+        CHECK(diff.error().messages[0].code() == argon::ErrorCode::InvalidValue);
+        CHECK(reloadable.current() == first);
+    }
+
+    SECTION("streamed multi-positionals are not compared") {
+        const auto diff = reloadable.reload();
+        REQUIRE(diff.has_value());
+        CHECK(diff->empty());
+        CHECK_FALSE(diff->is_changed(files_handle));
+    }
+}
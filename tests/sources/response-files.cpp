@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <fstream>
+
+#include <helpers/cli.hpp>
+#include <helpers/files.hpp>
+
+TEST_CASE("newline response files", "[argon][sources][response-files]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto count_handle = cmd.add_flag(argon::Flag<int>("--count"));
+    const auto files_handle = cmd.add_multi_positional(argon::MultiPositional<std::string_view>("files"));
+    argon::Cli cli{cmd};
+    cli.enable_response_files();
+
+    SECTION("arguments are expanded in place") {
+        const auto path = dir.write("args.txt", "--count\r\n5\n\na.txt\nwith spaces.txt\n");
+        const Argv argv{"first.txt", std::format("@{}", path.string()), "last.txt"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, count_handle, 5);
+        CHECK_MULTI_RESULT(results, files_handle,
+            std::vector<std::string_view>{"first.txt", "a.txt", "with spaces.txt", "last.txt"});
+    }
+
+    SECTION("nested response files are relative to the including file") {
+        dir.write("inner.txt", "b.txt\n");
+        const auto path = dir.write("outer.txt", "a.txt\n@inner.txt\nc.txt\n");
+        const Argv argv{std::format("@{}", path.string())};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, files_handle, std::vector<std::string_view>{"a.txt", "b.txt", "c.txt"});
+    }
+
+    SECTION("arguments after -- are not expanded") {
+        const Argv argv{"--", "@literal"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, files_handle, std::vector<std::string_view>{"@literal"});
+    }
+
+    SECTION("cycles are reported") {
+        dir.write("a.txt", "@b.txt\n");
+        dir.write("b.txt", "@a.txt\n");
+        const Argv argv{std::format("@{}", (dir.path / "a.txt").string())};
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("includes itself"));
+    }
+
+    SECTION("missing files are reported") {
+        const Argv argv{std::format("@{}", (dir.path / "missing.txt").string())};
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unable to read response file"));
+    }
+}
+
+TEST_CASE("response file configuration", "[argon][sources][response-files]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto files_handle = cmd.add_multi_positional(argon::MultiPositional<std::string>("files"));
+    argon::Cli cli{cmd};
+
+    SECTION("disabled by default") {
+        const Argv argv{"@file"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, files_handle, std::vector<std::string>{"@file"});
+    }
+
+    SECTION("NUL separated") {
+        cli.enable_response_files({.format = argon::ResponseFileFormat::Null});
+        const auto path = dir.write("args.bin", std::string("a\nb\0c\0\0", 7));
+        const Argv argv{std::format("@{}", path.string())};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_MULTI_RESULT(results, files_handle, std::vector<std::string>{"a\nb", "c"});
+    }
+
+    SECTION("depth limit") {
+        cli.enable_response_files({.maxDepth = 2});
+        dir.write("3.txt", "deep\n");
+        dir.write("2.txt", "@3.txt\n");
+        const auto path = dir.write("1.txt", "@2.txt\n");
+        const Argv argv{std::format("@{}", path.string())};
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, argv);
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("maximum nesting depth of 2"));
+    }
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <unistd.h>
+
+#include <helpers/cli.hpp>
+
+enum class SnapshotLevel { Low, High };
+
+namespace {
+    struct Options {
+        argon::Command<> cmd{"cmd", "desc"};
+        argon::FlagHandle<argon::RootCommandTag, int> count = cmd.add_flag(argon::Flag<int>("--count").with_default(1));
+        argon::FlagHandle<argon::RootCommandTag, double> ratio = cmd.add_flag(argon::Flag<double>("--ratio"));
+        argon::FlagHandle<argon::RootCommandTag, std::string_view> name = cmd.add_flag(argon::Flag<std::string_view>("--name"));
+        argon::MultiFlagHandle<argon::RootCommandTag, bool> switches = cmd.add_multi_flag(argon::MultiFlag<bool>("--switches"));
+        argon::ChoiceHandle<argon::RootCommandTag, SnapshotLevel> level = cmd.add_choice(
+            argon::Choice<SnapshotLevel>("--level", {{"low", SnapshotLevel::Low}, {"high", SnapshotLevel::High}}));
+        argon::MultiChoiceHandle<argon::RootCommandTag, int> sizes = cmd.add_multi_choice(
+            argon::MultiChoice<int>("--sizes", {{"s", 1}, {"m", 2}, {"l", 3}}));
+        argon::PositionalHandle<argon::RootCommandTag, std::filesystem::path> input = cmd.add_positional(
+            argon::Positional<std::filesystem::path>("input"));
+        argon::MultiPositionalHandle<argon::RootCommandTag, std::string> rest = cmd.add_multi_positional(
+            argon::MultiPositional<std::string>("rest"));
+        argon::FlagHandle<argon::RootCommandTag, int> unset = cmd.add_flag(argon::Flag<int>("--unset").with_default(7));
+    };
+}
+
+TEST_CASE("snapshot round trip", "[argon][sources][snapshots]") {
+    Options parent;
+    argon::Cli parentCli{parent.cmd};
+    const Argv argv{"--count", "5", "--ratio", "0.5", "--name", "worker", "--switches", "true", "false",
+                    "--level", "high", "--sizes", "l", "s", "--", "in.txt", "a", "b"};
+    REQUIRE_RUN_CLI(parentCli, argv);
+    const auto snapshot = parentCli.write_snapshot();
+    REQUIRE(snapshot.has_value());
+
+    Options child;
+    argon::Cli childCli{child.cmd};
+    const auto check_loaded = [&] {
+        const auto results = REQUIRE_ROOT_CMD(childCli);
+        CHECK_SINGLE_RESULT(results, child.count, 5);
+        CHECK_SINGLE_RESULT(results, child.ratio, 0.5);
+        CHECK_SINGLE_RESULT(results, child.name, std::string_view("worker"));
+        CHECK_MULTI_RESULT(results, child.switches, std::vector{true, false});
+        CHECK_SINGLE_RESULT(results, child.level, SnapshotLevel::High);
+        CHECK_MULTI_RESULT(results, child.sizes, std::vector{3, 1});
+        CHECK_SINGLE_RESULT(results, child.input, std::filesystem::path("in.txt"));
+        CHECK_MULTI_RESULT(results, child.rest, std::vector<std::string>{"a", "b"});
+        CHECK_SINGLE_RESULT(results, child.unset, 7);
+        CHECK_FALSE(results.is_specified(child.unset));
+        CHECK(results.get_source(child.count) == argon::ValueSource::CommandLine);
+        CHECK(results.get_source(child.unset) == argon::ValueSource::Default);
+        return results;
+    };
+
+    SECTION("from a buffer") {
+        REQUIRE(childCli.load_snapshot(snapshot.value()).has_value());
+        const auto results = check_loaded();
+
+        const std::string_view name = results.get(child.name).value();
+        CHECK(name.data() >= snapshot->data());
+        CHECK(name.data() + name.size() <= snapshot->data() + snapshot->size());
+    }
+
+    SECTION("through a file descriptor") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        REQUIRE(parentCli.write_snapshot(fds[1]).has_value());
+        close(fds[1]);
+        const auto loaded = childCli.load_snapshot(fds[0]);
+        close(fds[0]);
+        REQUIRE(loaded.has_value());
+        check_loaded();
+    }
+}
+
+TEST_CASE("snapshot of a subcommand", "[argon][sources][snapshots]") {
+    const auto make_cli = [] {
+        CREATE_DEFAULT_ROOT(cmd);
+        argon::Command<struct Remote> remote{"remote", ""};
+        argon::Command<struct Add> add{"add", ""};
+        [[maybe_unused]] const auto url = add.add_flag(argon::Flag<std::string>("--url"));
+        [[maybe_unused]] const auto remote_add = remote.add_subcommand(std::move(add));
+        [[maybe_unused]] const auto remote_handle = cmd.add_subcommand(std::move(remote));
+        return cmd;
+    };
+
+    argon::Command parent = make_cli();
+    argon::Cli parentCli{std::move(parent)};
+    const Argv argv{"remote", "add", "--url", "https://example.com"};
+    REQUIRE_RUN_CLI(parentCli, argv);
+    const auto snapshot = parentCli.write_snapshot();
+    REQUIRE(snapshot.has_value());
+
+    argon::Command<> child{"cmd", "desc"};
+    argon::Command<struct Remote> remote{"remote", ""};
+    argon::Command<struct Add> add{"add", ""};
+    const auto url = add.add_flag(argon::Flag<std::string>("--url"));
+    const auto remote_add = remote.add_subcommand(std::move(add));
+    [[maybe_unused]] const auto remote_handle = child.add_subcommand(std::move(remote));
+    argon::Cli childCli{child};
+
+    REQUIRE(childCli.load_snapshot(snapshot.value()).has_value());
+    CHECK_FALSE(childCli.try_get_results(childCli.get_root_handle()).has_value());
+    const auto results = REQUIRE_COMMAND(childCli, remote_add);
+    CHECK_SINGLE_RESULT(results, url, std::string("https://example.com"));
+}
+
+TEST_CASE("snapshot errors", "[argon][sources][snapshots]") {
+    SECTION("custom types cannot be written") {
+        struct Point {
+            int x;
+        };
+        CREATE_DEFAULT_ROOT(cmd);
+        [[maybe_unused]] const auto handle = cmd.add_flag(
+            argon::Flag<Point>("--point")
+                .with_conversion_fn([](const std::string_view) -> std::optional<Point> { return Point{1}; }, "")
+        );
+        argon::Cli cli{cmd};
+        const Argv argv{"--point", "1"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto snapshot = cli.write_snapshot();
+        REQUIRE_FALSE(snapshot.has_value());
+        CHECK_THAT(snapshot.error(), Catch::Matchers::ContainsSubstring("only builtin types are supported"));
+    }
+
+    SECTION("requires a successful run") {
+        CREATE_DEFAULT_ROOT(cmd);
+        const argon::Cli cli{cmd};
+        const auto snapshot = cli.write_snapshot();
+        REQUIRE_FALSE(snapshot.has_value());
+        CHECK(snapshot.error() == "A snapshot can only be written after a successful run");
+    }
+
+    SECTION("invalid values") {
+        const auto make_cmd = [] {
+            CREATE_DEFAULT_ROOT(cmd);
+            [[maybe_unused]] const auto switches = cmd.add_multi_flag(argon::MultiFlag<bool>("--switches"));
+            [[maybe_unused]] const auto level = cmd.add_choice(
+                argon::Choice<SnapshotLevel>("--level", {{"low", SnapshotLevel::Low}, {"high", SnapshotLevel::High}}));
+            return cmd;
+        };
+        argon::Cli cli{make_cmd()};
+        const Argv argv{"--level", "high", "--switches", "true"};
+        REQUIRE_RUN_CLI(cli, argv);
+        const auto snapshot = cli.write_snapshot();
+        REQUIRE(snapshot.has_value());
+
+        // Each option is written with its name right before its values
+        const auto corrupt = [&](const std::string_view name, const size_t offset, const char byte) {
+            std::string corrupted = snapshot.value();
+            corrupted[corrupted.find(name) + name.size() + sizeof(argon::ValueSource) + sizeof(uint32_t) + offset] = byte;
+            return corrupted;
+        };
+        argon::Cli childCli{make_cmd()};
+        REQUIRE(childCli.load_snapshot(corrupt("--switches", 0, 1)).has_value());
+
+        const auto invalidBool = corrupt("--switches", 0, 2);
+        const auto loadedBool = childCli.load_snapshot(invalidBool);
+        REQUIRE_FALSE(loadedBool.has_value());
+        CHECK(loadedBool.error() == "Snapshot is truncated or malformed");
+
+        const auto invalidEnum = corrupt("--level", 0, 5);
+        const auto loadedEnum = childCli.load_snapshot(invalidEnum);
+        REQUIRE_FALSE(loadedEnum.has_value());
+        CHECK(loadedEnum.error() == "Snapshot is truncated or malformed");
+    }
+
+    Options parent;
+    argon::Cli parentCli{parent.cmd};
+    const Argv argv{"--count", "5"};
+    REQUIRE_RUN_CLI(parentCli, argv);
+    const auto snapshot = parentCli.write_snapshot();
+    REQUIRE(snapshot.has_value());
+
+    SECTION("truncated") {
+        Options child;
+        argon::Cli childCli{child.cmd};
+        for (size_t size = 0; size < snapshot->size(); size++) {
+            const auto loaded = childCli.load_snapshot(std::string_view(snapshot.value()).substr(0, size));
+            REQUIRE_FALSE(loaded.has_value());
+            CHECK(loaded.error() == "Snapshot is truncated or malformed");
+        }
+        CHECK_FALSE(childCli.try_get_results(childCli.get_root_handle()).has_value());
+    }
+
+    SECTION("different options") {
+        CREATE_DEFAULT_ROOT(cmd);
+        [[maybe_unused]] const auto handle = cmd.add_flag(argon::Flag<int>("--count"));
+        argon::Cli childCli{cmd};
+        const auto loaded = childCli.load_snapshot(snapshot.value());
+        REQUIRE_FALSE(loaded.has_value());
+        CHECK(loaded.error() == "Option '--ratio' in the snapshot does not exist");
+    }
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <thread>
+
+#include <helpers/cli.hpp>
+
+TEST_CASE("lazy subcommands", "[argon][subcommands][lazy]") {
+    CREATE_DEFAULT_ROOT(root);
+    const auto root_flag = root.add_flag(argon::Flag<int>("--level"));
+
+    struct DeployTag {};
+    struct TargetTag {};
+    const auto builds = std::make_shared<int>(0);
+    const auto nestedBuilds = std::make_shared<int>(0);
+    const auto count_handle = std::make_shared<std::optional<argon::FlagHandle<DeployTag, int>>>();
+    const auto target_handle = std::make_shared<std::optional<argon::CommandHandle<TargetTag>>>();
+    const auto url_handle = std::make_shared<std::optional<argon::FlagHandle<TargetTag, std::string>>>();
+
+    const auto deploy_handle = root.add_subcommand_lazy("deploy", "Deploy a release", [=] {
+        ++*builds;
+        argon::Command<DeployTag> deploy{"deploy", "Deploy a release"};
+        *count_handle = deploy.add_flag(argon::Flag<int>("--count").with_description("Number of replicas"));
+        *target_handle = deploy.add_subcommand_lazy("target", "Deploy to a target", [=] {
+            ++*nestedBuilds;
+            argon::Command<TargetTag> target{"target", "Deploy to a target"};
+            *url_handle = target.add_flag(argon::Flag<std::string>("--url"));
+            return target;
+        });
+        return deploy;
+    });
+
+    argon::Cli cli{root};
+
+    SECTION("not built for other commands") {
+        REQUIRE_RUN_CLI(cli, {"--level", "2"});
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK_SINGLE_RESULT(results, root_flag, 2);
+        CHECK(*builds == 0);
+        CHECK_FALSE(cli.try_get_results(deploy_handle).has_value());
+    }
+
+    SECTION("built when selected") {
+        REQUIRE_RUN_CLI(cli, {"deploy", "--count", "3"});
+        CHECK(*builds == 1);
+        CHECK(*nestedBuilds == 0);
+        const auto results = REQUIRE_COMMAND(cli, deploy_handle);
+        CHECK_SINGLE_RESULT(results, count_handle->value(), 3);
+        CHECK_FALSE(cli.try_get_results(cli.get_root_handle()).has_value());
+
+        REQUIRE_RUN_CLI(cli, {"deploy", "--count", "4"});
+        CHECK(*builds == 1);
+        CHECK_SINGLE_RESULT(REQUIRE_COMMAND(cli, deploy_handle), count_handle->value(), 4);
+    }
+
+    SECTION("nested lazy subcommands") {
+        REQUIRE_RUN_CLI(cli, {"deploy", "target", "--url", "https://example.com"});
+        CHECK(*builds == 1);
+        CHECK(*nestedBuilds == 1);
+        const auto results = REQUIRE_COMMAND(cli, target_handle->value());
+        CHECK_SINGLE_RESULT(results, url_handle->value(), std::string("https://example.com"));
+    }
+
+    SECTION("copies share one build") {
+        argon::Cli other{root};
+        REQUIRE_RUN_CLI(cli, {"deploy", "--count", "1"});
+        REQUIRE_RUN_CLI(other, {"deploy", "--count", "2"});
+        CHECK(*builds == 1);
+        CHECK_SINGLE_RESULT(REQUIRE_COMMAND(cli, deploy_handle), count_handle->value(), 1);
+        CHECK_SINGLE_RESULT(REQUIRE_COMMAND(other, deploy_handle), count_handle->value(), 2);
+    }
+
+    SECTION("help") {
+        const std::string rootHelp = cli.get_help_message(cli.get_root_handle());
+        CHECK_THAT(rootHelp, Catch::Matchers::ContainsSubstring("deploy"));
+        CHECK_THAT(rootHelp, Catch::Matchers::ContainsSubstring("Deploy a release"));
+        CHECK(*builds == 0);
+
+        const std::string deployHelp = cli.get_help_message(deploy_handle);
+        CHECK_THAT(deployHelp, Catch::Matchers::ContainsSubstring("Number of replicas"));
+        CHECK_THAT(deployHelp, Catch::Matchers::ContainsSubstring("Deploy to a target"));
+        CHECK(*builds == 1);
+        CHECK(*nestedBuilds == 0);
+    }
+
+    SECTION("const lookups from several threads") {
+        const argon::Cli& shared = cli;
+        std::vector<std::string> helps(4);
+        std::vector<size_t> describedSubcommands(4);
+        {
+            std::vector<std::jthread> threads;
+            for (size_t i = 0; i < helps.size(); i++) {
+                threads.emplace_back([&, i] {
+                    describedSubcommands[i] = shared.describe().subcommands.at(0).subcommands.size();
+                    helps[i] = shared.get_help_message(deploy_handle);
+                });
+            }
+        }
+        CHECK(*builds == 1);
+        CHECK(*nestedBuilds == 1);
+        for (size_t i = 0; i < helps.size(); i++) {
+            CHECK(describedSubcommands[i] == 1);
+            CHECK_THAT(helps[i], Catch::Matchers::ContainsSubstring("Number of replicas"));
+        }
+    }
+
+    SECTION("snapshots") {
+        REQUIRE_RUN_CLI(cli, {"deploy", "--count", "5"});
+        const auto snapshot = cli.write_snapshot();
+        REQUIRE(snapshot.has_value());
+
+        argon::Cli restored{root};
+        REQUIRE(restored.load_snapshot(snapshot.value()).has_value());
+        CHECK_SINGLE_RESULT(REQUIRE_COMMAND(restored, deploy_handle), count_handle->value(), 5);
+    }
+
+    SECTION("unknown subcommands suggest lazy ones") {
+        const auto [_, messages] = REQUIRE_ERROR_ON_RUN(cli, {"deplyo"});
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("deploy"));
+        CHECK(*builds == 0);
+    }
+}
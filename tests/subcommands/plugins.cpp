@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <dlfcn.h>
+
+#include <helpers/cli.hpp>
+#include <helpers/files.hpp>
+
+namespace {
+    // Looks up a symbol of a plugin without loading it, so a null result means the plugin was never loaded
+    template <typename Fn>
+    auto find_loaded_symbol(const char *library, const char *name) -> Fn {
+        void *handle = dlopen(library, RTLD_NOW | RTLD_NOLOAD);
+        if (handle == nullptr) return nullptr;
+        const auto symbol = reinterpret_cast<Fn>(dlsym(handle, name));
+        dlclose(handle);
+        return symbol;
+    }
+
+    auto greet_builds() -> int {
+        const auto builds = find_loaded_symbol<int (*)()>(ARGON_TEST_GREET_PLUGIN, "argon_test_greet_builds");
+        return builds == nullptr ? 0 : builds();
+    }
+
+    auto remote_builds() -> int {
+        const auto builds = find_loaded_symbol<int (*)()>(ARGON_TEST_REMOTE_PLUGIN, "argon_test_remote_builds");
+        return builds == nullptr ? 0 : builds();
+    }
+}
+
+TEST_CASE("plugin subcommands", "[argon][subcommands][plugins]") {
+    CREATE_DEFAULT_ROOT(root);
+    const auto verbose_handle = root.add_flag(argon::Flag<bool>("--verbose").with_implicit(true));
+    const auto greet_handle = root.add_plugin_subcommand("greet", "Prints a greeting", ARGON_TEST_GREET_PLUGIN);
+    const auto remote_handle = root.add_plugin_subcommand("remote", "Manages remotes", ARGON_TEST_REMOTE_PLUGIN);
+    argon::Cli cli{root};
+
+    const int greetBuilds = greet_builds();
+    const int remoteBuilds = remote_builds();
+
+    SECTION("plugins are not loaded for other commands") {
+        REQUIRE_RUN_CLI(cli, {"--verbose"});
+        const auto results = REQUIRE_ROOT_CMD(cli);
+        CHECK(results.get(verbose_handle));
+        CHECK(greet_builds() == greetBuilds);
+        CHECK(remote_builds() == remoteBuilds);
+    }
+
+    SECTION("a plugin is built when it is selected") {
+        REQUIRE_RUN_CLI(cli, {"greet", "--name", "argon", "--times", "3"});
+        CHECK(greet_builds() == greetBuilds + 1);
+        CHECK(remote_builds() == remoteBuilds);
+
+        const auto results = find_loaded_symbol<bool (*)(const argon::Cli&, std::string&, int&)>(
+            ARGON_TEST_GREET_PLUGIN, "argon_test_greet_results");
+        REQUIRE(results != nullptr);
+        std::string name;
+        int times = 0;
+        REQUIRE(results(cli, name, times));
+        CHECK(name == "argon");
+        CHECK(times == 3);
+
+        REQUIRE_RUN_CLI(cli, {"greet"});
+        CHECK(greet_builds() == greetBuilds + 1);
+        REQUIRE(results(cli, name, times));
+        CHECK(name == "world");
+        CHECK(times == 1);
+    }
+
+    SECTION("nested subcommands of a plugin") {
+        REQUIRE_RUN_CLI(cli, {"remote", "add", "--url", "https://example.com"});
+        CHECK(remote_builds() == remoteBuilds + 1);
+
+        const auto url = find_loaded_symbol<bool (*)(const argon::Cli&, std::string&)>(
+            ARGON_TEST_REMOTE_PLUGIN, "argon_test_remote_add_url");
+        REQUIRE(url != nullptr);
+        std::string result;
+        REQUIRE(url(cli, result));
+        CHECK(result == "https://example.com");
+
+        const auto [handle, messages] = REQUIRE_ERROR_ON_RUN(cli, {"remote", "invalid"});
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unknown subcommand 'invalid'"));
+    }
+
+    SECTION("copies of a definition share one build") {
+        argon::Cli other{root};
+        REQUIRE_RUN_CLI(cli, {"greet"});
+        REQUIRE_RUN_CLI(other, {"greet", "--name", "copy"});
+        CHECK(greet_builds() == greetBuilds + 1);
+
+        const auto results = find_loaded_symbol<bool (*)(const argon::Cli&, std::string&, int&)>(
+            ARGON_TEST_GREET_PLUGIN, "argon_test_greet_results");
+        REQUIRE(results != nullptr);
+        std::string name;
+        int times = 0;
+        REQUIRE(results(other, name, times));
+        CHECK(name == "copy");
+    }
+
+    SECTION("help") {
+        const std::string rootHelp = cli.get_help_message(cli.get_root_handle());
+        CHECK_THAT(rootHelp, Catch::Matchers::ContainsSubstring("greet"));
+        CHECK_THAT(rootHelp, Catch::Matchers::ContainsSubstring("Prints a greeting"));
+        CHECK_THAT(rootHelp, Catch::Matchers::ContainsSubstring("Manages remotes"));
+        CHECK(greet_builds() == greetBuilds);
+
+        const std::string greetHelp = cli.get_help_message(greet_handle);
+        CHECK_THAT(greetHelp, Catch::Matchers::ContainsSubstring("--name"));
+        CHECK_THAT(greetHelp, Catch::Matchers::ContainsSubstring("Who to greet"));
+        CHECK(greet_builds() == greetBuilds + 1);
+        CHECK(remote_builds() == remoteBuilds);
+
+        const std::string remoteHelp = cli.get_help_message(remote_handle);
+        CHECK_THAT(remoteHelp, Catch::Matchers::ContainsSubstring("add"));
+    }
+}
+
+TEST_CASE("plugin loading errors", "[argon][subcommands][plugins]") {
+    const TempDir dir;
+    CREATE_DEFAULT_ROOT(root);
+    const auto missing_handle = root.add_plugin_subcommand("missing", "", dir.path / "missing.so");
+    argon::Cli cli{root};
+
+    SECTION("running") {
+        const auto [handle, messages] = REQUIRE_ERROR_ON_RUN(cli, {"missing"});
+        CHECK(handle.get_id() == missing_handle.get_id());
+        REQUIRE(messages.size() == 1);
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("Unable to load plugin"));
+        CHECK_THAT(messages[0], Catch::Matchers::ContainsSubstring("missing.so"));
+    }
+
+    SECTION("help") {
+        CHECK_THROWS_AS(cli.get_help_message(missing_handle), std::runtime_error);
+    }
+}
@@ -188,6 +188,30 @@ TEST_CASE(
     CHECK_SINGLE_RESULT(results, path_handle, std::filesystem::path(input));
 }
 
+TEST_CASE(
+    "std::string_view parsing - borrows argv",
+    "[argon][types][built-in][std::string_view]"
+) {
+    CREATE_DEFAULT_ROOT(cmd);
+    const auto flag_handle = cmd.add_flag(argon::Flag<std::string_view>("--str"));
+    const auto lazy_handle = cmd.add_flag(argon::Flag<std::string_view>("--lazy").with_lazy_conversion());
+    const auto multi_handle = cmd.add_multi_positional(argon::MultiPositional<std::string_view>("values"));
+    argon::Cli cli{cmd};
+
+    const Argv argv{"--str", "hello world", "--lazy", "lazy", "a", "b"};
+    INFO(argv.get_repr());
+    REQUIRE_RUN_CLI(cli, argv);
+
+    const auto results = REQUIRE_ROOT_CMD(cli);
+    CHECK_SINGLE_RESULT(results, flag_handle, std::string_view("hello world"));
+    CHECK_SINGLE_RESULT(results, lazy_handle, std::string_view("lazy"));
+    CHECK_MULTI_RESULT(results, multi_handle, std::vector<std::string_view>{"a", "b"});
+
+    CHECK(results.get(flag_handle)->data() == argv.storage[2].data());
+    CHECK(results.get(lazy_handle)->data() == argv.storage[4].data());
+    CHECK(results.get(multi_handle)[1].data() == argv.storage[6].data());
+}
+
 TEST_CASE(
     "string parsing - looks like other types",
     "[argon][types][built-in][std::string]"